@@ -31,6 +31,26 @@
 
 class StorageSeed;
 
+
+
+/**
+ * @brief The QuestionTemplate class
+ *
+ * Az objective és a storage adataiból egyszer előkészített (lefordított) kérdéssablon,
+ * amiből a kérdések a storage újrafeldolgozása nélkül gyárthatók
+ */
+
+class QuestionTemplate
+{
+public:
+	virtual ~QuestionTemplate() = default;
+
+	// Kérdés(ek) elkészítése (seed esetén csak egyet)
+	virtual QVariantList generate(StorageSeed *seed) const = 0;
+};
+
+
+
 class ModuleInterface
 {
 public:
@@ -79,6 +99,12 @@ public:
 	virtual QVariantList generateAll(const QVariantMap &data, ModuleInterface *storage, const QVariantMap &storageData,
 									 QVariantMap *commonDataPtr, StorageSeed *seed) const = 0;
 
+	// Kérdéssablon előkészítése (nullptr: nincs, a generateAll() használandó)
+	virtual QuestionTemplate *compile(const QVariantMap &/*data*/, ModuleInterface */*storage*/,
+									  const QVariantMap &/*storageData*/, QVariantMap */*commonDataPtr*/) const {
+		return nullptr;
+	}
+
 	// XP faktor
 	virtual qreal xpFactor() const = 0;
 
@@ -25,6 +25,8 @@
  */
 
 #include "modulemergeblock.h"
+#include "storageseed.h"
+#include <QRandomGenerator>
 
 ModuleMergeblock::ModuleMergeblock(QObject *parent) : QObject(parent)
 {
@@ -141,3 +143,124 @@ ModuleMergeblock::BlockUnion ModuleMergeblock::getUnion(const QVariantList &sect
 
 	return ret;
 }
+
+
+
+/**
+ * @brief ModuleMergeblock::Index::Index
+ * @param blocks
+ */
+
+ModuleMergeblock::Index::Index(const BlockUnion &blocks)
+{
+	QHash<QString, int> wordIds;
+
+	for (const auto &[left, list] : blocks.asKeyValueRange()) {
+		if (left.isEmpty() || list.empty())
+			continue;
+
+		const int leftId = m_lefts.size();
+		m_lefts.append(left);
+
+		for (const Data &d : list) {
+			const int blockId = m_blocks.size();
+
+			Block block;
+			block.left = leftId;
+			block.blockidx = d.blockidx;
+			block.content.reserve(d.content.size());
+
+			for (int i=0; i<d.content.size(); ++i) {
+				const QString &s = d.content.at(i);
+
+				int id = wordIds.value(s, -1);
+
+				if (id < 0) {
+					id = m_words.size();
+					wordIds.insert(s, id);
+					m_words.append(s);
+				}
+
+				block.content.push_back(id);
+				m_entries.push_back(Entry{.word = id, .block = blockId, .sub = d.blockidx + i+1});
+			}
+
+			m_blocks.push_back(std::move(block));
+		}
+	}
+}
+
+
+
+/**
+ * @brief ModuleMergeblock::Index::words
+ * @param block
+ * @return
+ */
+
+QStringList ModuleMergeblock::Index::words(const Block &block) const
+{
+	QStringList list;
+	list.reserve(block.content.size());
+
+	for (const int &id : block.content)
+		list.append(m_words.at(id));
+
+	return list;
+}
+
+
+
+/**
+ * @brief ModuleMergeblock::Index::sampleLefts
+ * @param count
+ * @param exceptLeft
+ * @return
+ *
+ * Véletlen bal oldalak (az exceptLeft kivételével)
+ */
+
+QStringList ModuleMergeblock::Index::sampleLefts(const int &count, const int &exceptLeft) const
+{
+	const std::vector<int> &ids = SeedSampler::sample(m_lefts.size(), count, [&exceptLeft](const int &id) {
+		return id != exceptLeft;
+	});
+
+	QStringList list;
+	list.reserve(ids.size());
+
+	for (const int &id : ids)
+		list.append(m_lefts.at(id));
+
+	return list;
+}
+
+
+
+/**
+ * @brief ModuleMergeblock::Index::sampleBlockWords
+ * @param count
+ * @param exceptBlock
+ * @return
+ *
+ * Véletlen blokkok (az exceptBlock kivételével), mindegyikből egy véletlen szó
+ */
+
+QStringList ModuleMergeblock::Index::sampleBlockWords(const int &count, const int &exceptBlock) const
+{
+	const std::vector<int> &ids = SeedSampler::sample(m_blocks.size(), count, [this, &exceptBlock](const int &id) {
+		return id != exceptBlock && !m_blocks.at(id).content.empty();
+	});
+
+	QRandomGenerator *g = QRandomGenerator::global();
+
+	QStringList list;
+	list.reserve(ids.size());
+
+	for (const int &id : ids) {
+		const std::vector<int> &content = m_blocks.at(id).content;
+		list.append(m_words.at(content.at(g->bounded((int) content.size()))));
+	}
+
+	return list;
+}
@@ -30,6 +30,7 @@
 #include "../interfaces.h"
 #include <QObject>
 #include <QtPlugin>
+#include <vector>
 
 
 class ModuleMergeblock : public QObject, public ModuleInterface
@@ -76,6 +77,48 @@ public:
 	static BlockUnion getUnion(const QVariantList &sections, const QStringList &usedSections);
 	static BlockUnion getUnion(const QVariantList &blocks);
 
+
+	/**
+	 * @brief The Index class
+	 *
+	 * Számokra (azonosítókra) fordított BlockUnion a gyors feladatgeneráláshoz:
+	 * a szövegeket egyszer tároljuk, a generátorok csak azonosítókkal dolgoznak
+	 */
+
+	class Index {
+	public:
+		struct Block {
+			int left = -1;					// a bal oldal azonosítója
+			int blockidx = 0;
+			std::vector<int> content;		// a jobb oldali szavak azonosítói (eredeti sorrendben)
+		};
+
+		struct Entry {
+			int word = -1;
+			int block = -1;					// a blokk sorszáma (blocks())
+			int sub = 0;					// seed: blockidx + (szó indexe + 1)
+		};
+
+		Index() = default;
+		explicit Index(const BlockUnion &blocks);
+
+		const QString &word(const int &id) const { return m_words.at(id); }
+		const QString &left(const int &id) const { return m_lefts.at(id); }
+
+		const std::vector<Block> &blocks() const { return m_blocks; }
+		const std::vector<Entry> &entries() const { return m_entries; }
+
+		QStringList words(const Block &block) const;
+		QStringList sampleLefts(const int &count, const int &exceptLeft) const;
+		QStringList sampleBlockWords(const int &count, const int &exceptBlock) const;
+
+	private:
+		QStringList m_words;
+		QStringList m_lefts;
+		std::vector<Block> m_blocks;
+		std::vector<Entry> m_entries;
+	};
+
 signals:
 
 };
@@ -31,6 +31,447 @@
 #include "../binding/modulebinding.h"
 #include "question.h"
 
+
+
+
+
+/**
+ * @brief optionCount
+ * @param maxOptions
+ * @return
+ *
+ * A válaszlehetőségek száma (a helyes válasszal együtt)
+ */
+
+static int optionCount(const int &maxOptions)
+{
+	return maxOptions > 1 ? maxOptions : 4;
+}
+
+
+
+/**
+ * @brief The SimplechoiceTemplate class
+ *
+ * Lefordított binding és block storage: a storage-ot egyszer dolgozzuk fel, a kérdések
+ * közül a SeedSampler választ, és csak a kiválasztott kérdést gyártjuk le
+ */
+
+class SimplechoiceTemplate : public QuestionTemplate
+{
+public:
+	SimplechoiceTemplate(const ModuleSimplechoice *module, const QVariantMap &data,
+						 const QList<ModuleSimplechoice::Binding> &bindings);
+
+	SimplechoiceTemplate(const ModuleSimplechoice *module, const QVariantMap &data,
+						 const ModuleMergeblock::BlockUnion &blocks);
+
+	QVariantList generate(StorageSeed *seed) const override;
+
+private:
+	enum Mode {
+		Invalid = 0,
+		Binding,
+		BlockSimple,
+		BlockContains,
+		BlockQuiz,
+		BlockExclude
+	};
+
+	static Mode blockMode(const QVariantMap &data);
+
+	QVariantMap get(const SeedSampler::Pick &pick, StorageSeed *seed) const;
+	QVariantMap questionMap(const QString &text) const;
+	int excludeEntry(const int &block, StorageSeed *seed) const;
+
+	QVariantMap bindingOne(const int &item) const;
+	QVariantMap blockContainsOne(const int &entry) const;
+	QVariantMap blockSimpleOne(const int &block, const int &subB) const;
+	QVariantMap blockQuizOne(const int &block) const;
+	QVariantMap blockExcludeOne(const int &block, const int &entry) const;
+
+	const ModuleSimplechoice *const m_module;
+	const QString m_question;
+	const bool m_monospace;
+	const int m_maxOptions;
+	const Mode m_mode;
+	const bool m_isBindToRight = false;
+	const QList<ModuleSimplechoice::Binding> m_bindings;
+	const ModuleMergeblock::Index m_index;
+	SeedSampler m_sampler;
+};
+
+
+
+/**
+ * @brief SimplechoiceTemplate::SimplechoiceTemplate
+ * @param module
+ * @param data
+ * @param bindings
+ */
+
+SimplechoiceTemplate::SimplechoiceTemplate(const ModuleSimplechoice *module, const QVariantMap &data,
+										   const QList<ModuleSimplechoice::Binding> &bindings)
+	: m_module(module)
+	, m_question(data.value(QStringLiteral("question")).toString())
+	, m_monospace(data.value(QStringLiteral("monospace")).toBool())
+	, m_maxOptions(data.value(QStringLiteral("maxOptions")).toInt())
+	, m_mode(Binding)
+	, m_isBindToRight(data.value(QStringLiteral("mode")).toString() == QStringLiteral("right"))
+	, m_bindings(bindings)
+	, m_sampler(m_isBindToRight ? SEED_BINDING_RIGHT : SEED_BINDING_LEFT,
+				m_isBindToRight ? SEED_BINDING_LEFT : SEED_BINDING_RIGHT)
+{
+	for (int i = 0; i<m_bindings.size(); ++i) {
+		const ModuleSimplechoice::Binding &b = m_bindings.at(i);
+
+		if (!b.left.isEmpty() && !b.right.isEmpty())
+			m_sampler.append(i, i+1, i+1);
+	}
+}
+
+
+
+/**
+ * @brief SimplechoiceTemplate::SimplechoiceTemplate
+ * @param module
+ * @param data
+ * @param blocks
+ */
+
+SimplechoiceTemplate::SimplechoiceTemplate(const ModuleSimplechoice *module, const QVariantMap &data,
+										   const ModuleMergeblock::BlockUnion &blocks)
+	: m_module(module)
+	, m_question(data.value(QStringLiteral("question")).toString())
+	, m_monospace(data.value(QStringLiteral("monospace")).toBool())
+	, m_maxOptions(data.value(QStringLiteral("maxOptions")).toInt())
+	, m_mode(blockMode(data))
+	, m_index(blocks)
+	, m_sampler(m_mode == BlockContains ? SEED_BLOCK_RIGHT : SEED_BLOCK_LEFT,
+				m_mode == BlockContains ? SEED_BLOCK_LEFT : SEED_BLOCK_RIGHT)
+{
+	if (m_mode == BlockContains) {
+		// Seed main: 2
+		// Seed sub: (block index+1) * 1000 + (answer index + 1)
+
+		const std::vector<ModuleMergeblock::Index::Entry> &entries = m_index.entries();
+
+		for (int e=0; e<(int) entries.size(); ++e) {
+			const ModuleMergeblock::Index::Entry &d = entries.at(e);
+
+			if (!m_index.word(d.word).simplified().isEmpty())
+				m_sampler.append(e, d.sub, m_index.blocks().at(d.block).blockidx);
+		}
+
+		return;
+	}
+
+	const int entryCount = m_index.entries().size();
+
+	for (int bIdx=0; bIdx<(int) m_index.blocks().size(); ++bIdx) {
+		const ModuleMergeblock::Index::Block &b = m_index.blocks().at(bIdx);
+
+		if (b.content.empty())
+			continue;
+
+		if (m_mode == BlockSimple)
+			m_sampler.append(bIdx, b.blockidx, b.blockidx+1, (int) b.content.size());
+		else if (m_mode == BlockQuiz)
+			m_sampler.append(bIdx, b.blockidx, b.blockidx+1);
+		else if (m_mode == BlockExclude && entryCount > (int) b.content.size())		// kell másik blokkból is szó
+			m_sampler.append(bIdx, b.blockidx, -1, 0);
+	}
+}
+
+
+
+/**
+ * @brief SimplechoiceTemplate::generate
+ * @param seed
+ * @return
+ */
+
+QVariantList SimplechoiceTemplate::generate(StorageSeed *seed) const
+{
+	QVariantList list;
+
+	// Valójában csak egyet adunk vissza, mert ha seed-del hívtuk meg, akkor úgyis mindig újragyártjuk és csak az elsőt használjuk fel
+
+	if (seed) {
+		if (const auto &pick = m_sampler.pick(seed)) {
+			if (const QVariantMap &m = get(*pick, seed); !m.isEmpty())
+				list.append(m);
+		}
+	} else {
+		for (const SeedSampler::Pick &pick : m_sampler.all()) {
+			if (const QVariantMap &m = get(pick, seed); !m.isEmpty())
+				list.append(m);
+		}
+	}
+
+	return list;
+}
+
+
+
+/**
+ * @brief SimplechoiceTemplate::blockMode
+ * @param data
+ * @return
+ */
+
+SimplechoiceTemplate::Mode SimplechoiceTemplate::blockMode(const QVariantMap &data)
+{
+	const QString &mode = data.value(QStringLiteral("mode")).toString();
+
+	if (mode == QStringLiteral("simple"))
+		return BlockSimple;
+	else if (mode == QStringLiteral("contains"))
+		return BlockContains;
+	else if (mode == QStringLiteral("quiz"))
+		return BlockQuiz;
+	else if (mode == QStringLiteral("exclude"))
+		return BlockExclude;
+
+	return Invalid;
+}
+
+
+
+/**
+ * @brief SimplechoiceTemplate::get
+ * @param pick
+ * @param seed
+ * @return
+ */
+
+QVariantMap SimplechoiceTemplate::get(const SeedSampler::Pick &pick, StorageSeed *seed) const
+{
+	QVariantMap m;
+	int subB = pick.subB;
+
+	switch (m_mode) {
+		case Binding:
+			m = bindingOne(pick.item);
+			break;
+
+		case BlockSimple:
+			m = blockSimpleOne(pick.item, subB);
+			break;
+
+		case BlockContains:
+			m = blockContainsOne(pick.item);
+			break;
+
+		case BlockQuiz:
+			m = blockQuizOne(pick.item);
+			break;
+
+		case BlockExclude: {
+			const int entry = excludeEntry(pick.item, seed);
+
+			if (entry < 0)
+				return {};
+
+			subB = m_index.entries().at(entry).sub;
+			m = blockExcludeOne(pick.item, entry);
+			break;
+		}
+
+		case Invalid:
+			return {};
+	}
+
+	StorageSeed::addSeedToMap(&m, m_sampler.mainA(), pick.subA, m_sampler.mainB(), subB);
+
+	return m;
+}
+
+
+
+/**
+ * @brief SimplechoiceTemplate::questionMap
+ * @param text
+ * @return
+ */
+
+QVariantMap SimplechoiceTemplate::questionMap(const QString &text) const
+{
+	QVariantMap retMap;
+
+	if (m_question.isEmpty())
+		retMap[QStringLiteral("question")] = text;
+	else if (m_question.contains(QStringLiteral("%1")))
+		retMap[QStringLiteral("question")] = m_question.arg(text);
+	else
+		retMap[QStringLiteral("question")] = m_question;
+
+	retMap[QStringLiteral("monospace")] = m_monospace;
+
+	return retMap;
+}
+
+
+
+/**
+ * @brief SimplechoiceTemplate::excludeEntry
+ * @param block
+ * @param seed
+ * @return
+ *
+ * Kakukktojás: egy másik blokk még fel nem használt szava. Ha már mindet felhasználtuk,
+ * bármelyik másik blokk szava jó, és a következő felhasználáskor töröljük a seed-et.
+ */
+
+int SimplechoiceTemplate::excludeEntry(const int &block, StorageSeed *seed) const
+{
+	const std::vector<ModuleMergeblock::Index::Entry> &entries = m_index.entries();
+	const QSet<int> &dataB = seed ? seed->getDataFromCurrent(m_sampler.mainB()) : QSet<int>{};
+
+	std::vector<int> list = SeedSampler::sample((int) entries.size(), 1, [&entries, &dataB, &block](const int &e) {
+		return entries.at(e).block != block && !dataB.contains(entries.at(e).sub);
+	});
+
+	if (list.empty()) {
+		m_sampler.setReadyToClearB(seed);
+
+		list = SeedSampler::sample((int) entries.size(), 1, [&entries, &block](const int &e) {
+			return entries.at(e).block != block;
+		});
+	}
+
+	return list.empty() ? -1 : list.front();
+}
+
+
+
+/**
+ * @brief SimplechoiceTemplate::bindingOne
+ * @param item
+ * @return
+ */
+
+QVariantMap SimplechoiceTemplate::bindingOne(const int &item) const
+{
+	const ModuleSimplechoice::Binding &b = m_bindings.at(item);
+
+	const QString &correct = m_isBindToRight ? b.left : b.right;
+
+	QVariantMap retMap = questionMap(m_isBindToRight ? b.right : b.left);
+
+	// Rossz válaszok: néhány véletlen másik pár (nem kell az összeset végigjárni)
+
+	const std::vector<int> &ids = SeedSampler::sample((int) m_bindings.size(), optionCount(m_maxOptions)-1,
+													  [this, &b, &correct](const int &id) {
+		const ModuleSimplechoice::Binding &other = m_bindings.at(id);
+
+		if (m_isBindToRight)
+			return other.right != b.right && !other.left.isEmpty() && other.left != correct;
+		else
+			return other.left != b.left && !other.right.isEmpty() && other.right != correct;
+	});
+
+	QStringList alist;
+	alist.reserve(ids.size());
+
+	for (const int &id : ids)
+		alist.append(m_isBindToRight ? m_bindings.at(id).left : m_bindings.at(id).right);
+
+	retMap.insert(m_module->generateOne(correct, alist, m_maxOptions));
+
+	return retMap;
+}
+
+
+
+/**
+ * @brief SimplechoiceTemplate::blockContainsOne
+ * @param entry
+ * @return
+ */
+
+QVariantMap SimplechoiceTemplate::blockContainsOne(const int &entry) const
+{
+	const ModuleMergeblock::Index::Entry &d = m_index.entries().at(entry);
+	const int left = m_index.blocks().at(d.block).left;
+
+	QVariantMap retMap = questionMap(m_index.word(d.word).simplified());
+
+	retMap.insert(m_module->generateOne(m_index.left(left),
+										m_index.sampleLefts(optionCount(m_maxOptions)-1, left),
+										m_maxOptions));
+
+	return retMap;
+}
+
+
+
+/**
+ * @brief SimplechoiceTemplate::blockSimpleOne
+ * @param block
+ * @param subB
+ * @return
+ */
+
+QVariantMap SimplechoiceTemplate::blockSimpleOne(const int &block, const int &subB) const
+{
+	const ModuleMergeblock::Index::Block &b = m_index.blocks().at(block);
+
+	QVariantMap retMap = questionMap(m_index.left(b.left));
+
+	// Rossz válaszok: a többi blokk egy-egy véletlen szava
+
+	retMap.insert(m_module->generateOne(m_index.word(b.content.at(subB - b.blockidx - 1)),
+										m_index.sampleBlockWords(optionCount(m_maxOptions)-1, block),
+										m_maxOptions));
+
+	return retMap;
+}
+
+
+
+/**
+ * @brief SimplechoiceTemplate::blockQuizOne
+ * @param block
+ * @return
+ */
+
+QVariantMap SimplechoiceTemplate::blockQuizOne(const int &block) const
+{
+	const ModuleMergeblock::Index::Block &b = m_index.blocks().at(block);
+
+	QVariantMap retMap = questionMap(m_index.left(b.left));
+
+	QStringList options = m_index.words(b);
+	const QString correct = options.takeFirst();
+
+	retMap.insert(m_module->generateOne(correct, options, m_maxOptions));
+
+	return retMap;
+}
+
+
+
+/**
+ * @brief SimplechoiceTemplate::blockExcludeOne
+ * @param block
+ * @param entry
+ * @return
+ */
+
+QVariantMap SimplechoiceTemplate::blockExcludeOne(const int &block, const int &entry) const
+{
+	const ModuleMergeblock::Index::Block &b = m_index.blocks().at(block);
+
+	QVariantMap retMap = questionMap(m_index.left(b.left));
+
+	retMap.insert(m_module->generateOne(m_index.word(m_index.entries().at(entry).word), m_index.words(b), m_maxOptions));
+
+	return retMap;
+}
+
+
+
 ModuleSimplechoice::ModuleSimplechoice(QObject *parent) : QObject(parent)
 {
 
@@ -268,69 +709,84 @@ QVariantList ModuleSimplechoice::generateAll(const QVariantMap &data, ModuleInte
 
 
 
-
 /**
- * @brief ModuleSimplechoice::generateBinding
+ * @brief ModuleSimplechoice::compile
  * @param data
  * @param storage
  * @param storageData
+ * @param commonDataPtr
  * @return
  */
 
-QVariantList ModuleSimplechoice::generateBinding(const QVariantMap &data, const QVariantMap &storageData, StorageSeed *seed) const
+QuestionTemplate *ModuleSimplechoice::compile(const QVariantMap &data, ModuleInterface *storage, const QVariantMap &storageData,
+											  QVariantMap *commonDataPtr) const
 {
-	bool isBindToRight = data.value(QStringLiteral("mode")).toString() == QStringLiteral("right");
-	QString question = data.value(QStringLiteral("question")).toString();
-	const int maxOptions = data.value(QStringLiteral("maxOptions")).toInt();
-
-	const QVariantList &list = storageData.value(QStringLiteral("bindings")).toList();
-
-	SeedDuplexHelper helper(seed, isBindToRight ? SEED_BINDING_RIGHT : SEED_BINDING_LEFT,
-							isBindToRight ? SEED_BINDING_LEFT: SEED_BINDING_RIGHT);
+	Q_UNUSED(commonDataPtr);
 
-	for (int i = 0; i<list.size(); ++i) {
-		QVariantMap m = list.at(i).toMap();
-		QString left = m.value(QStringLiteral("first")).toString();
-		QString right = m.value(QStringLiteral("second")).toString();
+	if (!storage)
+		return nullptr;
 
-		if (left.isEmpty() || right.isEmpty())
-			continue;
+	if (storage->name() == QStringLiteral("binding") || storage->name() == QStringLiteral("numbers"))
+		return new SimplechoiceTemplate(this, data, getBindings(storageData));
 
-		QVariantMap retMap;
+	if (storage->name() == QStringLiteral("block"))
+		return new SimplechoiceTemplate(this, data,
+										ModuleMergeblock::getUnion(storageData.value(QStringLiteral("blocks")).toList()));
 
-		if (question.isEmpty())
-			retMap[QStringLiteral("question")] = (isBindToRight ? right : left);
-		else if (question.contains(QStringLiteral("%1")))
-			retMap[QStringLiteral("question")] = question.arg(isBindToRight ? right : left);
-		else
-			retMap[QStringLiteral("question")] = question;
+	if (storage->name() == QStringLiteral("mergeblock"))
+		return new SimplechoiceTemplate(this, data,
+										ModuleMergeblock::getUnion(
+											storageData.value(QStringLiteral("sections")).toList(),
+											data.value(QStringLiteral("sections")).toStringList()
+											));
 
-		retMap[QStringLiteral("monospace")] = data.value(QStringLiteral("monospace")).toBool();
+	return nullptr;
+}
 
-		QStringList alist;
 
-		for (const QVariant &v : list) {
-			QVariantMap mm = v.toMap();
-			QString f1 = mm.value(QStringLiteral("first")).toString();
-			QString f2 = mm.value(QStringLiteral("second")).toString();
 
-			if ((isBindToRight && right == f2) || (!isBindToRight && left == f1))
-				continue;
+/**
+ * @brief ModuleSimplechoice::getBindings
+ * @param storageData
+ * @return
+ */
 
-			alist.append(isBindToRight ? f1 : f2);
-		}
+QList<ModuleSimplechoice::Binding> ModuleSimplechoice::getBindings(const QVariantMap &storageData)
+{
+	const QVariantList &list = storageData.value(QStringLiteral("bindings")).toList();
 
-		retMap.insert(generateOne(isBindToRight ? left : right, alist, maxOptions));
+	QList<Binding> bindings;
+	bindings.reserve(list.size());
 
-		helper.append(retMap, i+1, i+1);
+	for (const QVariant &v : list) {
+		const QVariantMap &m = v.toMap();
+		bindings.append(Binding{
+							.left = m.value(QStringLiteral("first")).toString(),
+							.right = m.value(QStringLiteral("second")).toString()
+						});
 	}
 
-	return helper.getVariantList(true);
+	return bindings;
 }
 
 
 
 
+/**
+ * @brief ModuleSimplechoice::generateBinding
+ * @param data
+ * @param storage
+ * @param storageData
+ * @return
+ */
+
+QVariantList ModuleSimplechoice::generateBinding(const QVariantMap &data, const QVariantMap &storageData, StorageSeed *seed) const
+{
+	return SimplechoiceTemplate(this, data, getBindings(storageData)).generate(seed);
+}
+
+
+
 /**
  * @brief ModuleSimplechoice::generateMergeBinding
  * @param data
@@ -495,19 +951,8 @@ QVariantList ModuleSimplechoice::generateImages(const QVariantMap &data, const Q
 
 QVariantList ModuleSimplechoice::generateBlock(const QVariantMap &data, const QVariantMap &storageData, StorageSeed *seed) const
 {
-	const QString &mode = data.value(QStringLiteral("mode")).toString();
-	const ModuleMergeblock::BlockUnion blocks = ModuleMergeblock::getUnion(storageData.value(QStringLiteral("blocks")).toList());
-
-	if (mode == QStringLiteral("simple"))
-		return generateBlockSimple(data, blocks, seed);
-	else if (mode == QStringLiteral("contains"))
-		return generateBlockContains(data, blocks, seed);
-	else if (mode == QStringLiteral("quiz"))
-		return generateBlockQuiz(data, blocks, seed);
-	else if (mode == QStringLiteral("exclude"))
-		return generateBlockExclude(data, blocks, seed);
-
-	return {};
+	return SimplechoiceTemplate(this, data,
+								ModuleMergeblock::getUnion(storageData.value(QStringLiteral("blocks")).toList())).generate(seed);
 }
 
 
@@ -523,293 +968,11 @@ QVariantList ModuleSimplechoice::generateBlock(const QVariantMap &data, const QV
 
 QVariantList ModuleSimplechoice::generateMergeBlock(const QVariantMap &data, const QVariantMap &storageData, StorageSeed *seed) const
 {
-	const QString &mode = data.value(QStringLiteral("mode")).toString();
-
-	const ModuleMergeblock::BlockUnion blocks = ModuleMergeblock::getUnion(
-													storageData.value(QStringLiteral("sections")).toList(),
-													data.value(QStringLiteral("sections")).toStringList()
-													);
-
-	if (mode == QStringLiteral("simple"))
-		return generateBlockSimple(data, blocks, seed);
-	else if (mode == QStringLiteral("contains"))
-		return generateBlockContains(data, blocks, seed);
-	else if (mode == QStringLiteral("quiz"))
-		return generateBlockQuiz(data, blocks, seed);
-	else if (mode == QStringLiteral("exclude"))
-		return generateBlockExclude(data, blocks, seed);
-
-	return {};
-}
-
-
-
-/**
- * @brief ModuleSimplechoice::generateBlockContains
- * @param data
- * @param blocks
- * @return
- */
-
-QVariantList ModuleSimplechoice::generateBlockContains(const QVariantMap &data, const ModuleMergeblock::BlockUnion &blocks, StorageSeed *seed) const
-{
-	SeedDuplexHelper helper(seed, SEED_BLOCK_RIGHT, SEED_BLOCK_LEFT);
-
-	const QString &question = data.value(QStringLiteral("question")).toString();
-
-	const QStringList bNames = blocks.keys();
-
-	for (const auto &[left, list] : blocks.asKeyValueRange()) {
-		for (const auto &d : list) {
-			const QStringList &right = d.content;
-
-			if (left.isEmpty() || right.isEmpty())
-				continue;
-
-			for (int i=0; i<right.size(); ++i) {
-				const QString &s = right.at(i).simplified();
-
-				if (s.isEmpty())
-					continue;
-
-				QVariantMap retMap;
-
-				if (question.isEmpty())
-					retMap[QStringLiteral("question")] = s;
-				else if (question.contains(QStringLiteral("%1")))
-					retMap[QStringLiteral("question")] = question.arg(s);
-				else
-					retMap[QStringLiteral("question")] = question;
-
-				retMap[QStringLiteral("monospace")] = data.value(QStringLiteral("monospace")).toBool();
-
-				QStringList alist;
-
-				for (const QString &opt : bNames) {
-					if (opt == left)
-						continue;
-
-					alist.append(opt);
-				}
-
-				retMap.insert(generateOne(left, alist, data.value(QStringLiteral("maxOptions")).toInt()));
-
-				// Seed main: 2
-				// Seed sub: (block index+1) * 1000 + (answer index + 1)
-
-				const int sub = d.blockidx + i+1;
-
-				helper.append(retMap, sub, d.blockidx);
-			}
-		}
-
-	}
-
-	return helper.getVariantList(true);
-}
-
-
-
-
-/**
- * @brief ModuleSimplechoice::generateBlockExclude
- * @param data
- * @param blocks
- * @param seed
- * @return
- */
-
-QVariantList ModuleSimplechoice::generateBlockExclude(const QVariantMap &data, const ModuleMergeblock::BlockUnion &blocks, StorageSeed *seed) const
-{
-	SeedDuplexHelper helper(seed, SEED_BLOCK_LEFT, SEED_BLOCK_RIGHT);
-
-	const QString &question = data.value(QStringLiteral("question")).toString();
-	const int maxOptions = data.value(QStringLiteral("maxOptions")).toInt();
-
-
-	struct Data {
-		QString answer;
-		int idx = 0;
-	};
-
-
-	for (auto bit = blocks.cbegin(); bit != blocks.cend(); ++bit) {
-		const QString &left = bit.key();
-
-		for (auto it = bit.value().cbegin(); it != bit.value().cend(); ++it) {
-			const QStringList &right = it->content;
-
-			if (left.isEmpty() || right.isEmpty())
-				continue;
-
-			QVariantMap retMap;
-
-			if (question.isEmpty())
-				retMap[QStringLiteral("question")] = left;
-			else if (question.contains(QStringLiteral("%1")))
-				retMap[QStringLiteral("question")] = question.arg(left);
-			else
-				retMap[QStringLiteral("question")] = question;
-
-			retMap[QStringLiteral("monospace")] = data.value(QStringLiteral("monospace")).toBool();
-
-
-			QList<Data> alist;
-
-
-			for (auto bit2 = blocks.cbegin(); bit2 != blocks.cend(); ++bit2) {
-				for (auto it2 = bit2.value().cbegin(); it2 != bit2.value().cend(); ++it2) {
-					if (bit == bit2 && it2 == it)
-						continue;
-
-					const QString &wleft = bit2.key();
-					const QStringList &wright = it2->content;
-
-					if (wleft.isEmpty() || wright.isEmpty())
-						continue;
-
-					const int offset = it2->blockidx+1;
-
-					const QList<int> idxList = helper.getAllSubB(offset, offset+wright.size());
-
-					for (const int &idx : idxList) {
-						const int real = idx - offset;
-
-						alist.append(Data{.answer = wright.at(real), .idx = idx});
-					}
-				}
-			}
-
-			if (alist.isEmpty())
-				continue;
-
-			const Data &d = alist.at(QRandomGenerator::global()->bounded(alist.size()));
-
-			retMap.insert(generateOne(d.answer, right, maxOptions));
-			helper.append(retMap, it->blockidx, d.idx);
-
-		}
-	}
-
-	return helper.getVariantList(true);
-}
-
-
-
-
-
-
-/**
- * @brief ModuleSimplechoice::generateBlockSimple
- * @param data
- * @param blocks
- * @return
- */
-
-QVariantList ModuleSimplechoice::generateBlockSimple(const QVariantMap &data, const ModuleMergeblock::BlockUnion &blocks, StorageSeed *seed) const
-{
-	SeedDuplexHelper helper(seed, SEED_BLOCK_LEFT, SEED_BLOCK_RIGHT);
-
-	const QString &question = data.value(QStringLiteral("question")).toString();
-	const int maxOptions = data.value(QStringLiteral("maxOptions")).toInt();
-
-
-	for (auto bit = blocks.cbegin(); bit != blocks.cend(); ++bit) {
-		const QString &left = bit.key();
-
-		for (auto it = bit.value().cbegin(); it != bit.value().cend(); ++it) {
-			const QStringList &right = it->content;
-
-			if (left.isEmpty() || right.isEmpty())
-				continue;
-
-			QVariantMap retMap;
-
-			if (question.isEmpty())
-				retMap[QStringLiteral("question")] = left;
-			else if (question.contains(QStringLiteral("%1")))
-				retMap[QStringLiteral("question")] = question.arg(left);
-			else
-				retMap[QStringLiteral("question")] = question;
-
-			retMap[QStringLiteral("monospace")] = data.value(QStringLiteral("monospace")).toBool();
-
-			//const int idx = QRandomGenerator::global()->bounded(right.size());
-			const int idx = helper.getSubBOffset(right.size(), it->blockidx+1);
-			const QString &correct = right.at(idx);
-
-			QStringList alist;
-
-			for (auto bit2 = blocks.cbegin(); bit2 != blocks.cend(); ++bit2) {
-				for (auto it2 = bit2.value().cbegin(); it2 != bit2.value().cend(); ++it2) {
-					if (bit == bit2 && it2 == it)
-						continue;
-
-					const QStringList &right = it2->content;
-
-					if (right.isEmpty())
-						continue;
-
-					alist.append(right.at(QRandomGenerator::global()->bounded(right.size())));
-				}
-			}
-
-			retMap.insert(generateOne(correct, alist, maxOptions));
-
-			helper.append(retMap, it->blockidx, it->blockidx + idx+1);
-		}
-	}
-
-	return helper.getVariantList(true);
-}
-
-
-
-/**
- * @brief ModuleSimplechoice::generateBlockQuiz
- * @param data
- * @param blocks
- * @param seed
- * @return
- */
-
-QVariantList ModuleSimplechoice::generateBlockQuiz(const QVariantMap &data, const ModuleMergeblock::BlockUnion &blocks, StorageSeed *seed) const
-{
-	SeedDuplexHelper helper(seed, SEED_BLOCK_LEFT, SEED_BLOCK_RIGHT);
-
-	const QString &question = data.value(QStringLiteral("question")).toString();
-	const int maxOptions = data.value(QStringLiteral("maxOptions")).toInt();
-
-
-	for (auto bit = blocks.cbegin(); bit != blocks.cend(); ++bit) {
-		const QString &left = bit.key();
-
-		for (auto it = bit.value().cbegin(); it != bit.value().cend(); ++it) {
-			QStringList right = it->content;
-
-			if (left.isEmpty() || right.isEmpty())
-				continue;
-
-			QVariantMap retMap;
-
-			if (question.isEmpty())
-				retMap[QStringLiteral("question")] = left;
-			else if (question.contains(QStringLiteral("%1")))
-				retMap[QStringLiteral("question")] = question.arg(left);
-			else
-				retMap[QStringLiteral("question")] = question;
-
-			retMap[QStringLiteral("monospace")] = data.value(QStringLiteral("monospace")).toBool();
-
-			const QString correct = right.takeFirst();
-
-			retMap.insert(generateOne(correct, right, maxOptions));
-
-			helper.append(retMap, it->blockidx, it->blockidx + 0 + 1);
-		}
-	}
-
-	return helper.getVariantList(true);
+	return SimplechoiceTemplate(this, data,
+								ModuleMergeblock::getUnion(
+									storageData.value(QStringLiteral("sections")).toList(),
+									data.value(QStringLiteral("sections")).toStringList()
+									)).generate(seed);
 }
 
 
@@ -898,15 +1061,16 @@ QVariantMap ModuleSimplechoice::generateOne(const QString &correctAnswer, QStrin
 	QVector<QPair<QString, bool>> opts;
 	opts.append(qMakePair(correctAnswer, true));
 
-	std::random_device rd;
-	std::mt19937 g(rd());
-	std::shuffle(optionsList.begin(), optionsList.end(), g);
+	QRandomGenerator *g = QRandomGenerator::global();
 
-	for (const QString &o : optionsList) {
-		if (opts.size() >= (maxOptions > 1 ? maxOptions : 4))
-			break;
+	// Csak annyi elemet keverünk meg, amennyire szükség van
+
+	const int count = optionCount(maxOptions);
+
+	for (int i=0; i<optionsList.size() && opts.size() < count; ++i) {
+		optionsList.swapItemsAt(i, g->bounded(i, optionsList.size()));
 
-		if (!o.isEmpty())
+		if (const QString &o = optionsList.at(i); !o.isEmpty())
 			opts.append(qMakePair(o, false));
 	}
 
@@ -915,7 +1079,7 @@ QVariantMap ModuleSimplechoice::generateOne(const QString &correctAnswer, QStrin
 
 	QStringList optList;
 
-	std::shuffle(opts.begin(), opts.end(), g);
+	std::shuffle(opts.begin(), opts.end(), *g);
 
 	for (const auto &p : opts) {
 		optList.append(p.first);
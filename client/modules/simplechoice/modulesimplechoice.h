@@ -71,19 +71,24 @@ public:
 	QVariantList generateAll(const QVariantMap &data, ModuleInterface *storage, const QVariantMap &storageData,
 							 QVariantMap *commonDataPtr, StorageSeed *seed) const override;
 
+	QuestionTemplate *compile(const QVariantMap &data, ModuleInterface *storage, const QVariantMap &storageData,
+							  QVariantMap *commonDataPtr) const override;
+
 	qreal xpFactor() const override { return 1.1; };
 
+	struct Binding {
+		QString left;
+		QString right;
+	};
+
+	static QList<Binding> getBindings(const QVariantMap &storageData);
+
 	QVariantList generateBinding(const QVariantMap &data, const QVariantMap &storageData, StorageSeed *seed) const;
 	QVariantList generateMergeBinding(const QVariantMap &data, const QVariantMap &storageData, StorageSeed *seed) const;
 	QVariantList generateImages(const QVariantMap &data, const QVariantMap &storageData, StorageSeed *seed) const;
 	QVariantList generateBlock(const QVariantMap &data, const QVariantMap &storageData, StorageSeed *seed) const;
 	QVariantList generateMergeBlock(const QVariantMap &data, const QVariantMap &storageData, StorageSeed *seed) const;
 
-	QVariantList generateBlockContains(const QVariantMap &data, const ModuleMergeblock::BlockUnion &blocks, StorageSeed *seed) const;
-	QVariantList generateBlockExclude(const QVariantMap &data, const ModuleMergeblock::BlockUnion &blocks, StorageSeed *seed) const;
-	QVariantList generateBlockSimple(const QVariantMap &data, const ModuleMergeblock::BlockUnion &blocks, StorageSeed *seed) const;
-	QVariantList generateBlockQuiz(const QVariantMap &data, const ModuleMergeblock::BlockUnion &blocks, StorageSeed *seed) const;
-
 	QVariantList generateSequence(const QVariantMap &data, const QVariantMap &storageData, StorageSeed *seed) const;
 	QVariantMap generateOne(const QString &correctAnswer, QStringList optionsList, const int &maxOptions) const;
 
@@ -236,16 +236,16 @@ QVariantList ModuleWriter::generateAll(const QVariantMap &data, ModuleInterface
 		return generateBinding(data, storageData, seed);
 
 	if (storage->name() == QStringLiteral("block")) {
-		const ModuleMergeblock::BlockUnion blocks = ModuleMergeblock::getUnion(storageData.value(QStringLiteral("blocks")).toList());
-		return generateBlockContains(data, blocks, seed);
+		const ModuleMergeblock::Index index(ModuleMergeblock::getUnion(storageData.value(QStringLiteral("blocks")).toList()));
+		return generateBlockContains(data, index, seed);
 	}
 
 	if (storage->name() == QStringLiteral("mergeblock")) {
-		const ModuleMergeblock::BlockUnion blocks = ModuleMergeblock::getUnion(
-														storageData.value(QStringLiteral("sections")).toList(),
-														data.value(QStringLiteral("sections")).toStringList()
-														);
-		return generateBlockContains(data, blocks, seed);
+		const ModuleMergeblock::Index index(ModuleMergeblock::getUnion(
+												storageData.value(QStringLiteral("sections")).toList(),
+												data.value(QStringLiteral("sections")).toStringList()
+												));
+		return generateBlockContains(data, index, seed);
 	}
 
 
@@ -578,29 +578,28 @@ QVariantList ModuleWriter::generateText(const QVariantMap &/*data*/, const QVari
 /**
  * @brief ModuleWriter::generateBlockContains
  * @param data
- * @param blocks
+ * @param index
  * @param seed
  * @return
  */
 
-QVariantList ModuleWriter::generateBlockContains(const QVariantMap &data, const ModuleMergeblock::BlockUnion &blocks, StorageSeed *seed) const
+QVariantList ModuleWriter::generateBlockContains(const QVariantMap &data, const ModuleMergeblock::Index &index, StorageSeed *seed) const
 {
 	SeedDuplexHelper helper(seed, SEED_BLOCK_RIGHT, SEED_BLOCK_LEFT);
 
 	const QString &question = data.value(QStringLiteral("question")).toString();
 
-	for (const auto &[left, list] : blocks.asKeyValueRange()) {
-		for (const auto &d : list) {
-			const QStringList &right = d.content;
-			if (left.isEmpty() || right.isEmpty())
+	for (const ModuleMergeblock::Index::Block &b : index.blocks()) {
+		for (int i=0; i<(int) b.content.size(); ++i) {
+			const int word = b.content.at(i);
+
+			if (index.word(word).simplified().isEmpty())
 				continue;
 
-			QVariantMap retMap;
+			const auto generator = [&data, &question, &index, left = b.left, word]() {
+				const QString &s = index.word(word).simplified();
 
-			for (int i=0; i<right.size(); ++i) {
-				const QString &s = right.at(i).simplified();
-				if (s.isEmpty())
-					continue;
+				QVariantMap retMap;
 
 				if (question.isEmpty())
 					retMap[QStringLiteral("question")] = s;
@@ -611,16 +610,17 @@ QVariantList ModuleWriter::generateBlockContains(const QVariantMap &data, const
 
 				retMap[QStringLiteral("monospace")] = data.value(QStringLiteral("monospace")).toBool();
 
-				retMap[QStringLiteral("answer")] = left;
+				retMap[QStringLiteral("answer")] = index.left(left);
 
-				// Seed main: 2
-				// Seed sub: (block index+1) * 1000 + (answer index + 1)
+				return retMap;
+			};
 
-				const int sub = d.blockidx + i+1;
+			// Seed main: 2
+			// Seed sub: (block index+1) * 1000 + (answer index + 1)
 
-				helper.append(retMap, sub, d.blockidx);
-			}
+			const int sub = b.blockidx + i+1;
 
+			helper.append(generator, sub, b.blockidx);
 		}
 	}
 
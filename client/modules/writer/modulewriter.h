@@ -80,7 +80,7 @@ public:
 	QVariantList generateImages(const QVariantMap &data, const QVariantMap &storageData, StorageSeed *seed) const;
 	QVariantList generateSequence(const QVariantMap &data, const QVariantMap &storageData) const;
 	QVariantList generateText(const QVariantMap &data, const QVariantMap &storageData, StorageSeed *seed) const;
-	QVariantList generateBlockContains(const QVariantMap &data, const ModuleMergeblock::BlockUnion &blocks, StorageSeed *seed) const;
+	QVariantList generateBlockContains(const QVariantMap &data, const ModuleMergeblock::Index &index, StorageSeed *seed) const;
 	QVariantList generateMergeBinding(const QVariantMap &data, const QVariantMap &storageData, StorageSeed *seed) const;
 
 	QList<int> images(const QVariantMap &) const override { return QList<int>(); };
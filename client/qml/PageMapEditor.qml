@@ -98,6 +98,17 @@ QPage {
 
 		}
 
+		Qaterial.AppBarButton {
+			icon.source: Qaterial.Icons.speedometer
+			ToolTip.text: qsTr("Feladatok ellenőrzése")
+
+			visible: swipeView.currentIndex == 0 && mapEditor.map
+
+			onClicked: Client.stackPushPage("PageMapEditorQuestionBenchmark.qml", {
+												mapEditor: root.mapEditor
+											})
+		}
+
 		Qaterial.AppBarButton {
 			id: _filter
 
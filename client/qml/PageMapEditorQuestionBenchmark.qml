@@ -0,0 +1,103 @@
+import QtQuick
+import QtQuick.Controls
+import Qaterial as Qaterial
+import "./QaterialHelper" as Qaterial
+import CallOfSuli
+import "JScript.js" as JS
+
+QPage {
+	id: control
+
+	required property MapEditor mapEditor
+
+	property bool _running: false
+
+	title: qsTr("Feladatok ellenőrzése")
+
+	appBar.backButtonVisible: true
+
+	appBar.rightComponent: Qaterial.AppBarButton {
+		icon.source: Qaterial.Icons.refresh
+		ToolTip.text: qsTr("Újra")
+		enabled: !control._running
+		onClicked: control.start()
+	}
+
+
+	Connections {
+		target: control.mapEditor
+
+		function onQuestionBenchmarkFinished(results) {
+			_view.loadFromList(results)
+			control._running = false
+		}
+	}
+
+
+	Qaterial.BusyIndicator {
+		anchors.centerIn: parent
+		visible: control._running
+	}
+
+
+	QScrollable {
+		anchors.fill: parent
+		horizontalPadding: 0
+		bottomPadding: 0
+
+		refreshEnabled: false
+
+		visible: !control._running
+
+		QListView {
+			id: _view
+
+			currentIndex: -1
+			height: contentHeight
+			width: Math.min(parent.width, Qaterial.Style.maxContainerSize)
+			anchors.horizontalCenter: parent.horizontalCenter
+
+			boundsBehavior: Flickable.StopAtBounds
+
+
+			model: ListModel {
+				id: _model
+			}
+
+			delegate: QItemDelegate {
+				highlighted: ListView.isCurrentItem
+				iconSource: warnings.length ? Qaterial.Icons.alertOutline : Qaterial.Icons.checkCircleOutline
+				iconColorBase: warnings.length ? Qaterial.Colors.red400 : Qaterial.Style.iconColor()
+
+				text: chapter + " – " + module + (storageModule !== "" ? " / " + storageModule : "")
+				secondaryText: qsTr("%1 ms, %2 kérdés, %3 különböző, %4% ismétlődés")
+							   .arg(msec.toFixed(2))
+							   .arg(questions)
+							   .arg(distinct)
+							   .arg((duplicateRate*100).toFixed(1))
+							   + (storageModule !== "" ? "\n" + qsTr("Játék közben: %1 ms fordítás, %2 ms/kérdés")
+															  .arg(compileMsec.toFixed(2))
+															  .arg(seedMsec.toFixed(2)) : "")
+							   + (warnings.length ? "\n" + warnings : "")
+			}
+
+
+			function loadFromList(list) {
+				_model.clear()
+
+				for (let i=0; i<list.length; ++i) {
+					let d = list[i]
+					d.warnings = d.warnings.join(", ")
+					_model.append(d)
+				}
+			}
+		}
+	}
+
+	function start() {
+		_running = true
+		mapEditor.questionBenchmark()
+	}
+
+	StackView.onActivated: if (!_model.count) start()
+}
@@ -137,6 +137,40 @@ FocusScope {
 	}
 
 
+	Rectangle {
+		id: _profilerOverlay
+
+		anchors.right: parent.right
+		anchors.top: parent.top
+		anchors.margins: 5
+		anchors.topMargin: Math.max(Client.safeMarginTop, 60)
+		anchors.rightMargin: Math.max(Client.safeMarginRight, 10)
+
+		visible: Client.debug && _game.debugView && _profilerText.text != ""
+
+		width: _profilerText.implicitWidth + 10
+		height: _profilerText.implicitHeight + 10
+
+		color: "#A0000000"
+
+		Text {
+			id: _profilerText
+			anchors.centerIn: parent
+			font.family: "monospace"
+			font.pixelSize: 10
+			color: Qaterial.Colors.lightGreen300
+		}
+
+		Timer {
+			interval: 1000
+			repeat: true
+			running: Client.debug && _game.debugView
+			triggeredOnStart: true
+			onTriggered: _profilerText.text = _game.profilerReport()
+		}
+	}
+
+
 	Row {
 		anchors.left: _rowTime.left
 		anchors.top: _rowTime.bottom
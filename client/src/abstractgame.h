@@ -141,6 +141,13 @@ public:
 			return m_startTick+elapsed;
 		}
 
+		qreal currentTickF() const {
+			if (!m_reference.isValid())
+				return -1.;
+
+			return m_startTick + (m_reference.elapsed()+m_latency)*60./1000.;
+		}
+
 		const qint64 &startTick() const { return m_startTick; }
 
 		static int interval() { return m_interval; }
@@ -89,7 +89,7 @@ QVector<Question> AbstractLevelGame::createQuestions()
 			int n = (objective->storageId() > 0 ? objective->storageCount() : 1);
 
 			for (int i=0; i<n; ++i)
-				list.append(Question(m_storageSeed, objective));
+				list.append(Question(m_storageSeed, objective, m_questionTemplates));
 
 		}
 	}
@@ -143,6 +143,22 @@ void AbstractLevelGame::setStorageSeed(StorageSeed *newStorageSeed)
 }
 
 
+/**
+ * @brief AbstractLevelGame::questionTemplates
+ * @return
+ */
+
+QuestionTemplateCache *AbstractLevelGame::questionTemplates() const
+{
+	return m_questionTemplates;
+}
+
+void AbstractLevelGame::setQuestionTemplates(QuestionTemplateCache *newQuestionTemplates)
+{
+	m_questionTemplates = newQuestionTemplates;
+}
+
+
 
 const QStringList &AbstractLevelGame::availableMedal()
 {
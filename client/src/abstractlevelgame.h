@@ -92,6 +92,9 @@ public:
 	StorageSeed *storageSeed() const;
 	void setStorageSeed(StorageSeed *newStorageSeed);
 
+	QuestionTemplateCache *questionTemplates() const;
+	void setQuestionTemplates(QuestionTemplateCache *newQuestionTemplates);
+
 protected:
 	QVector<Question> createQuestions();
 	virtual void onTimerLeftTimeout();
@@ -111,6 +114,7 @@ protected:
 	int m_xp = 0;
 	QTimer m_timerLeft;
 	StorageSeed *m_storageSeed = nullptr;
+	QuestionTemplateCache *m_questionTemplates = nullptr;
 
 private:
 	bool m_deadlineTimeout = false;
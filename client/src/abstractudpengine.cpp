@@ -79,6 +79,7 @@ AbstractUdpEngine::~AbstractUdpEngine()
 {
 #ifndef Q_OS_WASM
 	m_worker->getThread()->requestInterruption();
+	d->wakeUp();
 	m_worker->quitThread();
 	m_worker->getThread()->wait();
 #endif
@@ -100,9 +101,7 @@ AbstractUdpEngine::~AbstractUdpEngine()
 void AbstractUdpEngine::sendMessage(const QByteArray &data, const bool &reliable, const bool &sign)
 {
 #ifndef Q_OS_WASM
-	m_worker->execInThread([this, data, reliable, sign](){
-		d->sendMessage(data, reliable, sign);
-	});
+	d->sendMessage(data, reliable, sign);			// thread safe (mutex)
 #endif
 }
 
@@ -119,6 +118,7 @@ void AbstractUdpEngine::setUrl(const QUrl &url)
 	m_worker->execInThread([this, url](){
 		d->setUrl(url);
 	});
+	d->wakeUp();
 #endif
 }
 
@@ -137,6 +137,7 @@ QByteArray AbstractUdpEngine::connectionToken() const
 		token = d->connectionToken();
 		ret.resolve();
 	});
+	d->wakeUp();
 
 	QDefer::await(ret);
 #endif
@@ -157,6 +158,7 @@ void AbstractUdpEngine::setConnectionToken(const QByteArray &token)
 	m_worker->execInThread([this, token](){
 		d->setConnectionToken(token);
 	});
+	d->wakeUp();
 #endif
 }
 
@@ -177,6 +179,7 @@ int AbstractUdpEngine::currentRtt() const
 	m_worker->execInThread([this, &rtt](){
 		rtt = d->currentRtt();
 	});
+	d->wakeUp();
 
 	QDefer::await(ret);
 #endif
@@ -198,6 +201,27 @@ void AbstractUdpEngine::setCurrentRtt(const int &rtt)
 	m_worker->execInThread([this, rtt](){
 		d->setCurrentRtt(rtt);
 	});
+	d->wakeUp();
+#endif
+}
+
+
+
+
+/**
+ * @brief AbstractUdpEngine::setServiceInterval
+ * @param msec
+ *
+ * Ennyi ideig vár a hálózati szál egy-egy ENet eseményre (játék közben kicsi, egyébként lehet nagyobb)
+ */
+
+void AbstractUdpEngine::setServiceInterval(const int &msec)
+{
+#ifndef Q_OS_WASM
+	m_worker->execInThread([this, msec](){
+		d->setServiceInterval(msec);
+	});
+	d->wakeUp();
 #endif
 }
 
@@ -230,8 +254,10 @@ void AbstractUdpEnginePrivate::run()
 		QThread::currentThread()->eventDispatcher()->processEvents(QEventLoop::ProcessEventsFlag::AllEvents);
 
 		if (!m_enet_host) {
-			if (m_url.isEmpty())
+			if (m_url.isEmpty()) {
+				waitForWakeUp(idleTimeout);
 				continue;
+			}
 
 
 			// Channel 0: unsigned
@@ -242,7 +268,7 @@ void AbstractUdpEnginePrivate::run()
 			if (!client) {
 				LOG_CERROR("client") << "Connection refused" << qPrintable(m_url.toDisplayString());
 				emit q->serverConnectFailed(tr("Connection error"));
-				QThread::msleep(500);
+				waitForWakeUp(nextBackoff());
 				continue;
 			}
 
@@ -264,12 +290,13 @@ void AbstractUdpEnginePrivate::run()
 				} else {
 					emit q->serverConnectFailed(tr("Connection refused"));
 				}
-				QThread::msleep(500);
+				waitForWakeUp(nextBackoff());
 				continue;
 			}
 
 			if (enet_host_service(client, &event, 1000) > 0 && event.type == ENET_EVENT_TYPE_CONNECT) {
 				LOG_CINFO("client") << "Connected to host" << qPrintable(m_url.toDisplayString());
+				m_backoff = 0;
 				if (m_udpState == UdpServerResponse::StateConnected)
 					emit q->serverConnected();
 			} else {
@@ -283,7 +310,7 @@ void AbstractUdpEnginePrivate::run()
 					emit q->serverConnectFailed(tr("Connection failed"));
 				}
 
-				QThread::msleep(500);
+				waitForWakeUp(nextBackoff());
 				continue;
 			}
 
@@ -299,7 +326,7 @@ void AbstractUdpEnginePrivate::run()
 
 		ENetEvent event;
 
-		int r = enet_host_service (m_enet_host, &event, 1000./240.);
+		int r = enet_host_service (m_enet_host, &event, m_serviceInterval);
 
 		if (r < 0) {
 			LOG_CERROR("client") << "ENet host service error";
@@ -320,12 +347,11 @@ void AbstractUdpEnginePrivate::run()
 					if (m_udpState == UdpServerResponse::StateConnected) {
 						emit q->serverConnectionLost();
 						destroyHostAndPeer();
-						QThread::msleep(1000);
 					} else {
 						destroyHostAndPeer();
 						emit q->serverConnectFailed(tr("Connection rejected"));
-						QThread::msleep(1000);
 					}
+					waitForWakeUp(nextBackoff());
 					continue;
 					break;
 
@@ -406,6 +432,63 @@ void AbstractUdpEnginePrivate::run()
 
 
 
+/**
+ * @brief AbstractUdpEnginePrivate::wakeUp
+ *
+ * Bármelyik szálból hívható
+ */
+
+void AbstractUdpEnginePrivate::wakeUp()
+{
+	QMutexLocker locker(&m_wakeMutex);
+	m_wakeRequested = true;
+	m_wakeCondition.wakeAll();
+}
+
+
+
+/**
+ * @brief AbstractUdpEnginePrivate::waitForWakeUp
+ * @param msec
+ */
+
+void AbstractUdpEnginePrivate::waitForWakeUp(const int &msec)
+{
+	QMutexLocker locker(&m_wakeMutex);
+
+	if (!m_wakeRequested && !QThread::currentThread()->isInterruptionRequested())
+		m_wakeCondition.wait(&m_wakeMutex, QDeadlineTimer(msec));
+
+	m_wakeRequested = false;
+}
+
+
+
+/**
+ * @brief AbstractUdpEnginePrivate::nextBackoff
+ * @return
+ */
+
+int AbstractUdpEnginePrivate::nextBackoff()
+{
+	m_backoff = std::clamp(m_backoff*2, backoffMin, backoffMax);
+	return m_backoff;
+}
+
+
+
+/**
+ * @brief AbstractUdpEnginePrivate::setServiceInterval
+ * @param msec
+ */
+
+void AbstractUdpEnginePrivate::setServiceInterval(const int &msec)
+{
+	m_serviceInterval = std::max(0, msec);
+}
+
+
+
 /**
  * @brief AbstractUdpEnginePrivate::sendMessage
  * @param data
@@ -61,6 +61,8 @@ public:
 	int currentRtt() const;
 	void setCurrentRtt(const int &rtt);
 
+	void setServiceInterval(const int &msec);
+
 signals:
 	void serverConnected();
 	void serverDisconnected();
@@ -29,6 +29,7 @@
 
 #include "qmutex.h"
 #include "qurl.h"
+#include <QWaitCondition>
 #include <QObject>
 #include <QMap>
 #include <QElapsedTimer>
@@ -63,11 +64,18 @@ public:
 	QByteArray connectionToken() const;
 	void setConnectionToken(const QByteArray &newConnectionToken);
 
+	void setServiceInterval(const int &msec);
+
+	void wakeUp();
+
 
 private:
 	void updateChallenge();
 	void destroyHostAndPeer();
 
+	void waitForWakeUp(const int &msec);
+	int nextBackoff();
+
 	AbstractUdpEngine *q = nullptr;
 
 	QUrl m_url;
@@ -80,6 +88,19 @@ private:
 	ENetPeer *m_enet_peer = nullptr;
 #endif
 
+	// A hálózati szál felébresztése (új url, üzenet, leállítás)
+
+	QMutex m_wakeMutex;
+	QWaitCondition m_wakeCondition;
+	bool m_wakeRequested = false;
+
+	inline static constexpr int idleTimeout = 5000;				// várakozás, ha nincs url
+	inline static constexpr int backoffMin = 250;				// újracsatlakozás: kezdő várakozás
+	inline static constexpr int backoffMax = 8000;				// újracsatlakozás: maximális várakozás
+
+	int m_serviceInterval = 4;									// enet_host_service timeout (ms)
+	int m_backoff = 0;
+
 
 	struct Speed {
 		void addRtt(const int &rtt);
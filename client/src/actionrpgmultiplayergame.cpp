@@ -39,10 +39,12 @@
 #include "utils_.h"
 
 #include <chipmunk/chipmunk.h>
+#include <deque>
 
 
 
 #define CONNECTION_LOST_TIMEOUT				1000		// Ennyi ideig próbál újracsatlakozni (az ENet 5 mp után dobja ki)
+#define UPSTREAM_REDUNDANCY					3			// Ennyi korábbi (nem megbízható) snapshotot küldünk újra minden csomagban
 
 
 /**
@@ -61,6 +63,8 @@ private:
 	void resetEngine();
 	void sendPlayerData();
 	void sendAbort();
+	void sendUpstream(const QCborMap &snapshot, const bool &reliable);
+	void resetUpstream();
 
 	RpgGameData::Armory getArmory() const;
 
@@ -72,14 +76,23 @@ private:
 	{
 		const auto &ptr = m_currentSnapshot.getSnapshot(body->baseData());
 
+		if constexpr (std::is_same<T, RpgPlayer>::value) {
+			if (isHosted)
+				applyPrediction(body);
+		}
+
 		if (!ptr) {
 			if (isHosted)
 				body->worldStep();
 			return;
 		} else {
 			if (isHosted) {
-				if (ptr->s1.f >= 0)
-					body->updateFromLastSnapshot(ptr->s1);
+				if (ptr->s1.f >= 0) {
+					if constexpr (std::is_same<T, RpgPlayer>::value)
+						body->updateFromLastSnapshot(reconcile(body, ptr->s1));
+					else
+						body->updateFromLastSnapshot(ptr->s1);
+				}
 				body->worldStep();
 			} else {
 				body->updateFromSnapshot(ptr.value());
@@ -87,6 +100,9 @@ private:
 		}
 	}
 
+	void applyPrediction(RpgPlayer *player);
+	RpgGameData::Player reconcile(RpgPlayer *player, const RpgGameData::Player &snap);
+
 
 private:
 	RpgGameData::FullSnapshot m_currentSnapshot;
@@ -94,6 +110,10 @@ private:
 	qint64 m_lastSentTick = -1;
 	ClientStorage m_toSend;
 
+	quint32 m_upstreamSequence = 0;
+	quint32 m_upstreamEpoch = 0;					// minden resetUpstream() növeli, a szerver ebből tudja, hogy újrakezdtük a számozást
+	std::deque<QCborArray> m_upstreamHistory;
+
 	bool m_canAddEngine = false;
 	bool m_requireEngine = false;
 	int m_selectedEngineId = -1;
@@ -172,6 +192,108 @@ private:
 
 	TimeSync m_timeSync;
 
+
+	/**
+	 * @brief The Prediction class
+	 *
+	 * A saját (irányított) player pozíciója és sebessége tickenként. A szerver által visszaigazolt
+	 * pozícióból a még nem visszaigazolt sebességeket újrajátszva kapjuk a helyes aktuális pozíciót,
+	 * az eltérést több tick alatt simítva korrigáljuk.
+	 */
+
+	class Prediction {
+	public:
+		Prediction() = default;
+
+		void record(const qint64 &tick, const cpVect &pos, const cpVect &vel) {
+			m_history.insert_or_assign(tick, State{ .pos = pos, .vel = vel });
+
+			while (m_history.size() > m_historySize)
+				m_history.erase(m_history.begin());
+		}
+
+		/**
+		 * @brief The Correction class
+		 *
+		 * Eltérés a jósolt és az aktuális pozíció között. Ha a tickhez nincs előzmény,
+		 * nem simítunk: a szerver pozíciójából újrajátszott pozícióra ugrunk (hard).
+		 */
+
+		struct Correction {
+			cpVect delta = cpvzero;
+			bool hard = false;
+		};
+
+		Correction reconcile(const qint64 &tick, const cpVect &authPos, const cpVect &current) {
+			if (tick <= m_ackTick)
+				return {};
+
+			m_ackTick = tick;
+
+			const auto it = m_history.find(tick);
+			const bool found = it != m_history.end();
+
+			if (found && cpvdistsq(it->second.pos, authPos) < m_tolerance*m_tolerance) {
+				m_history.erase(m_history.begin(), std::next(it));
+				return {};
+			}
+
+			m_history.erase(m_history.begin(), m_history.upper_bound(tick));
+
+			// Replay
+
+			cpVect predicted = authPos;
+
+			for (const auto &[t, s] : m_history)
+				predicted = cpvadd(predicted, cpvmult(s.vel, 1./60.));
+
+			const cpVect correction = cpvsub(predicted, current);
+
+			for (auto &[t, s] : m_history)
+				s.pos = cpvadd(s.pos, correction);
+
+			// A még nem simított hiba már benne van a current-ben, ezért felülírjuk
+
+			m_error = found ? correction : cpvzero;
+
+			return Correction{ .delta = correction, .hard = !found };
+		}
+
+		cpVect smoothStep() {
+			if (cpvlengthsq(m_error) < 0.25) {
+				const cpVect step = m_error;
+				m_error = cpvzero;
+				return step;
+			}
+
+			const cpVect step = cpvmult(m_error, m_smoothFactor);
+			m_error = cpvsub(m_error, step);
+			return step;
+		}
+
+		void clear() {
+			m_history.clear();
+			m_ackTick = -1;
+			m_error = cpvzero;
+		}
+
+	private:
+		struct State {
+			cpVect pos = cpvzero;
+			cpVect vel = cpvzero;
+		};
+
+		std::map<qint64, State> m_history;
+		qint64 m_ackTick = -1;
+		cpVect m_error = cpvzero;
+
+		inline static constexpr std::size_t m_historySize = 120;			// 2 mp
+		inline static constexpr float m_tolerance = 1.;						// ennyi px eltérés még nem számít
+		inline static constexpr float m_smoothFactor = 0.2;					// tickenként ennyi részét korrigáljuk
+	};
+
+	Prediction m_prediction;
+
 	ActionRpgMultiplayerGame *const d;
 
 	QDeadlineTimer m_connectionLostTimer;
@@ -589,6 +711,8 @@ void ActionRpgMultiplayerGame::onConfigChanged()
 			QCborMap map;
 			map.insert(QStringLiteral("full"), true);
 			sendData(map.toCborValue().toCbor(), true);
+			q->resetUpstream();
+			q->m_prediction.clear();
 		}
 
 	}
@@ -1788,6 +1912,14 @@ void ActionRpgMultiplayerGame::onTimeStepped()
 	}
 
 
+#ifndef QT_NO_DEBUG
+	if (curr > 0 && curr % 600 == 0) {
+		const RpgJitterBuffer::Statistics &s = m_engine->jitterStatistics();
+		LOG_CDEBUG("game") << "Jitter buffer: depth" << s.bufferDepth << "delay" << s.delay << "/" << s.targetDelay
+						   << "jitter" << s.jitter << "ms late" << s.latePackets << "extrapolated" << s.extrapolatedFrames;
+	}
+#endif
+
 	m_rpgGame->iterateOverBodies([this](TiledObjectBody *b){
 		if (RpgGameData::LifeCycle *iface = dynamic_cast<RpgGameData::LifeCycle*> (b)) {
 			if (iface->stage() == RpgGameData::LifeCycle::StageDestroy) {
@@ -1846,23 +1978,25 @@ void ActionRpgMultiplayerGame::onTimeAfterWorldStep(const qint64 &tick)
 			if (RpgEnemy *iface = dynamic_cast<RpgEnemy*> (b)) {
 				if (q->m_toSend.appendSnapshot(iface, tick, forceKeyFrame))
 					hasSnap = true;
+				return;
 			}
 		};
 
+		if (b->objectId().ownerId != m_playerId)
+			return;
+
 		if (RpgBullet *iface = dynamic_cast<RpgBullet*> (b);
-				iface && b->objectId().ownerId == m_playerId &&
-				iface->stage() != RpgGameData::LifeCycle::StageDestroy) {
+				iface && iface->stage() != RpgGameData::LifeCycle::StageDestroy) {
 			if (q->m_toSend.appendSnapshot(iface, tick, forceKeyFrame))
 				hasSnap = true;
 		}
 	});
 
 	if (m_fullyPrepared) {
-		m_rpgGame->iterateOverBodies([this, &tick, hasSnap, forceKeyFrame](TiledObjectBody *b) {
-			if (RpgPlayer *iface = dynamic_cast<RpgPlayer*> (b); iface && m_rpgGame->controlledPlayer() == iface) {
-				q->m_toSend.appendSnapshot(iface, tick, forceKeyFrame || hasSnap);
-			}
-		});
+		if (RpgPlayer *player = m_rpgGame->controlledPlayer()) {
+			q->m_prediction.record(tick, player->bodyPosition(), cpBodyGetVelocity(player->body()));
+			q->m_toSend.appendSnapshot(player, tick, forceKeyFrame || hasSnap);
+		}
 	}
 
 
@@ -1870,10 +2004,15 @@ void ActionRpgMultiplayerGame::onTimeAfterWorldStep(const qint64 &tick)
 		return;
 
 
+	// Az események (támadás, vezérlők, lövedékek, halál) megbízhatóan mennek,
+	// a mozgás csak nem megbízhatóan, az előző csomagokkal együtt
+
+	const bool reliable = q->m_toSend.hasLifecycleEvent();
+
 	RpgGameData::CurrentSnapshot snapshot = q->m_toSend.renderCurrentSnapshot();
 
 	if (QCborMap map = snapshot.toCbor(); !map.isEmpty()) {
-		sendData(map.toCborValue().toCbor(), true);
+		q->sendUpstream(map, reliable);
 	}
 
 	q->m_lastSentTick = tick;
@@ -2656,6 +2795,18 @@ void ActionRpgMultiplayerGame::addLatency(const qint64 &latency)
 
 
 
+/**
+ * @brief ActionRpgMultiplayerGame::latency
+ * @return
+ */
+
+qint64 ActionRpgMultiplayerGame::latency() const
+{
+	return q->m_timeSync.getLatency();
+}
+
+
+
 /**
  * @brief ActionRpgMultiplayerGame::overrideCurrentFrame
  * @param tick
@@ -2720,6 +2871,73 @@ void ActionRpgMultiplayerGamePrivate::updateBody(TiledObjectBody *body, const bo
 }
 
 
+/**
+ * @brief ActionRpgMultiplayerGamePrivate::applyPrediction
+ * @param player
+ */
+
+void ActionRpgMultiplayerGamePrivate::applyPrediction(RpgPlayer *player)
+{
+	Q_ASSERT(player);
+
+	if (player != d->m_rpgGame->controlledPlayer())
+		return;
+
+	if (const cpVect step = m_prediction.smoothStep(); !cpveql(step, cpvzero))
+		player->emplace(cpvadd(player->bodyPosition(), step));
+}
+
+
+
+/**
+ * @brief ActionRpgMultiplayerGamePrivate::reconcile
+ * @param player
+ * @param snap
+ * @return
+ *
+ * A visszaigazolt snapshot pozícióját a jósolt pozícióval helyettesítjük,
+ * kivéve ha az eltérés túl nagy (ekkor a szerver pozíciójára ugrunk), vagy nincs előzmény a tickhez
+ * (ekkor a szerver pozíciójából újrajátszott pozícióra ugrunk)
+ */
+
+RpgGameData::Player ActionRpgMultiplayerGamePrivate::reconcile(RpgPlayer *player, const RpgGameData::Player &snap)
+{
+	Q_ASSERT(player);
+
+	if (player != d->m_rpgGame->controlledPlayer() || snap.p.size() < 2)
+		return snap;
+
+	if (snap.st == RpgGameData::Player::PlayerExit) {
+		m_prediction.clear();
+		return snap;
+	}
+
+	const cpVect current = player->bodyPosition();
+	const auto &correction = m_prediction.reconcile(snap.f, cpv(snap.p.at(0), snap.p.at(1)), current);
+
+	RpgGameData::Player p = snap;
+
+	if (correction.hard) {
+		LOG_CDEBUG("game") << "Prediction history missing, hard correction" << correction.delta.x << correction.delta.y << "@" << snap.f;
+
+		const cpVect pos = cpvadd(current, correction.delta);
+		p.p = QList<float>{ (float) pos.x, (float) pos.y };
+		return p;
+	}
+
+	if (!RpgGameData::Player::threshold(QList<float>{ 0., 0. }, QList<float>{ (float) correction.delta.x, (float) correction.delta.y })) {
+		LOG_CDEBUG("game") << "Prediction error" << correction.delta.x << correction.delta.y << "@" << snap.f;
+		m_prediction.clear();
+		return snap;
+	}
+
+	p.p = QList<float>{ (float) current.x, (float) current.y };
+
+	return p;
+}
+
+
+
 /**
  * @brief ActionRpgMultiplayerGamePrivate::resetEngine
  */
@@ -2739,6 +2957,61 @@ void ActionRpgMultiplayerGamePrivate::resetEngine()
 
 
 
+/**
+ * @brief ActionRpgMultiplayerGamePrivate::sendUpstream
+ * @param snapshot
+ * @param reliable
+ *
+ * Minden snapshot sorszámot kap. A nem megbízható csomagok az utolsó UPSTREAM_REDUNDANCY
+ * snapshotot is tartalmazzák, a szerver a sorszám alapján dobja el a duplikátumokat.
+ * A sorszámozás korszakát (epoch) is elküldjük, így a szerver a kliens újrakezdését követi.
+ */
+
+void ActionRpgMultiplayerGamePrivate::sendUpstream(const QCborMap &snapshot, const bool &reliable)
+{
+	QCborArray item;
+	item.append(++m_upstreamSequence);
+	item.append(snapshot);
+
+	QCborArray list;
+
+	if (reliable) {
+		list.append(item);
+	} else {
+		for (const QCborArray &a : m_upstreamHistory)
+			list.append(a);
+
+		list.append(item);
+
+		m_upstreamHistory.push_back(item);
+
+		while (m_upstreamHistory.size() > UPSTREAM_REDUNDANCY)
+			m_upstreamHistory.pop_front();
+	}
+
+	QCborMap map;
+	map.insert(QStringLiteral("u"), list);
+	map.insert(QStringLiteral("ue"), m_upstreamEpoch);
+
+	d->sendData(map.toCborValue().toCbor(), reliable);
+}
+
+
+
+/**
+ * @brief ActionRpgMultiplayerGamePrivate::resetUpstream
+ */
+
+void ActionRpgMultiplayerGamePrivate::resetUpstream()
+{
+	m_upstreamSequence = 0;
+	++m_upstreamEpoch;
+	m_upstreamHistory.clear();
+}
+
+
+
+
 /**
  * @brief ActionRpgMultiplayerGamePrivate::sendPlayerData
  */
@@ -198,6 +198,7 @@ private:
 
 	void setTickTimer(const qint64 &tick);
 	void addLatency(const qint64 &latency);
+	qint64 latency() const;
 	void overrideCurrentFrame(const qint64 &tick);
 
 	RpgUdpEngine *m_engine = nullptr;
@@ -252,6 +252,7 @@ SOURCES += \
 	offsetmodel.cpp \
 	pass.cpp \
 	question.cpp \
+	questionbenchmark.cpp \
 	rpgarmory.cpp \
 	rpgarrow.cpp \
 	rpgaxe.cpp \
@@ -286,6 +287,7 @@ SOURCES += \
 	scorelist.cpp \
 	server.cpp \
 	sound.cpp \
+	spritebenchmark.cpp \
 	stb_helper.cpp \
 	storageseed.cpp \
 	studentgroup.cpp \
@@ -304,8 +306,12 @@ SOURCES += \
 	tiledfixpositionmotor.cpp \
 	tiledgame.cpp \
 	tiledgamesfx.cpp \
+	tiledlineofsight.cpp \
+	tiledmapcache.cpp \
 	tiledobject.cpp \
+	tiledpathfinder.cpp \
 	tiledpathmotor.cpp \
+	tiledprofiler.cpp \
 	tiledreturnpathmotor.cpp \
 	tiledrotationmotor.cpp \
 	tiledscene.cpp \
@@ -372,6 +378,7 @@ HEADERS += \
 	offsetmodel.h \
 	pass.h \
 	question.h \
+	questionbenchmark.h \
 	rpgarmory.h \
 	rpgarrow.h \
 	rpgaxe.h \
@@ -410,6 +417,7 @@ HEADERS += \
 	scorelist.h \
 	server.h \
 	sound.h \
+	spritebenchmark.h \
 	storageseed.h \
 	studentgroup.h \
 	studentmap.h \
@@ -427,10 +435,14 @@ HEADERS += \
 	tiledfixpositionmotor.h \
 	tiledgame.h \
 	tiledgamesfx.h \
+	tiledlineofsight.h \
+	tiledmapcache.h \
 	tiledobject.h \
 	tiledobject_p.h \
 	tiledobjectspritedef.h \
+	tiledpathfinder.h \
 	tiledpathmotor.h \
+	tiledprofiler.h \
 	tiledreturnpathmotor.h \
 	tiledrotationmotor.h \
 	tiledscene.h \
@@ -53,7 +53,9 @@ public:
 		Demo,
 		DevPage,
 		Adjacency [[deprecated]],
-		Terminal
+		Terminal,
+		Benchmark,
+		BenchmarkSprite
 	};
 
 
@@ -30,6 +30,9 @@
 #include "standaloneclient.h"
 #include "desktoputils.h"
 #include "utils_.h"
+#include "questionbenchmark.h"
+#include "spritebenchmark.h"
+#include "gamemap.h"
 #include <sodium.h>
 
 #ifdef WITH_FTXUI
@@ -148,6 +151,8 @@ void DesktopApplication::commandLineParse()
 	parser.addOption({{QStringLiteral("p"), QStringLiteral("play")}, QObject::tr("Pálya lejátszása"), QStringLiteral("file")});
 	parser.addOption({{QStringLiteral("d"), QStringLiteral("demo")}, QObject::tr("Demo pálya lejátszása")});
 	parser.addOption({{QStringLiteral("terminal-name")}, QObject::tr("Terminál neve"), QStringLiteral("név")});
+	parser.addOption({{QStringLiteral("question-benchmark")}, QObject::tr("A pálya összes feladatának legyártása és ellenőrzése"), QStringLiteral("file")});
+	parser.addOption({{QStringLiteral("sprite-benchmark")}, QObject::tr("Animált karakterek sprite-váltásainak mérése")});
 
 #ifdef WITH_FTXUI
 	parser.addOption({{QStringLiteral("terminal")}, QObject::tr("Terminál indítása")});
@@ -169,6 +174,19 @@ void DesktopApplication::commandLineParse()
 	}
 
 
+	if (parser.isSet(QStringLiteral("question-benchmark"))) {
+		m_commandLine = Benchmark;
+		m_commandLineData = parser.value(QStringLiteral("question-benchmark"));
+		m_appender->setDetailsLevel(Logger::Warning);
+		return;
+	}
+
+	if (parser.isSet(QStringLiteral("sprite-benchmark"))) {
+		m_commandLine = BenchmarkSprite;
+		m_appender->setDetailsLevel(Logger::Warning);
+		return;
+	}
+
 	if (parser.isSet(QStringLiteral("terminal-name"))) {
 		m_localServerName = parser.value(QStringLiteral("terminal-name"));
 	}
@@ -241,9 +259,12 @@ void DesktopApplication::commandLineParse()
 
 /**
  * @brief DesktopApplication::performCommandLine
+ * @return
+ *
+ * Ha a parancssor alapján ki kell lépni, a kilépési kód (hiba esetén nem 0)
  */
 
-bool DesktopApplication::performCommandLine()
+std::optional<int> DesktopApplication::performCommandLine()
 {
 	if (m_commandLine == License)
 	{
@@ -254,10 +275,42 @@ bool DesktopApplication::performCommandLine()
 			out << *b << Qt::endl;
 		}
 
-		return false;
+		return 0;
+	}
+
+	if (m_commandLine == Benchmark)
+	{
+		const auto &b = Utils::fileContent(m_commandLineData);
+
+		if (!b) {
+			LOG_CERROR("app") << "Can't read file:" << qPrintable(m_commandLineData);
+			return 1;
+		}
+
+		std::unique_ptr<GameMap> map(GameMap::fromBinaryData(*b));
+
+		if (!map) {
+			LOG_CERROR("app") << "Invalid map:" << qPrintable(m_commandLineData);
+			return 1;
+		}
+
+		loadModules();
+
+		QTextStream out(stdout);
+		out << QuestionBenchmark::report(QuestionBenchmark::run(QuestionBenchmark::jobs(map.get()))) << Qt::flush;
+
+		return 0;
+	}
+
+	if (m_commandLine == BenchmarkSprite)
+	{
+		QTextStream out(stdout);
+		out << SpriteBenchmark::report(SpriteBenchmark::run()) << Qt::flush;
+
+		return 0;
 	}
 
-	return true;
+	return std::nullopt;
 }
 
 
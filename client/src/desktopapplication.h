@@ -45,7 +45,7 @@ public:
 	virtual void initialize() override;
 
 	void commandLineParse();
-	bool performCommandLine();
+	std::optional<int> performCommandLine();
 
 	void performInstanceArguments(const QStringList &arguments);
 
@@ -424,7 +424,7 @@ void IsometricEnemy::worldStep()
 	IsometricPlayer *tmpPlayer = nullptr;
 
 	if (m_player && m_contactedPlayers.contains(m_player) && m_player->isAlive()) {
-		if (rayCast(m_player->bodyPosition(), FixturePlayerBody).isVisible(m_player) && !featureOverride(FeatureVisibility, m_player)) {
+		if (m_game->lineOfSight(this, m_player).visible && !featureOverride(FeatureVisibility, m_player)) {
 			tmpPlayer = m_player;
 		}
 	}
@@ -436,12 +436,10 @@ void IsometricEnemy::worldStep()
 			if (!p || !p->isAlive() || p == tmpPlayer)
 				continue;
 
-			const RayCastInfo &info = rayCast(p->bodyPosition(), FixturePlayerBody);
+			const TiledLineOfSight::Result &los = m_game->lineOfSight(this, p);
 
-			for (const RayCastInfoItem &item : info) {
-				if (TiledObjectBody::fromShapeRef(item.shape) == p && item.visible && !featureOverride(FeatureVisibility, p))
-					pMap.insert(distanceToPointSq(item.point), p);
-			}
+			if (los.visible && !featureOverride(FeatureVisibility, p))
+				pMap.insert(distanceToPointSq(los.point), p);
 		}
 
 		for (auto it = pMap.constBegin(); it != pMap.constEnd() && !targetPlayer; ++it) {
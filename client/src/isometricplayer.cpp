@@ -175,18 +175,14 @@ private:
 				continue;
 			}
 
-			const RayCastInfo &map = m_player->rayCast(it->enemy->bodyPosition(), TiledObjectBody::FixtureEnemyBody);
+			const TiledLineOfSight::Result &los = m_player->game()->lineOfSight(m_player, it->enemy);
 
-			auto mapIt = std::find_if(map.cbegin(), map.cend(), [&it](const RayCastInfoItem &item){
-				return TiledObjectBody::fromShapeRef(item.shape) == it->enemy;
-			});
+			const bool inMap = los.hit;
 
-			const bool inMap = mapIt != map.cend();
-
-			it->flags.setFlag(Visible, inMap && mapIt->visible);
+			it->flags.setFlag(Visible, los.visible);
 
 			if (inMap) {
-				it->distance = m_player->distanceToPointSq(mapIt->point);
+				it->distance = m_player->distanceToPointSq(los.point);
 			} if (!inMap) {
 				it->flags.setFlag(CanHit, false);
 				it->flags.setFlag(CanShot, false);
@@ -500,7 +496,7 @@ void IsometricPlayer::onShapeContactBegin(cpShape *self, cpShape *other)
 	if (self == targetCircle() && enemyBody) {
 		d->setEnemyFlag(enemyBody, IsometricPlayerPrivate::Near);
 	} else if (isBodyShape(self) && enemy) {
-		if (rayCast(enemy->bodyPosition(), FixtureEnemyBody).isWalkable(enemy)) {
+		if (m_game->lineOfSight(this, enemy).walkable) {
 			if (d->setEnemyFlag(enemy, IsometricPlayerPrivate::CanHit)) {
 				onEnemyReached(enemy);
 			}
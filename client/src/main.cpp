@@ -57,8 +57,8 @@ int main(int argc, char *argv[])
 	app.commandLineParse();
 	app.initialize();
 
-	if (!app.performCommandLine())
-		return 0;
+	if (const auto &exitCode = app.performCommandLine())
+		return *exitCode;
 
 	return app.runSingleInstance();
 
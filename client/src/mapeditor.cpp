@@ -29,9 +29,11 @@
 #include "mapimage.h"
 #include "qimagereader.h"
 #include "question.h"
+#include "questionbenchmark.h"
 #include "abstractlevelgame.h"
 #include "utils_.h"
 #include <sstream>
+#include <QThreadPool>
 
 #ifdef Q_OS_WASM
 #include "onlineclient.h"
@@ -2808,6 +2810,40 @@ QString MapEditor::objectivePreview(const QString &objectiveModule, const QVaria
 
 
 
+/**
+ * @brief MapEditor::questionBenchmark
+ *
+ * A pálya összes feladatának legyártása háttérszálakon, az eredményt a questionBenchmarkFinished() jelzi
+ */
+
+void MapEditor::questionBenchmark()
+{
+	if (!m_map)
+		return;
+
+	std::unique_ptr<GameMap> map(GameMap::fromBinaryData(m_map->toBinaryData()));
+
+	if (!map) {
+		m_client->messageError(tr("Nem lehet létrehozni a pályát!"), tr("Belső hiba"));
+		return;
+	}
+
+	const std::vector<QuestionBenchmark::Job> jobs = QuestionBenchmark::jobs(map.get());
+
+	LOG_CDEBUG("client") << "Question benchmark started:" << jobs.size() << "objectives";
+
+	QThreadPool::globalInstance()->start([jobs, ptr = QPointer<MapEditor>(this)]() {
+		const QVariantList &list = QuestionBenchmark::toVariantList(QuestionBenchmark::run(jobs));
+
+		QMetaObject::invokeMethod(qApp, [ptr, list]() {
+			if (ptr)
+				emit ptr->questionBenchmarkFinished(list);
+		}, Qt::QueuedConnection);
+	});
+}
+
+
+
 
 
 /**
@@ -133,6 +133,7 @@ public:
 										 const int &toChapterId, const bool &isCopy, const QString &chapterName = QString());
 	Q_INVOKABLE QString objectivePreview(const QString &objectiveModule, const QVariantMap &objectiveData,
 										 const QString &storageModule, const QVariantMap &storageData) const;
+	Q_INVOKABLE void questionBenchmark();
 
 	Q_INVOKABLE MapEditorMissionLevel* missionLevelAdd(MapEditorMission *mission);
 	Q_INVOKABLE void missionLevelRemove(MapEditorMissionLevel *missionLevel);
@@ -183,6 +184,7 @@ signals:
 	void displayNameChanged();
 	void modifiedChanged();
 	void autoSavedChanged();
+	void questionBenchmarkFinished(const QVariantList &results);
 
 protected:
 	QString m_currentFileName;
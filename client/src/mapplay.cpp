@@ -177,12 +177,14 @@ void MapPlay::setGameMap(std::unique_ptr<GameMap> &newGameMap)
 	if (m_gameMap == newGameMap)
 		return;
 	m_gameMap = std::move(newGameMap);
+	m_questionTemplates.clear();
 	emit gameMapChanged();
 }
 
 void MapPlay::clearGameMap()
 {
 	m_gameMap.reset();
+	m_questionTemplates.clear();
 	emit gameMapChanged();
 }
 
@@ -528,6 +530,7 @@ bool MapPlay::play(MapPlayMissionLevel *level, const GameMap::GameMode &mode, co
 		return false;
 
 	g->setStorageSeed(m_storageSeed.get());
+	g->setQuestionTemplates(&m_questionTemplates);
 
 	connect(g, &AbstractGame::gameFinished, this, &MapPlay::onCurrentGameFinished);
 
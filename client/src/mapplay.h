@@ -152,6 +152,7 @@ protected:
 	std::unique_ptr<AbstractMapPlaySolver> m_solver;
 	std::unique_ptr<MapPlayMissionList> m_missionList;
 	std::unique_ptr<StorageSeed> m_storageSeed;
+	QuestionTemplateCache m_questionTemplates;
 	bool m_online = true;
 	GameState m_gameState = StateInvalid;
 	QJsonObject m_finishedData;
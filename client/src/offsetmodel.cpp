@@ -186,6 +186,7 @@ void OffsetModel::reload()
 	LOG_CTRACE("client") << "Reload";
 
 	m_offset = 0;
+	m_cursor = QJsonValue();
 	m_model->clear();
 	emit modelCleared();
 
@@ -215,6 +216,11 @@ void OffsetModel::fetch()
 	data[QStringLiteral("limit")] = m_limit;
 	data[QStringLiteral("offset")] = m_offset;
 
+	// Keyset pagination (if supported by the server)
+
+	if (m_cursor.isObject())
+		data[QStringLiteral("cursor")] = m_cursor;
+
 	client->send(m_api, m_path, data)
 			->error(client, &Client::onHttpConnectionError)
 			->error(this, [this](const QNetworkReply::NetworkError &){ m_fetchActive = false; })
@@ -263,6 +269,7 @@ void OffsetModel::loadFromJson(const QJsonObject &obj)
 	m_model->insert(m_model->count(), list);
 
 	m_offset = offset + list.size();
+	m_cursor = obj.value(QStringLiteral("cursor"));
 
 	if (limit > 0 && list.size() < limit)
 		setCanFetch(false);
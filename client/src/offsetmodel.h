@@ -111,6 +111,7 @@ private:
 
 	int m_limit = 50;
 	int m_offset = 0;
+	QJsonValue m_cursor;
 
 	bool m_fetchActive = false;
 };
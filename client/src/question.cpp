@@ -40,9 +40,10 @@
 
 
 
-Question::Question(StorageSeed *seed, GameMapObjective *objective)
+Question::Question(StorageSeed *seed, GameMapObjective *objective, QuestionTemplateCache *templates)
 	: m_objective (objective)
 	, m_seed(seed)
+	, m_templates(templates)
 {
 }
 
@@ -112,7 +113,24 @@ QVariantMap Question::generate() const
 	QVariantMap q;
 
 	if (m_objective->storage() && m_seed) {
-		QVariantList tmp = mi->generateAll(m_objective->data(), st, std, &m_objective->commonData(), m_seed);
+		// A storage-ot csak egyszer dolgozzuk fel, utána a sablonból gyártunk
+
+		std::shared_ptr<QuestionTemplate> tmpl;
+
+		if (m_templates) {
+			auto it = m_templates->find(m_objective->uuid());
+
+			if (it == m_templates->end())
+				it = m_templates->insert(m_objective->uuid(),
+										 std::shared_ptr<QuestionTemplate>(mi->compile(m_objective->data(), st, std,
+																					   &m_objective->commonData())));
+
+			tmpl = it.value();
+		}
+
+		QVariantList tmp = tmpl ?
+							   tmpl->generate(m_seed) :
+							   mi->generateAll(m_objective->data(), st, std, &m_objective->commonData(), m_seed);
 
 		if (tmp.isEmpty())
 			return QVariantMap();
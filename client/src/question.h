@@ -38,13 +38,21 @@
 #include <QString>
 #include <QVariantMap>
 #include "storageseed.h"
+#include <memory>
 
 class GameMapObjective;
+class QuestionTemplate;
+
+
+// A lefordított kérdéssablonok objective uuid szerint (nullptr: a modul nem készít sablont)
+
+typedef QHash<QString, std::shared_ptr<QuestionTemplate>> QuestionTemplateCache;
+
 
 class Question
 {
 public:
-	explicit Question(StorageSeed *seed, GameMapObjective *objective = nullptr);
+	explicit Question(StorageSeed *seed, GameMapObjective *objective = nullptr, QuestionTemplateCache *templates = nullptr);
 
 	bool isValid() const;
 	QString module() const;
@@ -76,6 +84,7 @@ public:
 private:
 	GameMapObjective *m_objective = nullptr;
 	StorageSeed *m_seed = nullptr;
+	QuestionTemplateCache *m_templates = nullptr;
 };
 
 Q_DECLARE_METATYPE(Question)
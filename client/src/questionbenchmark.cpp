@@ -0,0 +1,337 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * questionbenchmark.cpp
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * QuestionBenchmark
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "questionbenchmark.h"
+#include "application.h"
+#include "gamemap.h"
+#include "storageseed.h"
+#include "../modules/interfaces.h"
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QCborValue>
+#include <QSet>
+#include <QTextStream>
+#include <memory>
+
+
+#define BENCHMARK_SLOW_MSEC			20.0		// Ennél lassabb generálás gyanús
+#define BENCHMARK_MIN_DISTINCT		3			// Ennél kevesebb különböző kérdés kevés
+#define BENCHMARK_DUPLICATE_RATE	0.25		// Egy generáláson belül ennél több ismétlődés sok
+
+
+
+/**
+ * @brief questionKey
+ * @param question
+ * @return
+ *
+ * A kérdés azonosítója: a kérdés szövege, ennek hiányában a teljes tartalom
+ * (a válaszlehetőségek sorrendje véletlenszerű, ezért azt nem vesszük figyelembe)
+ */
+
+static QByteArray questionKey(const QVariantMap &question)
+{
+	if (const QString &q = question.value(QStringLiteral("question")).toString(); !q.isEmpty())
+		return q.toUtf8();
+
+	return QCborValue::fromVariant(question).toCbor();
+}
+
+
+
+
+/**
+ * @brief QuestionBenchmark::jobs
+ * @param map
+ * @return
+ */
+
+std::vector<QuestionBenchmark::Job> QuestionBenchmark::jobs(GameMap *map)
+{
+	std::vector<Job> list;
+
+	if (!map)
+		return list;
+
+	for (GameMapChapter *ch : map->chapters()) {
+		for (GameMapObjective *o : ch->objectives()) {
+			Job job;
+			job.chapter = ch->name();
+			job.uuid = o->uuid();
+			job.module = o->module();
+			job.data = o->data();
+
+			if (GameMapStorage *s = o->storage()) {
+				job.storageModule = s->module();
+				job.storageId = s->id();
+				job.storageData = s->data();
+			}
+
+			list.push_back(job);
+		}
+	}
+
+	return list;
+}
+
+
+
+/**
+ * @brief QuestionBenchmark::run
+ * @param jobs
+ * @param rounds
+ * @return
+ *
+ * A feladatokat a gépen elérhető összes szálon párhuzamosan gyártja le
+ * (a modulok generateAll() függvényei const-ok, nincs megosztott állapotuk)
+ */
+
+std::vector<QuestionBenchmark::Result> QuestionBenchmark::run(const std::vector<Job> &jobs, const int &rounds)
+{
+	std::vector<Result> results(jobs.size());
+
+	QThreadPool pool;
+
+	for (std::size_t i=0; i<jobs.size(); ++i) {
+		pool.start([&jobs, &results, i, rounds]() {
+			results[i] = run(jobs.at(i), rounds);
+		});
+	}
+
+	pool.waitForDone();
+
+	return results;
+}
+
+
+
+/**
+ * @brief QuestionBenchmark::run
+ * @param job
+ * @param rounds
+ * @return
+ */
+
+QuestionBenchmark::Result QuestionBenchmark::run(const Job &job, const int &rounds)
+{
+	Result result;
+	result.job = job;
+
+	ModuleInterface *objective = Application::instance()->objectiveModules().value(job.module, nullptr);
+	ModuleInterface *storage = nullptr;
+
+	if (!objective) {
+		result.warnings.append(QObject::tr("Érvénytelen modul: %1").arg(job.module));
+		return result;
+	}
+
+	if (!job.storageModule.isEmpty()) {
+		storage = Application::instance()->storageModules().value(job.storageModule, nullptr);
+
+		if (!storage) {
+			result.warnings.append(QObject::tr("Érvénytelen modul: %1").arg(job.storageModule));
+			return result;
+		}
+	}
+
+	QSet<QByteArray> distinct;
+	int duplicates = 0;
+	qint64 nsec = 0;
+
+	for (int i=0; i<rounds; ++i) {
+		QVariantMap commonData;
+		QElapsedTimer timer;
+		timer.start();
+
+		const QVariantList &list = objective->generateAll(job.data, storage, job.storageData, &commonData, nullptr);
+
+		nsec += timer.nsecsElapsed();
+
+		QSet<QByteArray> round;
+
+		for (const QVariant &v : list) {
+			const QByteArray &key = questionKey(v.toMap());
+
+			if (round.contains(key))
+				++duplicates;
+			else
+				round.insert(key);
+
+			distinct.insert(key);
+		}
+
+		result.questions += list.size();
+		++result.rounds;
+	}
+
+	result.msec = result.rounds > 0 ? (qreal) nsec / result.rounds / 1000000. : 0.;
+
+
+	// Játék közben: a sablont egyszer fordítjuk, utána kérdésenként seed-del generálunk
+
+	if (storage) {
+		StorageSeed seed;
+		seed.setCurrentMap(job.uuid);
+		seed.setCurrentStorage(job.storageId);
+
+		QVariantMap commonData;
+		QElapsedTimer timer;
+		timer.start();
+
+		const std::unique_ptr<QuestionTemplate> tmpl(objective->compile(job.data, storage, job.storageData, &commonData));
+
+		result.compileMsec = (qreal) timer.nsecsElapsed() / 1000000.;
+
+		qint64 seedNsec = 0;
+
+		for (int i=0; i<rounds; ++i) {
+			timer.restart();
+
+			const QVariantList &list = tmpl ? tmpl->generate(&seed) :
+											  objective->generateAll(job.data, storage, job.storageData, &commonData, &seed);
+
+			seedNsec += timer.nsecsElapsed();
+
+			if (!list.isEmpty())
+				seed.setData(list.first().toMap(), job.storageId);
+		}
+
+		result.seedMsec = rounds > 0 ? (qreal) seedNsec / rounds / 1000000. : 0.;
+	}
+
+	result.distinct = distinct.size();
+	result.duplicateRate = result.questions > 0 ? (qreal) duplicates / result.questions : 0.;
+
+	if (result.questions == 0)
+		result.warnings.append(QObject::tr("Nem készül kérdés"));
+	else if (result.distinct < BENCHMARK_MIN_DISTINCT)
+		result.warnings.append(QObject::tr("Kevés különböző kérdés (%1)").arg(result.distinct));
+
+	if (result.duplicateRate > BENCHMARK_DUPLICATE_RATE)
+		result.warnings.append(QObject::tr("Sok ismétlődés (%1%)").arg(qRound(result.duplicateRate*100.)));
+
+	if (result.msec > BENCHMARK_SLOW_MSEC)
+		result.warnings.append(QObject::tr("Lassú generálás (%1 ms)").arg(result.msec, 0, 'f', 1));
+
+	if (result.seedMsec > BENCHMARK_SLOW_MSEC)
+		result.warnings.append(QObject::tr("Lassú generálás játék közben (%1 ms)").arg(result.seedMsec, 0, 'f', 1));
+
+	return result;
+}
+
+
+
+/**
+ * @brief QuestionBenchmark::toVariantList
+ * @param results
+ * @return
+ */
+
+QVariantList QuestionBenchmark::toVariantList(const std::vector<Result> &results)
+{
+	QVariantList list;
+
+	for (const Result &r : results)
+		list.append(r.toVariantMap());
+
+	return list;
+}
+
+
+
+/**
+ * @brief QuestionBenchmark::report
+ * @param results
+ * @return
+ */
+
+QString QuestionBenchmark::report(const std::vector<Result> &results)
+{
+	QString txt;
+	QTextStream out(&txt);
+
+	qreal msec = 0.;
+	int warnings = 0;
+
+	for (const Result &r : results) {
+		out << QStringLiteral("%1 [%2] %3%4\n")
+			   .arg(r.job.chapter, r.job.uuid, r.job.module,
+					r.job.storageModule.isEmpty() ? QString() : QStringLiteral("/")+r.job.storageModule);
+
+		out << QStringLiteral("    %1 ms, %2 questions, %3 distinct, %4% duplicates\n")
+			   .arg(r.msec, 0, 'f', 2)
+			   .arg(r.questions)
+			   .arg(r.distinct)
+			   .arg(r.duplicateRate*100., 0, 'f', 1);
+
+		if (!r.job.storageModule.isEmpty())
+			out << QStringLiteral("    seeded: %1 ms compile, %2 ms/question\n")
+				   .arg(r.compileMsec, 0, 'f', 2)
+				   .arg(r.seedMsec, 0, 'f', 2);
+
+		for (const QString &w : r.warnings)
+			out << QStringLiteral("    ! ") << w << QStringLiteral("\n");
+
+		msec += r.msec;
+		if (!r.warnings.isEmpty())
+			++warnings;
+	}
+
+	out << QStringLiteral("%1 objectives, %2 with warnings, %3 ms total\n")
+		   .arg((int) results.size())
+		   .arg(warnings)
+		   .arg(msec, 0, 'f', 2);
+
+	out.flush();
+
+	return txt;
+}
+
+
+
+/**
+ * @brief QuestionBenchmark::Result::toVariantMap
+ * @return
+ */
+
+QVariantMap QuestionBenchmark::Result::toVariantMap() const
+{
+	return QVariantMap{
+		{ QStringLiteral("chapter"), job.chapter },
+		{ QStringLiteral("uuid"), job.uuid },
+		{ QStringLiteral("module"), job.module },
+		{ QStringLiteral("storageModule"), job.storageModule },
+		{ QStringLiteral("storageId"), job.storageId },
+		{ QStringLiteral("rounds"), rounds },
+		{ QStringLiteral("msec"), msec },
+		{ QStringLiteral("questions"), questions },
+		{ QStringLiteral("distinct"), distinct },
+		{ QStringLiteral("duplicateRate"), duplicateRate },
+		{ QStringLiteral("compileMsec"), compileMsec },
+		{ QStringLiteral("seedMsec"), seedMsec },
+		{ QStringLiteral("warnings"), warnings },
+	};
+}
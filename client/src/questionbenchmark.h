@@ -0,0 +1,82 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * questionbenchmark.h
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * QuestionBenchmark
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUESTIONBENCHMARK_H
+#define QUESTIONBENCHMARK_H
+
+#include <QVariantMap>
+#include <QStringList>
+#include <vector>
+
+class GameMap;
+
+
+/**
+ * @brief The QuestionBenchmark class
+ *
+ * A pálya összes feladatának legyártása (szálkészleten), mérés és ellenőrzés:
+ *  - generálási idő
+ *  - különböző kérdések száma
+ *  - ismétlődések aránya egy generáláson belül
+ *  - storage esetén a játék közbeni útvonal (sablon + seed) ideje
+ */
+
+class QuestionBenchmark
+{
+public:
+	struct Job {
+		QString chapter;
+		QString uuid;
+		QString module;
+		QString storageModule;
+		int storageId = -1;
+		QVariantMap data;
+		QVariantMap storageData;
+	};
+
+	struct Result {
+		Job job;
+		int rounds = 0;
+		qreal msec = 0.;				// egy generálás átlagos ideje
+		int questions = 0;				// összes legyártott kérdés
+		int distinct = 0;				// különböző kérdések (az összes körben)
+		qreal duplicateRate = 0.;		// ismétlődések aránya egy generáláson belül
+		qreal compileMsec = 0.;			// a sablon fordításának ideje (seed-es útvonal)
+		qreal seedMsec = 0.;			// egy kérdés átlagos ideje játék közben (sablonból, seed-del)
+		QStringList warnings;
+
+		QVariantMap toVariantMap() const;
+	};
+
+	static std::vector<Job> jobs(GameMap *map);
+	static std::vector<Result> run(const std::vector<Job> &jobs, const int &rounds = 10);
+	static Result run(const Job &job, const int &rounds = 10);
+
+	static QVariantList toVariantList(const std::vector<Result> &results);
+	static QString report(const std::vector<Result> &results);
+};
+
+#endif // QUESTIONBENCHMARK_H
@@ -219,16 +219,27 @@ void RpgControlGate::onShapeContactEnd(cpShape *self, cpShape *other)
 
 void RpgControlGate::onCurrentStateChanged()
 {
+	cpBB bb = cpBBNew(0, 0, 0, 0);
+	bool hasBB = false;
+
 	for (const auto &[st, list] : m_groundList.asKeyValueRange()) {
 		for (TiledObjectBody *o : list) {
 			o->filterSet(m_currentState == st && st == RpgGameData::ControlGate::GateClose ?
 							 TiledObjectBody::FixtureGround :
 							 TiledObjectBody::FixtureInvalid
 							 );
+
+			for (cpShape *shape : o->bodyShapes()) {
+				bb = hasBB ? cpBBMerge(bb, cpShapeGetBB(shape)) : cpShapeGetBB(shape);
+				hasBB = true;
+			}
 		}
 	}
 
-	m_game->reloadTcodMap(m_scene);
+	// Only the chunks covered by the gate grounds have to be updated
+
+	if (hasBB)
+		m_game->updateTcodMap(m_scene, bb);
 }
 
 
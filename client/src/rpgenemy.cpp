@@ -666,7 +666,7 @@ bool RpgEnemy::isWatchingPlayer(RpgPlayer *player) const
 	if (!player || !player->isAlive() || player->isLocked() || !m_contactedPlayers.contains(player))
 		return false;
 
-	if (rayCast(player->bodyPosition(), FixturePlayerBody).isVisible(player) && !featureOverride(FeatureVisibility, player))
+	if (m_game->lineOfSight(this, player).visible && !featureOverride(FeatureVisibility, player))
 		return true;
 
 	return false;
@@ -258,6 +258,17 @@ bool RpgGame::load(const RpgGameDefinition &def, const int &playerCount)
 
 
 
+	// Decode enemy textures in parallel
+
+	QStringList texturePaths;
+
+	for (const auto &e : std::as_const(m_enemyDataList))
+		texturePaths.append(QStringLiteral(":/enemy/%1/texture.png").arg(RpgEnemyIface::directoryBaseName(e.type, e.subtype)));
+
+	texturePaths.removeDuplicates();
+	preloadTextures(texturePaths);
+
+
 	for (auto &e : m_enemyDataList) {
 		Q_ASSERT(!e.motor.path.isEmpty());
 
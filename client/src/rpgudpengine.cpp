@@ -31,6 +31,10 @@
 #include "server.h"
 
 
+#define SERVICE_INTERVAL_PLAY				4			// ENet service timeout játék közben (ms)
+#define SERVICE_INTERVAL_IDLE				50			// ENet service timeout egyébként (ms)
+
+
 
 /**
  * @brief RpgUdpEngine::~RpgUdpEngine
@@ -507,6 +511,15 @@ const RpgConfig::GameState &RpgUdpEngine::gameState() const
 
 void RpgUdpEngine::setGameState(const RpgConfig::GameState &newGameState)
 {
+	if (m_gameState != newGameState) {
+		setServiceInterval(newGameState == RpgConfig::StatePlay ? SERVICE_INTERVAL_PLAY : SERVICE_INTERVAL_IDLE);
+
+#ifndef Q_OS_WASM
+		QMutexLocker locker(&m_snapshotMutex);
+#endif
+		m_jitterBuffer.reset();
+	}
+
 	m_gameState = newGameState;
 }
 
@@ -568,7 +581,22 @@ RpgGameData::FullSnapshot RpgUdpEngine::getNextFullSnapshot(const qint64 &tick)
 #ifndef Q_OS_WASM
 	QMutexLocker locker(&m_snapshotMutex);
 #endif
-	return m_snapshots.getNextFullSnapshot(tick);
+	return m_snapshots.getNextFullSnapshot(m_jitterBuffer.renderTick(tick));
+}
+
+
+
+/**
+ * @brief RpgUdpEngine::jitterStatistics
+ * @return
+ */
+
+RpgJitterBuffer::Statistics RpgUdpEngine::jitterStatistics()
+{
+#ifndef Q_OS_WASM
+	QMutexLocker locker(&m_snapshotMutex);
+#endif
+	return m_jitterBuffer.statistics();
 }
 
 
@@ -657,6 +685,7 @@ void RpgUdpEngine::binaryDataReceived(const QList<QPair<QByteArray, unsigned int
 				QMutexLocker locker(&m_snapshotMutex);
 #endif
 				m_snapshots.setServerTick(tick);
+				m_jitterBuffer.packetArrived(tick, m_game->latency());
 			}
 
 			if (const qint64 tick = cbor.value(QStringLiteral("d")).toInteger(-1); tick > -1) {
@@ -1093,6 +1122,103 @@ bool ClientStorage::hasSnapshot()
 
 
 
+/**
+ * @brief ClientStorage::hasLifecycleEvent
+ * @return
+ *
+ * Vannak-e olyan események (támadás, vezérlő használata, lövedék létrehozása/megszűnése, halál),
+ * amiknek mindenképpen meg kell érkezniük a szerverre.
+ * Csak az utoljára elküldött snapshothoz képesti változás számít (állapotváltás vagy HP változás),
+ * egy tartós állapot (pl. halott játékos) nem tesz minden csomagot megbízhatóvá.
+ */
+
+bool ClientStorage::hasLifecycleEvent() const
+{
+	if (hasTransition(m_players, m_sentPlayers, [](const SentState *prev, const RpgGameData::Player &p) {
+		const bool event = p.st != RpgGameData::Player::PlayerIdle && p.st != RpgGameData::Player::PlayerMoving;
+		return prev ? ((prev->st != p.st && event) || prev->hp != p.hp) : (event || p.hp <= 0);
+	}))
+		return true;
+
+	if (hasTransition(m_enemies, m_sentEnemies, [](const SentState *prev, const RpgGameData::Enemy &e) {
+		const bool event = e.st != RpgGameData::Enemy::EnemyIdle && e.st != RpgGameData::Enemy::EnemyMoving;
+		return prev ? ((prev->st != e.st && event) || prev->hp != e.hp) : (event || e.hp <= 0);
+	}))
+		return true;
+
+	if (hasTransition(m_bullets, m_sentBullets, [](const SentState *prev, const RpgGameData::Bullet &b) {
+		return b.st != RpgGameData::LifeCycle::StageLive && (!prev || prev->st != b.st);
+	}))
+		return true;
+
+	return false;
+}
+
+
+
+/**
+ * @brief ClientStorage::hasTransition
+ * @param list
+ * @param sent
+ * @param isEvent
+ * @return
+ */
+
+template<typename T, typename T2, typename F>
+bool ClientStorage::hasTransition(const RpgGameData::SnapshotList<T, T2> &list, const SentStateMap &sent, F isEvent)
+{
+	for (const auto &ptr : list) {
+		std::optional<SentState> prev;
+
+		if (const auto it = sent.find(sentKey(ptr.data)); it != sent.cend())
+			prev = it->second;
+
+		for (const auto &l : ptr.list) {
+			if (isEvent(prev ? &prev.value() : nullptr, l.second))
+				return true;
+
+			if constexpr (std::is_same_v<T, RpgGameData::Bullet>)
+				prev = SentState{ .st = l.second.st, .hp = 0 };
+			else
+				prev = SentState{ .st = l.second.st, .hp = l.second.hp };
+		}
+	}
+
+	return false;
+}
+
+
+
+/**
+ * @brief ClientStorage::updateSentState
+ * @param list
+ * @param sent
+ */
+
+template<typename T, typename T2>
+void ClientStorage::updateSentState(const RpgGameData::SnapshotList<T, T2> &list, SentStateMap *sent)
+{
+	Q_ASSERT(sent);
+
+	for (const auto &ptr : list) {
+		if (ptr.list.empty())
+			continue;
+
+		const T &last = ptr.list.crbegin()->second;
+
+		if constexpr (std::is_same_v<T, RpgGameData::Bullet>) {
+			if (last.st == RpgGameData::LifeCycle::StageDestroy)
+				sent->erase(sentKey(ptr.data));
+			else
+				sent->insert_or_assign(sentKey(ptr.data), SentState{ .st = last.st, .hp = 0 });
+		} else {
+			sent->insert_or_assign(sentKey(ptr.data), SentState{ .st = last.st, .hp = last.hp });
+		}
+	}
+}
+
+
+
 /**
  * @brief ClientStorage::renderCurrentSnapshot
  * @return
@@ -1103,6 +1229,10 @@ RpgGameData::CurrentSnapshot ClientStorage::renderCurrentSnapshot()
 	RpgGameData::CurrentSnapshot snapshot = getCurrentSnapshot();
 	updateLastTick(snapshot);
 
+	updateSentState(snapshot.players, &m_sentPlayers);
+	updateSentState(snapshot.enemies, &m_sentEnemies);
+	updateSentState(snapshot.bullets, &m_sentBullets);
+
 	return snapshot;
 }
 
@@ -1231,3 +1361,96 @@ QByteArray ClientStorage::dump()
 }
 
 
+
+
+
+
+/**
+ * @brief RpgJitterBuffer::packetArrived
+ * @param serverTick
+ * @param latency
+ */
+
+void RpgJitterBuffer::packetArrived(const qint64 &serverTick, const qint64 &latency)
+{
+	if (serverTick < 0)
+		return;
+
+	if (!m_timer.isValid())
+		m_timer.start();
+
+	const qint64 transit = m_timer.elapsed() - (serverTick*1000/60);
+
+	if (m_lastServerTick >= 0 && serverTick > m_lastServerTick) {
+		const float d = std::abs(transit - m_lastTransit);
+
+		// RFC 3550 szerinti jitter becslés
+
+		m_statistics.jitter += (d - m_statistics.jitter)/16.;
+		m_gap += ((float) (serverTick - m_lastServerTick) - m_gap)/16.;
+	}
+
+	if (m_lastRendered >= 0 && serverTick < m_lastRendered)
+		++m_statistics.latePackets;
+
+	m_lastTransit = transit;
+	m_lastServerTick = std::max(m_lastServerTick, serverTick);
+
+	const qint64 target = AbstractGame::TickTimer::msecToTick(latency + 2*m_statistics.jitter) + 1 + std::ceil(m_gap);
+
+	m_statistics.targetDelay = std::clamp<qint64>(target, minDelay, maxDelay);
+}
+
+
+
+/**
+ * @brief RpgJitterBuffer::renderTick
+ * @param tick
+ * @return
+ *
+ * A SnapshotStorage a kapott tickből vonja le az RPG_UDP_DELTA_TICK értéket,
+ * ezért a saját késleltetésünket erre korrigálva adjuk vissza
+ */
+
+qint64 RpgJitterBuffer::renderTick(const qint64 &tick)
+{
+	float &delay = m_statistics.delay;
+
+	delay += std::clamp((float) m_statistics.targetDelay - delay, -dilation, dilation);
+
+	qint64 current = tick - std::lround(delay);
+
+	if (m_lastServerTick >= 0) {
+		if (current > m_lastServerTick)
+			++m_statistics.extrapolatedFrames;
+
+		current = std::min(current, m_lastServerTick + maxExtrapolation);
+
+		m_statistics.bufferDepth = std::max<qint64>(0, m_lastServerTick - current);
+	}
+
+	// Ne menjünk visszafelé (kivéve az időugrást)
+
+	if (current < m_lastRendered && m_lastRendered - current <= maxDelay)
+		current = m_lastRendered;
+
+	m_lastRendered = current;
+
+	return current + RPG_UDP_DELTA_TICK;
+}
+
+
+
+/**
+ * @brief RpgJitterBuffer::reset
+ */
+
+void RpgJitterBuffer::reset()
+{
+	m_timer.invalidate();
+	m_lastServerTick = -1;
+	m_lastTransit = 0;
+	m_lastRendered = -1;
+	m_gap = 1.;
+	m_statistics = Statistics();
+}
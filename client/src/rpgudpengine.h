@@ -94,6 +94,7 @@ public:
 
 
 	bool hasSnapshot();
+	bool hasLifecycleEvent() const;
 
 	RpgGameData::CurrentSnapshot renderCurrentSnapshot();
 
@@ -135,6 +136,27 @@ private:
 
 	qint64 m_serverTick = -1;
 	qint64 m_deadlineTick = -1;
+
+	// Az utoljára elküldött állapot és HP objektumonként (o, s, id), ehhez képest keressük az eseményeket
+
+	struct SentState {
+		int st = -1;
+		int hp = 0;
+	};
+
+	typedef std::map<std::tuple<int, int, int>, SentState> SentStateMap;
+
+	template <typename T, typename T2, typename F>
+	static bool hasTransition(const RpgGameData::SnapshotList<T, T2> &list, const SentStateMap &sent, F isEvent);
+
+	template <typename T, typename T2>
+	static void updateSentState(const RpgGameData::SnapshotList<T, T2> &list, SentStateMap *sent);
+
+	static std::tuple<int, int, int> sentKey(const RpgGameData::BaseData &data) { return {data.o, data.s, data.id}; }
+
+	SentStateMap m_sentPlayers;
+	SentStateMap m_sentEnemies;
+	SentStateMap m_sentBullets;
 };
 
 
@@ -259,6 +281,56 @@ class ActionRpgMultiplayerGame;
 class Server;
 
 
+/**
+ * @brief The RpgJitterBuffer class
+ *
+ * Adaptive render delay for remote bodies: the delay follows the measured latency and
+ * inter-arrival jitter, changes smoothly (time dilation) and limits the extrapolation
+ */
+
+class RpgJitterBuffer
+{
+public:
+	RpgJitterBuffer() = default;
+
+	void packetArrived(const qint64 &serverTick, const qint64 &latency);
+	qint64 renderTick(const qint64 &tick);
+	void reset();
+
+
+	/**
+	 * @brief The Statistics class
+	 */
+
+	struct Statistics {
+		int bufferDepth = 0;				// ennyi tick van a renderelés előtt a pufferben
+		int latePackets = 0;				// már lerenderelt tickre érkezett csomag
+		int extrapolatedFrames = 0;			// utolsó snapshot utáni (extrapolált) frame
+		float jitter = 0.;					// érkezési szórás (ms)
+		float delay = RPG_UDP_DELTA_TICK;	// aktuális késleltetés (tick)
+		int targetDelay = RPG_UDP_DELTA_TICK;
+	};
+
+	const Statistics &statistics() const { return m_statistics; }
+
+	inline static constexpr int minDelay = RPG_UDP_DELTA_TICK/2;
+	inline static constexpr int maxDelay = 4*RPG_UDP_DELTA_TICK;
+	inline static constexpr int maxExtrapolation = RPG_UDP_DELTA_TICK;		// ennyi tickkel az utolsó snapshot után megállunk
+	inline static constexpr float dilation = 0.05;							// legfeljebb ennyivel változik a késleltetés tickenként
+
+private:
+	QElapsedTimer m_timer;
+	qint64 m_lastServerTick = -1;
+	qint64 m_lastTransit = 0;
+	qint64 m_lastRendered = -1;
+	float m_gap = 1.;
+
+	Statistics m_statistics;
+};
+
+
+
+
 /**
  * @brief The UdpEnginePrivate class
  */
@@ -283,6 +355,7 @@ public:
 	RpgGameData::FullSnapshot getFullSnapshot(const qint64 &tick, const bool &findLast = false);
 	RpgGameData::FullSnapshot getNextFullSnapshot(const qint64 &tick);
 	RpgGameData::CurrentSnapshot getCurrentSnapshot();
+	RpgJitterBuffer::Statistics jitterStatistics();
 	QList<RpgGameData::Message> takeMessageList();
 
 	const RpgGameData::GameConfig &gameConfig() const;
@@ -332,6 +405,7 @@ private:
 
 	QList<RpgGameData::CharacterSelect> m_playerData;
 	ClientStorage m_snapshots;
+	RpgJitterBuffer m_jitterBuffer;
 	QList<RpgGameData::Message> m_messageList;
 
 	RpgGameData::GameConfig m_gameConfig;
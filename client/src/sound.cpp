@@ -33,11 +33,11 @@
  */
 
 #include "sound.h"
+#include "tiledprofiler.h"
 #include <QSettings>
 #include <Logger.h>
 #include <QFile>
-#include <QTemporaryFile>
-#include <QDir>
+#include <QResource>
 
 #if !defined(Q_OS_IOS) && !defined(Q_OS_MACOS)
 #define MINIAUDIO_IMPLEMENTATION
@@ -46,6 +46,194 @@
 #include "miniaudio.h"
 
 
+#define SOUND_CACHE_SIZE		(16*1024*1024)			// Ennyi dekódolt sfx maradhat a memóriában
+#define SOUND_SFX_VOICES		24						// Egyszerre ennyi sfx szólhat
+#define SOUND_SFX_MIN_VOLUME	0.05					// Ennél halkabb (távoli) sfx-et nem indítunk el
+#define SOUND_FRAME_MSEC		16						// Ezen belül az azonos sfx-eket összevonjuk
+
+
+
+/**
+ * VFS for miniaudio: read the audio files directly from the resource memory (or from mapped files)
+ */
+
+namespace SoundVfs {
+
+struct File {
+	const uchar *data = nullptr;
+	qint64 size = 0;
+	qint64 pos = 0;
+	QByteArray buffer;							// tömörített resource vagy nem mapelhető fájl
+	std::unique_ptr<QFile> file;
+};
+
+
+static ma_result open(const QString &path, ma_uint32 openMode, ma_vfs_file *pFile)
+{
+	if (!pFile)
+		return MA_INVALID_ARGS;
+
+	*pFile = nullptr;
+
+	if (openMode & MA_OPEN_MODE_WRITE)
+		return MA_ACCESS_DENIED;
+
+	auto f = std::make_unique<File>();
+
+	if (path.startsWith(QStringLiteral(":/"))) {
+		QResource res(path);
+
+		if (!res.isValid())
+			return MA_DOES_NOT_EXIST;
+
+		if (res.compressionAlgorithm() == QResource::NoCompression) {
+			f->data = res.data();
+			f->size = res.size();
+		} else {
+			f->buffer = res.uncompressedData();
+			f->data = reinterpret_cast<const uchar*>(f->buffer.constData());
+			f->size = f->buffer.size();
+		}
+	} else {
+		f->file = std::make_unique<QFile>(path);
+
+		if (!f->file->open(QIODevice::ReadOnly))
+			return MA_DOES_NOT_EXIST;
+
+		f->size = f->file->size();
+		f->data = f->file->map(0, f->size);
+
+		if (!f->data) {
+			f->buffer = f->file->readAll();
+			f->data = reinterpret_cast<const uchar*>(f->buffer.constData());
+			f->size = f->buffer.size();
+		}
+	}
+
+	*pFile = f.release();
+
+	return MA_SUCCESS;
+}
+
+
+static ma_result onOpen(ma_vfs *, const char *pFilePath, ma_uint32 openMode, ma_vfs_file *pFile)
+{
+	if (!pFilePath)
+		return MA_INVALID_ARGS;
+
+	return open(QString::fromUtf8(pFilePath), openMode, pFile);
+}
+
+
+static ma_result onOpenW(ma_vfs *, const wchar_t *pFilePath, ma_uint32 openMode, ma_vfs_file *pFile)
+{
+	if (!pFilePath)
+		return MA_INVALID_ARGS;
+
+	return open(QString::fromWCharArray(pFilePath), openMode, pFile);
+}
+
+
+static ma_result onClose(ma_vfs *, ma_vfs_file file)
+{
+	delete static_cast<File*>(file);
+	return MA_SUCCESS;
+}
+
+
+static ma_result onRead(ma_vfs *, ma_vfs_file file, void *pDst, size_t sizeInBytes, size_t *pBytesRead)
+{
+	File *f = static_cast<File*>(file);
+
+	if (!f || !pDst)
+		return MA_INVALID_ARGS;
+
+	const size_t size = std::min<qint64>(sizeInBytes, std::max<qint64>(0, f->size - f->pos));
+
+	if (size > 0)
+		memcpy(pDst, f->data + f->pos, size);
+
+	f->pos += size;
+
+	if (pBytesRead)
+		*pBytesRead = size;
+
+	return (size == 0 && sizeInBytes > 0) ? MA_AT_END : MA_SUCCESS;
+}
+
+
+static ma_result onWrite(ma_vfs *, ma_vfs_file, const void *, size_t, size_t *)
+{
+	return MA_ACCESS_DENIED;
+}
+
+
+static ma_result onSeek(ma_vfs *, ma_vfs_file file, ma_int64 offset, ma_seek_origin origin)
+{
+	File *f = static_cast<File*>(file);
+
+	if (!f)
+		return MA_INVALID_ARGS;
+
+	qint64 pos = offset;
+
+	if (origin == ma_seek_origin_current)
+		pos += f->pos;
+	else if (origin == ma_seek_origin_end)
+		pos += f->size;
+
+	if (pos < 0 || pos > f->size)
+		return MA_BAD_SEEK;
+
+	f->pos = pos;
+
+	return MA_SUCCESS;
+}
+
+
+static ma_result onTell(ma_vfs *, ma_vfs_file file, ma_int64 *pCursor)
+{
+	File *f = static_cast<File*>(file);
+
+	if (!f || !pCursor)
+		return MA_INVALID_ARGS;
+
+	*pCursor = f->pos;
+
+	return MA_SUCCESS;
+}
+
+
+static ma_result onInfo(ma_vfs *, ma_vfs_file file, ma_file_info *pInfo)
+{
+	File *f = static_cast<File*>(file);
+
+	if (!f || !pInfo)
+		return MA_INVALID_ARGS;
+
+	pInfo->sizeInBytes = f->size;
+
+	return MA_SUCCESS;
+}
+
+
+static ma_vfs_callbacks callbacks()
+{
+	ma_vfs_callbacks cb{};
+	cb.onOpen = &onOpen;
+	cb.onOpenW = &onOpenW;
+	cb.onClose = &onClose;
+	cb.onRead = &onRead;
+	cb.onWrite = &onWrite;
+	cb.onSeek = &onSeek;
+	cb.onTell = &onTell;
+	cb.onInfo = &onInfo;
+	return cb;
+}
+
+}
+
+
 /**
  * @brief Sound::Sound
  * @param parent
@@ -69,9 +257,6 @@ Sound::Sound(QObject *parent)
 
 	engineCheck();
 
-	m_garbageTimer.setInterval(500);
-	connect(&m_garbageTimer, &QTimer::timeout, this, &Sound::garbage);
-
 	m_clearTimer.setInterval(10000);
 	connect(&m_clearTimer, &QTimer::timeout, this, &Sound::clearUnusedSounds);
 	m_clearTimer.start();
@@ -149,6 +334,8 @@ void Sound::externalSoundRemove(ExternalSound *sound)
 
 void Sound::playSound(const QString &source, const ChannelType &channel, const float &volume)
 {
+	TILED_PROFILE_SCOPE("Sound::playSound");
+
 	LOG_CDEBUG("sound") << "Play sound" << qPrintable(source) << channel;
 
 	QMutexLocker locker(&m_mutex);
@@ -163,16 +350,11 @@ void Sound::playSound(const QString &source, const ChannelType &channel, const f
 	}
 
 
-	auto it = m_sound.begin();
+	const quint64 key = soundKey(soundId(source), channel);
 
-	for ( ; it != m_sound.end(); ++it) {
-		if (it->get()->path() == source && it->get()->channel() == channel)
-			break;
-	}
+	MaSound *sndObj = m_soundIndex.value(key, nullptr);
 
-	MaSound *sndObj = nullptr;
-
-	if (it == m_sound.end()) {
+	if (!sndObj) {
 		ma_sound_group *group = nullptr;
 		switch (channel) {
 			case SfxChannel: group = m_groupSfx.get(); break;
@@ -183,6 +365,7 @@ void Sound::playSound(const QString &source, const ChannelType &channel, const f
 
 		const auto &ptr = m_sound.emplace_back(new MaSound(m_engine.get(), source, channel, group));
 		sndObj = ptr.get();
+		m_soundIndex.insert(key, sndObj);
 
 		//updateVolumes();	// Bug?
 
@@ -193,8 +376,6 @@ void Sound::playSound(const QString &source, const ChannelType &channel, const f
 					obj->playNextVoiceOver();
 			}, this);
 		}
-	} else {
-		sndObj = it->get();
 	}
 
 	if (!sndObj) {
@@ -221,6 +402,19 @@ void Sound::stopSound(const QString &source, const ChannelType &channel)
 {
 	LOG_CDEBUG("sound") << "Stop sound" << qPrintable(source) << channel;
 
+	QMutexLocker locker(&m_mutex);
+
+	if (channel == SfxChannel) {
+		for (Voice &v : m_sfxVoices) {
+			if (!v.sound || !v.source || (!source.isEmpty() && v.source->path() != source))
+				continue;
+
+			ma_sound_stop(v.sound.get());
+		}
+
+		return;
+	}
+
 	for (auto &ptr : m_sound) {
 		if (!ptr->sound() || !ma_sound_is_playing(ptr->sound()))
 			continue;
@@ -301,16 +495,50 @@ void Sound::clearUnusedSounds()
 
 	QMutexLocker locker(&m_mutex);
 
+	// A streamelt hangokat töröljük, a dekódolt sfx-ek közül a legrégebben használtakat,
+	// ha túllépjük a SOUND_CACHE_SIZE méretet
+
+	std::vector<MaSound*> cached;
+	qint64 size = 0;
+
 	for (auto it = m_sound.begin(); it != m_sound.end(); ) {
-		if (MaSound *s = it->get()) {
-			if (ma_sound_is_playing(s->sound()) || m_queue.contains(s)) {
+		if (MaSound *s = it->get(); s && s->sound()) {
+			if (ma_sound_is_playing(s->sound()) || isVoicePlaying(s) || m_queue.contains(s)) {
+				size += s->pcmSize();
+				++it;
+				continue;
+			}
+
+			if (s->channel() == SfxChannel) {
+				size += s->pcmSize();
+				cached.push_back(s);
 				++it;
 				continue;
 			}
 		}
 
+		removeSound(it->get());
 		it = m_sound.erase(it);
 	}
+
+	if (size <= SOUND_CACHE_SIZE)
+		return;
+
+	std::sort(cached.begin(), cached.end(), [](MaSound *s1, MaSound *s2) {
+		return s1->lastUsed() > s2->lastUsed();
+	});
+
+	for (MaSound *s : cached) {
+		if (size <= SOUND_CACHE_SIZE)
+			break;
+
+		size -= s->pcmSize();
+
+		LOG_CTRACE("sound") << "Remove cached sound" << qPrintable(s->path());
+
+		removeSound(s);
+		std::erase_if(m_sound, [s](const auto &ptr) { return ptr.get() == s; });
+	}
 }
 
 
@@ -439,7 +667,12 @@ bool Sound::engineInit()
 
 	m_engine = std::make_unique<ma_engine>();
 
-	if (auto r = ma_engine_init(NULL, m_engine.get()); r != MA_SUCCESS) {
+	m_vfs = SoundVfs::callbacks();
+
+	ma_engine_config config = ma_engine_config_init();
+	config.pResourceManagerVFS = &m_vfs;
+
+	if (auto r = ma_engine_init(&config, m_engine.get()); r != MA_SUCCESS) {
 		LOG_CERROR("sound") << "Engine init failed:" << r;
 		m_engine.reset();
 		return false;
@@ -456,7 +689,7 @@ bool Sound::engineInit()
 
 	updateVolumes();
 
-	m_garbageTimer.start();
+	m_sfxVoices.resize(SOUND_SFX_VOICES);
 
 	return true;
 }
@@ -477,7 +710,11 @@ bool Sound::engineUninit()
 	LOG_CTRACE("sound") << "Clear playlist queue";
 
 	m_queue.clear();
-	m_garbageTimer.stop();
+
+	LOG_CTRACE("sound") << "Delete sfx voices";
+
+	releaseVoices(nullptr);
+	m_sfxVoices.clear();
 
 	LOG_CTRACE("sound") << "Delete sounds";
 
@@ -489,6 +726,7 @@ bool Sound::engineUninit()
 	}
 
 	m_sound.clear();
+	m_soundIndex.clear();
 
 
 	LOG_CTRACE("sound") << "Delete external sounds";
@@ -568,6 +806,8 @@ void Sound::playSound(MaSound *sound, const float &volume)
 		return;
 	}
 
+	sound->setUsed();
+
 	if (sound->channel() == MusicChannel) {
 		bool isActive = false;
 
@@ -617,20 +857,7 @@ void Sound::playSound(MaSound *sound, const float &volume)
 		}
 
 	} else if (sound->channel() == SfxChannel) {
-		if (ma_sound_is_playing(sound->sound())) {
-			//LOG_CTRACE("sound") << "Duplicate playing sfx:" << qPrintable(sound->path()) << "volume:" << volume;
-
-			auto snd = sound->duplicate(m_groupSfx.get());
-
-			if (snd) {
-				ma_sound_set_volume(snd, volume);
-				ma_sound_start(snd);
-			}
-		} else {
-			//LOG_CTRACE("sound") << "Start playing sfx:" << qPrintable(sound->path()) << "volume:" << volume;
-			ma_sound_set_volume(sound->sound(), volume);
-			ma_sound_start(sound->sound());
-		}
+		playVoice(sound, volume);
 	} else if (sound->channel() == VoiceoverChannel) {
 		QMutexLocker locker(&m_mutex);
 		m_queue.append(sound);
@@ -708,17 +935,182 @@ void Sound::updateVolumes()
 
 
 /**
- * @brief Sound::garbage
+ * @brief Sound::playVoice
+ * @param sound
+ * @param volume
+ *
+ * Az sfx-ek egy fix méretű hangpoolból szólnak. A hangerő (a távolsággal már csillapítva) a prioritás:
+ *  - a túl halk hangokat el sem indítjuk
+ *  - az egy frame-en belül többször kért azonos hangot csak egyszer indítjuk (a nagyobb hangerővel)
+ *  - ha nincs szabad hang, a leghalkabbat (ha halkabb az újnál) elvesszük
  */
 
-void Sound::garbage()
+void Sound::playVoice(MaSound *sound, const float &volume)
 {
-	QMutexLocker locker(&m_mutex);
+	if (volume < SOUND_SFX_MIN_VOLUME || m_sfxVoices.empty())
+		return;
 
-	for (const auto &ptr : m_sound) {
-		if (ptr)
-			ptr->garbage();
+	if (!m_frameTimer.isValid() || m_frameTimer.elapsed() > SOUND_FRAME_MSEC) {
+		m_frameVoices.clear();
+		m_frameTimer.start();
+	}
+
+	if (const auto it = m_frameVoices.constFind(sound); it != m_frameVoices.constEnd()) {
+		Voice &v = m_sfxVoices[*it];
+
+		if (v.source == sound && v.sound && volume > v.priority) {
+			v.priority = volume;
+			ma_sound_set_volume(v.sound.get(), volume);
+		}
+
+		return;
+	}
+
+	int index = -1;
+	int lowest = -1;
+
+	for (int i=0; i<(int) m_sfxVoices.size(); ++i) {
+		const Voice &v = m_sfxVoices[i];
+
+		if (!v.sound || !ma_sound_is_playing(v.sound.get())) {
+			// A szabad hangok közül azt választjuk, amelyik már ezt a hangot tartalmazza
+
+			if (index == -1 || v.source == sound)
+				index = i;
+
+			if (v.source == sound)
+				break;
+
+			continue;
+		}
+
+		if (lowest == -1 || v.priority < m_sfxVoices[lowest].priority)
+			lowest = i;
+	}
+
+	if (index == -1) {
+		if (lowest == -1 || m_sfxVoices[lowest].priority >= volume) {
+			LOG_CTRACE("sound") << "Sfx voice culled" << qPrintable(sound->path()) << volume;
+			return;
+		}
+
+		LOG_CTRACE("sound") << "Steal sfx voice" << lowest << "for" << qPrintable(sound->path());
+
+		index = lowest;
+		ma_sound_stop(m_sfxVoices[index].sound.get());
 	}
+
+	Voice &v = m_sfxVoices[index];
+
+	if (v.source != sound || !v.sound) {
+		if (v.sound)
+			ma_sound_uninit(v.sound.get());
+		else
+			v.sound = std::make_unique<ma_sound>();
+
+		v.source = nullptr;
+
+		if (auto r = ma_sound_init_copy(m_engine.get(), sound->sound(), 0, m_groupSfx.get(), v.sound.get()); r != MA_SUCCESS) {
+			LOG_CERROR("sound") << "Sfx voice init error" << qPrintable(sound->path()) << r;
+			v.sound.reset();
+			return;
+		}
+
+		v.source = sound;
+	}
+
+	v.priority = volume;
+
+	ma_sound_seek_to_pcm_frame(v.sound.get(), 0);
+	ma_sound_set_volume(v.sound.get(), volume);
+	ma_sound_start(v.sound.get());
+
+	m_frameVoices.insert(sound, index);
+}
+
+
+
+/**
+ * @brief Sound::isVoicePlaying
+ * @param sound
+ * @return
+ */
+
+bool Sound::isVoicePlaying(MaSound *sound) const
+{
+	for (const Voice &v : m_sfxVoices) {
+		if (v.source == sound && v.sound && ma_sound_is_playing(v.sound.get()))
+			return true;
+	}
+
+	return false;
+}
+
+
+
+/**
+ * @brief Sound::releaseVoices
+ * @param sound
+ *
+ * A sound hangjait felszabadítja (nullptr esetén az összeset)
+ */
+
+void Sound::releaseVoices(MaSound *sound)
+{
+	for (Voice &v : m_sfxVoices) {
+		if (sound && v.source != sound)
+			continue;
+
+		if (v.sound) {
+			ma_sound_stop(v.sound.get());
+			ma_sound_uninit(v.sound.get());
+			v.sound.reset();
+		}
+
+		v.source = nullptr;
+		v.priority = 0.;
+	}
+
+	if (sound)
+		m_frameVoices.remove(sound);
+	else
+		m_frameVoices.clear();
+}
+
+
+
+/**
+ * @brief Sound::removeSound
+ * @param sound
+ *
+ * Törlés előtt kiveszi a hangot az indexből és a hangpoolból
+ */
+
+void Sound::removeSound(MaSound *sound)
+{
+	if (!sound)
+		return;
+
+	releaseVoices(sound);
+	m_soundIndex.remove(soundKey(soundId(sound->path()), sound->channel()));
+}
+
+
+
+/**
+ * @brief Sound::soundId
+ * @param path
+ * @return
+ */
+
+int Sound::soundId(const QString &path)
+{
+	if (const auto it = m_soundIds.constFind(path); it != m_soundIds.constEnd())
+		return *it;
+
+	const int id = m_soundIds.size();
+	m_soundIds.insert(path, id);
+	return id;
 }
 
 
@@ -763,20 +1155,16 @@ Sound::MaSound::MaSound(ma_engine *engine, const QString &path, const ChannelTyp
 	if (s.startsWith(QStringLiteral("qrc:/")))
 		s.replace(QStringLiteral("qrc:/"), QStringLiteral(":/"));
 
-	QTemporaryFile *tmp = QTemporaryFile::createNativeFile(s);
+	// A fájlokat a VFS olvassa (resource memóriából)
+	// Zene és voiceover: streamelve, sfx: aszinkron dekódolva (a resource manager megosztja)
 
-	if (tmp) {
-		tmp->setAutoRemove(false);
-		m_tmpPath = QDir::toNativeSeparators(tmp->fileName()).toUtf8();
-		delete tmp;
-	} else
-		m_tmpPath = QDir::toNativeSeparators(s).toUtf8();
-
-	LOG_CTRACE("sound") << "MaSound ready:" << qPrintable(path) << "->" << m_tmpPath.constData();
+	const ma_uint32 flags = channel == SfxChannel ?
+								MA_SOUND_FLAG_DECODE | MA_SOUND_FLAG_ASYNC :
+								MA_SOUND_FLAG_STREAM;
 
 	m_sound = std::make_unique<ma_sound>();
 
-	if (auto r = ma_sound_init_from_file(m_engine, m_tmpPath, MA_SOUND_FLAG_DECODE, group, NULL, m_sound.get());
+	if (auto r = ma_sound_init_from_file(m_engine, s.toUtf8().constData(), flags, group, NULL, m_sound.get());
 			r != MA_SUCCESS) {
 		LOG_CERROR("sound") << "Sound error" << qPrintable(path) << "code" << r;
 		m_sound.reset();
@@ -814,127 +1202,35 @@ void Sound::MaSound::uninit()
 
 	LOG_CTRACE("sound") << "Uninit MaSound" << this;
 
-	uninitChildren();
-
 	if (m_sound) {
 		ma_sound_stop(m_sound.get());
 		ma_sound_uninit(m_sound.get());
 		m_sound.reset();
 	}
 
-	if (!m_tmpPath.isEmpty()) {
-		QFile::remove(m_tmpPath);
-	}
-
 	LOG_CTRACE("sound") << "Uninit MaSound finished" << this;
 }
 
 
 /**
- * @brief Sound::MaSound::uninitChildren
- */
-
-void Sound::MaSound::uninitChildren()
-{
-	QMutexLocker locker(&m_mutex);
-
-	for (auto &ptr : m_children) {
-		if (!ptr)
-			continue;
-		ma_sound_stop(ptr.get());
-		ma_sound_uninit(ptr.get());
-		ptr.reset();
-	}
-
-	m_children.clear();
-}
-
-
-
-/**
- * @brief Sound::MaSound::duplicate
+ * @brief Sound::MaSound::pcmSize
  * @return
  */
 
-ma_sound *Sound::MaSound::duplicate(ma_sound_group *group)
-{
-	if (!m_sound)
-		return nullptr;
-
-	QMutexLocker locker(&m_mutex);
-
-	LOG_CTRACE("sound") << "Add children" << this;
-
-	if (m_children.size() > 5) {
-		LOG_CDEBUG("sound") << "Children overload" << this;
-		return nullptr;
-	}
-
-	auto child = std::make_unique<ma_sound>();
-
-	if (auto r = ma_sound_init_copy(m_engine, m_sound.get(), 0, group, child.get()); r != MA_SUCCESS) {
-		LOG_CERROR("sound") << "Duplicate error" << r;
-		child.reset();
-		return nullptr;
-	}
-
-	ma_sound *ptr = child.get();
-
-	ma_sound_set_end_callback(ptr, [](void* pUserData, ma_sound *snd) {
-		MaSound *obj = static_cast<MaSound*>(pUserData);
-
-		if (obj) {
-			QMutexLocker locker(&obj->m_mutex);
-			obj->m_garbage.push_back(snd);
-		}
-	}, this);
-
-
-	m_children.push_back(std::move(child));
-
-	return ptr;
-}
-
-
-
-/**
- * @brief Sound::MaSound::garbage
- */
-
-void Sound::MaSound::garbage()
+qint64 Sound::MaSound::pcmSize() const
 {
-	QMutexLocker locker(&m_mutex);
+	if (!m_sound || m_channel != SfxChannel)
+		return 0;
 
-	for (const auto &ptr : m_garbage) {
-		if (ptr)
-			removeChild(ptr);
-	}
+	ma_uint64 frames = 0;
+	ma_format format = ma_format_unknown;
+	ma_uint32 channels = 0;
 
-	m_garbage.clear();
-}
+	if (ma_sound_get_length_in_pcm_frames(m_sound.get(), &frames) != MA_SUCCESS ||
+			ma_sound_get_data_format(m_sound.get(), &format, &channels, NULL, NULL, 0) != MA_SUCCESS)
+		return 0;
 
-
-
-/**
- * @brief Sound::MaSound::removeChild
- * @param ptr
- */
-
-void Sound::MaSound::removeChild(ma_sound *sound)
-{
-	LOG_CTRACE("sound") << "Remove duplicated child" << sound << "from" << this << m_children.size();
-
-	QMutexLocker locker(&m_mutex);
-
-	for (auto it = m_children.begin(); it != m_children.end(); ) {
-		if (it->get() == sound) {
-			ma_sound_uninit(it->get());
-			it->reset();
-			it = m_children.erase(it);
-		} else {
-			++it;
-		}
-	}
+	return frames * channels * ma_get_bytes_per_sample(format);
 }
 
 
@@ -43,7 +43,7 @@
 #include <QMutex>
 #include <miniaudio.h>
 #include <QHash>
-#include <QTemporaryFile>
+#include <QElapsedTimer>
 
 
 /**
@@ -77,7 +77,6 @@ private:
 		~MaSound();
 
 		void uninit();
-		void uninitChildren();
 
 		const QString &path() const { return m_path; }
 
@@ -86,23 +85,29 @@ private:
 
 		ma_sound *sound() const { return m_sound.get(); }
 
-		ma_sound *duplicate(ma_sound_group *group);
-		void garbage();
-
-		const std::vector<std::unique_ptr<ma_sound> > &children() { return m_children; }
+		qint64 lastUsed() const { return m_lastUsed.isValid() ? m_lastUsed.elapsed() : -1; }
+		void setUsed() { m_lastUsed.start(); }
+		qint64 pcmSize() const;
 
 	private:
-		void removeChild(ma_sound *ptr);
-
 		ma_engine *m_engine = nullptr;
 		QString m_path;
 		ChannelType m_channel = SfxChannel;
 		std::unique_ptr<ma_sound> m_sound;
-		std::vector<std::unique_ptr<ma_sound> > m_children;
-		std::vector<ma_sound*> m_garbage;
 
 		QRecursiveMutex m_mutex;
-		QByteArray m_tmpPath;
+		QElapsedTimer m_lastUsed;
+	};
+
+
+	/**
+	 * @brief The Voice class
+	 */
+
+	struct Voice {
+		std::unique_ptr<ma_sound> sound;
+		MaSound *source = nullptr;
+		float priority = 0.;
 	};
 
 
@@ -182,10 +187,17 @@ private:
 	void engineCheck();
 
 	void playSound(MaSound *sound, const float &volume);
+	void playVoice(MaSound *sound, const float &volume);
+	bool isVoicePlaying(MaSound *sound) const;
+	void releaseVoices(MaSound *sound);
+	void removeSound(MaSound *sound);
+
+	int soundId(const QString &path);
+	static quint64 soundKey(const int &id, const ChannelType &channel) { return (quint64(id) << 8) | quint64(channel); }
+
 	QVector<MaSound *> currentMusic() const;
 	QVector<MaSound *> currentMusic2() const;
 	void updateVolumes();
-	void garbage();
 	void playNextVoiceOver();
 
 	int m_volumeSfx = 0;
@@ -195,17 +207,23 @@ private:
 	bool m_voiceOverEnabled = true;
 	bool m_musicEnabled = true;
 
+	ma_vfs_callbacks m_vfs;
 	std::unique_ptr<ma_engine> m_engine;
 	std::unique_ptr<ma_sound_group> m_groupSfx;
 	std::unique_ptr<ma_sound_group> m_groupMusic;
 	std::unique_ptr<ma_sound_group> m_groupVoiceOver;
 
 	std::vector<std::unique_ptr<MaSound> > m_sound;
+	QHash<QString, int> m_soundIds;							// internált útvonalak
+	QHash<quint64, MaSound*> m_soundIndex;					// (id, channel) -> MaSound
+
+	std::vector<Voice> m_sfxVoices;
+	QHash<MaSound*, int> m_frameVoices;						// az aktuális frame-ben indított sfx-ek
+	QElapsedTimer m_frameTimer;
 	QVector<ExternalSound*> m_externalSounds;
 
 	QQueue<MaSound *> m_queue;
 
-	QTimer m_garbageTimer;
 	QTimer m_clearTimer;
 	QRecursiveMutex m_mutex;
 };
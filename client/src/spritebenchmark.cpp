@@ -0,0 +1,162 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * spritebenchmark.cpp
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * SpriteBenchmark
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "spritebenchmark.h"
+#include "tiledspritehandler.h"
+#include "Logger.h"
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <random>
+
+
+#define SPRITE_CHANGE_PERCENT		10				// A karakterek 10%-a vált animációt egy tickben
+
+
+/**
+ * @brief SpriteBenchmark::run
+ * A sprite-ok textúra nélkül kerülnek a handlerbe, így csak a keresés és a váltás ideje mérhető
+ * @param characters
+ * @param ticks
+ * @return
+ */
+
+SpriteBenchmark::Result SpriteBenchmark::run(const int &characters, const int &ticks)
+{
+	static const QStringList names = {
+		QStringLiteral("idle"), QStringLiteral("walk"), QStringLiteral("run"),
+		QStringLiteral("attack"), QStringLiteral("shot"), QStringLiteral("hurt"), QStringLiteral("death")
+	};
+
+	static const QStringList layers = {
+		QStringLiteral("default"), QStringLiteral("body"), QStringLiteral("weapon"), QStringLiteral("shield")
+	};
+
+	static const QVector<TiledObject::Direction> directions = {
+		TiledObject::North, TiledObject::NorthEast, TiledObject::East, TiledObject::SouthEast,
+		TiledObject::South, TiledObject::SouthWest, TiledObject::West, TiledObject::NorthWest
+	};
+
+	Result result;
+	result.characters = std::max(1, characters);
+	result.ticks = std::max(1, ticks);
+
+	std::vector<std::unique_ptr<TiledSpriteHandler>> handlers;
+	handlers.reserve(result.characters);
+
+	for (int i=0; i<result.characters; ++i) {
+		TiledSpriteHandler *h = handlers.emplace_back(std::make_unique<TiledSpriteHandler>()).get();
+
+		for (const QString &layer : layers) {
+			for (const QString &name : names) {
+				for (const TiledObject::Direction &dir : directions) {
+					TiledSpriteHandler::Sprite s;
+					s.layer = layer;
+					s.direction = dir;
+					s.data = TextureSprite(name, 64, 64, 60, QVector<TextureSpriteFrame>(8));
+					h->appendSprite(s);
+				}
+
+				if (!h->m_spriteNames.contains(name))
+					h->m_spriteNames.append(name);
+			}
+		}
+
+		h->setVisibleLayers(layers);
+		h->changeSprite(names.first(), directions.first());
+	}
+
+	result.sprites = handlers.front()->m_spriteList.size();
+
+	std::mt19937 rng(QRandomGenerator::global()->generate());
+	std::uniform_int_distribution<int> percent(0, 99);
+	std::uniform_int_distribution<int> nameDist(0, names.size()-1);
+	std::uniform_int_distribution<int> dirDist(0, directions.size()-1);
+
+	QElapsedTimer timer;
+	qint64 changeNsec = 0;
+	int visible = 0;
+
+	timer.start();
+
+	for (int t=0; t<result.ticks; ++t) {
+		for (const auto &h : handlers) {
+			if (percent(rng) < SPRITE_CHANGE_PERCENT) {
+				const QString &name = names.at(nameDist(rng));
+				const TiledObject::Direction &dir = directions.at(dirDist(rng));
+
+				const qint64 start = timer.nsecsElapsed();
+				h->changeSprite(name, dir);
+				changeNsec += timer.nsecsElapsed()-start;
+
+				++result.changes;
+			}
+
+			// Animációs timer és updatePaintNode() keresése
+
+			h->timerEvent(nullptr);
+			visible += h->find(h->m_currentNameId, h->m_currentDirection).size();
+		}
+	}
+
+	result.msec = timer.nsecsElapsed() / 1000000.;
+	result.tickUsec = result.msec * 1000. / result.ticks;
+	result.changeNsec = result.changes > 0 ? (qreal) changeNsec / result.changes : 0.;
+
+	if (visible != result.ticks * result.characters * layers.size())
+		LOG_CWARNING("app") << "Sprite benchmark: missing sprites" << visible;
+
+	return result;
+}
+
+
+
+/**
+ * @brief SpriteBenchmark::report
+ * @param result
+ * @return
+ */
+
+QString SpriteBenchmark::report(const Result &result)
+{
+	QString txt;
+	QTextStream out(&txt);
+
+	out << QStringLiteral("%1 characters, %2 sprites each, %3 ticks\n")
+		   .arg(result.characters)
+		   .arg(result.sprites)
+		   .arg(result.ticks);
+
+	out << QStringLiteral("    %1 ms total, %2 us/tick, %3 changes, %4 ns/change\n")
+		   .arg(result.msec, 0, 'f', 2)
+		   .arg(result.tickUsec, 0, 'f', 2)
+		   .arg(result.changes)
+		   .arg(result.changeNsec, 0, 'f', 1);
+
+	out.flush();
+
+	return txt;
+}
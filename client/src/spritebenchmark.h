@@ -0,0 +1,58 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * spritebenchmark.h
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * SpriteBenchmark
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPRITEBENCHMARK_H
+#define SPRITEBENCHMARK_H
+
+#include <QString>
+
+
+/**
+ * @brief The SpriteBenchmark class
+ *
+ * Animált karakterek sprite-váltásainak mérése (TiledSpriteHandler):
+ *  - minden karakter minden tickben képkockát léptet és kikeresi a rajzolandó sprite-okat
+ *  - a karakterek egy része minden tickben animációt vagy irányt vált
+ */
+
+class SpriteBenchmark
+{
+public:
+	struct Result {
+		int characters = 0;
+		int ticks = 0;
+		int sprites = 0;				// sprite-ok száma karakterenként
+		int changes = 0;				// összes sprite-váltás
+		qreal msec = 0.;				// teljes idő
+		qreal tickUsec = 0.;			// egy tick átlagos ideje (összes karakter)
+		qreal changeNsec = 0.;			// egy sprite-váltás átlagos ideje
+	};
+
+	static Result run(const int &characters = 50, const int &ticks = 6000);
+	static QString report(const Result &result);
+};
+
+#endif // SPRITEBENCHMARK_H
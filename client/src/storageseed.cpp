@@ -27,6 +27,8 @@
 #include "storageseed.h"
 #include "Logger.h"
 #include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
 #include <QCborMap>
 #include <QCborArray>
 #include <random>
@@ -34,6 +36,12 @@
 #include "utils_.h"
 
 
+#define SEED_LOG_VERSION			1
+#define SEED_LOG_STREAM_VERSION		QDataStream::Qt_6_7
+#define SEED_LOG_COMPACT_MIN		256			// Ennyi felesleges bejegyzés fölött tömörítjük a naplót
+
+
+
 class StorageSeedPrivate
 {
 private:
@@ -41,8 +49,23 @@ private:
 		: q(seed)
 	{}
 
+	enum LogType : quint8 {
+		LogMap = 1,
+		LogRecord,
+		LogClear
+	};
+
 	bool loadFromFile();
+	bool loadLog(const QByteArray &data);
+	bool loadLegacy(const QByteArray &data);
 	bool saveToFile();
+	void close();
+
+	quint32 logMap(QDataStream &stream, const QString &map);
+	void logRecord(const QString &map, const int &storage, const int &main, const int &sub);
+	void logClear(const QString &map, const int &storage, const int &main);
+	bool logWrite(const QByteArray &data);
+	int liveCount() const;
 
 	void setData(const QVariantMap &question, const int &storage = -1, const QString &map = {});
 	static void extract(const QVariantMap &question, int *storage, QString *map, int *mainA, int *subA, int *mainB, int *subB);
@@ -60,6 +83,13 @@ private:
 
 	QHash<QString, StorageSeedStorageData> m_data;
 
+	// Hozzáfűzős napló: minden felhasznált kérdés egy rövid bejegyzés, időnként tömörítjük
+
+	std::unique_ptr<QFile> m_log;
+	QHash<QString, quint32> m_logMaps;
+	int m_logRecords = 0;
+	bool m_compactRequired = false;
+
 	struct ClearData {
 		QString map;
 		int storage = -1;
@@ -73,6 +103,7 @@ private:
 	friend class StorageSeed;
 	friend class SeedHelper;
 	friend class SeedDuplexHelper;
+	friend class SeedSampler;
 };
 
 
@@ -127,6 +158,7 @@ StorageSeed &StorageSeed::operator=(const StorageSeed &other)
 	m_currentMap = other.m_currentMap;
 	d->m_data = other.d->m_data;
 	d->m_toClear = other.d->m_toClear;
+	d->m_compactRequired = true;
 
 	return *this;
 }
@@ -137,7 +169,7 @@ StorageSeed &StorageSeed::operator=(const StorageSeed &other)
 
 StorageSeed::~StorageSeed()
 {
-	d->saveToFile();
+	d->close();
 	delete d;
 	d = nullptr;
 }
@@ -235,7 +267,7 @@ void StorageSeed::setCurrentStorage(int newCurrentStorage)
  * @return
  */
 
-QList<int> StorageSeed::getDataFromCurrent(const int &main) const
+QSet<int> StorageSeed::getDataFromCurrent(const int &main) const
 {
 	if (m_currentStorage <= 0)
 		return {};
@@ -252,7 +284,7 @@ QList<int> StorageSeed::getDataFromCurrent(const int &main) const
  * @return
  */
 
-QList<int> StorageSeed::getDataFromCurrent(const int &storage, const int &main) const
+QSet<int> StorageSeed::getDataFromCurrent(const int &storage, const int &main) const
 {
 	if (m_currentMap.isEmpty())
 		return {};
@@ -270,7 +302,7 @@ QList<int> StorageSeed::getDataFromCurrent(const int &storage, const int &main)
  * @return
  */
 
-QList<int> StorageSeed::getData(const QString &map, const int &storage, const int &main) const
+QSet<int> StorageSeed::getData(const QString &map, const int &storage, const int &main) const
 {
 	return d->m_data.value(map).value(storage).value(main);
 }
@@ -335,18 +367,141 @@ bool StorageSeedPrivate::loadFromFile()
 	if (m_fileName.isEmpty())
 		return false;
 
-	const auto &ptr = Utils::fileContent(m_fileName);
+	m_data.clear();
+
+	bool success = false;
 
-	if (!ptr) {
-		LOG_CWARNING("utils") << "File read error" << m_fileName;
+	if (QFile::exists(m_fileName)) {
+		const auto &ptr = Utils::fileContent(m_fileName);
+
+		if (!ptr) {
+			LOG_CWARNING("utils") << "File read error" << m_fileName;
+			return false;
+		}
+
+		// A régi (CBOR) formátumot átalakítjuk
+
+		if (loadLog(ptr.value())) {
+			success = true;
+		} else if (loadLegacy(ptr.value())) {
+			m_compactRequired = true;
+			success = true;
+		} else {
+			LOG_CWARNING("utils") << "Invalid storage seed file" << m_fileName;
+			m_data.clear();
+		}
+	}
+
+	if (!success || m_compactRequired || m_logRecords > 2 * liveCount() + SEED_LOG_COMPACT_MIN)
+		return saveToFile() && success;
+
+	m_log = std::make_unique<QFile>(m_fileName);
+
+	if (!m_log->open(QIODevice::WriteOnly | QIODevice::Append)) {
+		LOG_CERROR("utils") << "File write error" << m_fileName;
+		m_log.reset();
+	}
+
+	LOG_CDEBUG("utils") << "Storage seed loaded" << m_fileName;
+
+	return true;
+}
+
+
+
+/**
+ * @brief StorageSeedPrivate::loadLog
+ * @param data
+ * @return
+ */
+
+bool StorageSeedPrivate::loadLog(const QByteArray &data)
+{
+	QDataStream stream(data);
+	stream.setVersion(SEED_LOG_STREAM_VERSION);
+
+	quint32 magic = 0;
+	QByteArray str;
+	qint32 version = -1;
+
+	stream >> magic >> str >> version;
+
+	if (magic != 0x434F53 || str != "SDL" || version != SEED_LOG_VERSION)			// COS
 		return false;
+
+	// A visszajátszás csak azt állítja vissza, mely sub-okat használtuk fel (halmaz), sorrendet nem
+
+	QHash<quint32, QString> maps;
+
+	m_logMaps.clear();
+	m_logRecords = 0;
+
+	while (!stream.atEnd()) {
+		quint8 type = 0;
+		quint32 mapId = 0;
+		qint32 storage = 0, main = 0, sub = 0;
+		QString map;
+
+		stream >> type >> mapId;
+
+		switch (type) {
+			case LogMap:
+				stream >> map;
+				if (stream.status() == QDataStream::Ok) {
+					maps.insert(mapId, map);
+					m_logMaps.insert(map, mapId);
+				}
+				break;
+
+			case LogRecord:
+				stream >> storage >> main >> sub;
+				if (stream.status() == QDataStream::Ok && maps.contains(mapId)) {
+					record(maps.value(mapId), storage, main, sub);
+					++m_logRecords;
+				}
+				break;
+
+			case LogClear:
+				stream >> storage >> main;
+				if (stream.status() == QDataStream::Ok && maps.contains(mapId)) {
+					m_data[maps.value(mapId)][storage][main].clear();
+					++m_logRecords;
+				}
+				break;
+
+			default:
+				stream.setStatus(QDataStream::ReadCorruptData);
+				break;
+		}
+
+		// Félbeszakadt írás: a hibás véget eldobjuk
+
+		if (stream.status() != QDataStream::Ok) {
+			LOG_CWARNING("utils") << "Storage seed log truncated" << m_fileName;
+			m_compactRequired = true;
+			break;
+		}
 	}
 
-	m_data.clear();
+	return true;
+}
+
+
+
+/**
+ * @brief StorageSeedPrivate::loadLegacy
+ * @param data
+ * @return
+ */
+
+bool StorageSeedPrivate::loadLegacy(const QByteArray &data)
+{
+	const QCborValue &value = QCborValue::fromCbor(data);
 
-	QCborMap map = QCborValue::fromCbor(ptr.value()).toMap();
+	if (!value.isMap())
+		return false;
 
-	for (const auto &[map, slist] : map) {
+	for (const auto &[map, slist] : value.toMap()) {
 		for (const auto &[st, mlist] : slist.toMap()) {
 			for (const auto &[main, list] : mlist.toMap()) {
 				for (const auto &sub : list.toArray())
@@ -355,7 +510,7 @@ bool StorageSeedPrivate::loadFromFile()
 		}
 	}
 
-	LOG_CDEBUG("utils") << "Storage seed loaded" << m_fileName;
+	LOG_CDEBUG("utils") << "Legacy storage seed loaded" << m_fileName;
 
 	return true;
 }
@@ -367,6 +522,8 @@ bool StorageSeedPrivate::loadFromFile()
 /**
  * @brief StorageSeedPrivate::saveToFile
  * @return
+ *
+ * A teljes (tömörített) napló kiírása, utána a további bejegyzéseket hozzáfűzzük
  */
 
 bool StorageSeedPrivate::saveToFile()
@@ -374,49 +531,198 @@ bool StorageSeedPrivate::saveToFile()
 	if (m_fileName.isEmpty())
 		return false;
 
-	QFile f(m_fileName);
+	m_log.reset();
+	m_logMaps.clear();
+	m_logRecords = 0;
+
+	QSaveFile f(m_fileName);
+	f.setDirectWriteFallback(true);
 
 	if (!f.open(QIODevice::WriteOnly)) {
 		LOG_CERROR("utils") << "File write error" << m_fileName;
 		return false;
 	}
 
-	QCborMap map;
+	QDataStream stream(&f);
+	stream.setVersion(SEED_LOG_STREAM_VERSION);
+
+	stream << (quint32) 0x434F53;			// COS
+	stream << QByteArray("SDL");
+	stream << (qint32) SEED_LOG_VERSION;
 
 	for (const auto &[m, d] : m_data.asKeyValueRange()) {
-		QCborMap mapSt;
+		const quint32 mapId = logMap(stream, m);
 
 		for (const auto &[st, sd] : d.asKeyValueRange()) {
-			QCborMap mapD;
-
 			for (const auto &[main, subl] : sd.asKeyValueRange()) {
-				QCborArray sub;
-
-				for (const int &s : subl)
-					sub.append(s);
-
-				// main = [ subs ]
-				mapD.insert(main, sub);
+				for (const int &sub : subl) {
+					stream << (quint8) LogRecord << mapId << (qint32) st << (qint32) main << (qint32) sub;
+					++m_logRecords;
+				}
 			}
-
-			// storage = { mains }
-			mapSt.insert(st, mapD);
 		}
+	}
 
-		// mapUuid = { storages }
-		map.insert(m, mapSt);
+	if (!f.commit()) {
+		LOG_CERROR("utils") << "File write error" << m_fileName;
+		m_logMaps.clear();
+		return false;
 	}
 
+	m_compactRequired = false;
+
 	LOG_CDEBUG("utils") << "Storage seed saved" << m_fileName;
 
-	f.write(map.toCborValue().toCbor());
+	m_log = std::make_unique<QFile>(m_fileName);
+
+	if (!m_log->open(QIODevice::WriteOnly | QIODevice::Append)) {
+		LOG_CERROR("utils") << "File write error" << m_fileName;
+		m_log.reset();
+		return false;
+	}
+
+	return true;
+}
+
+
+
+/**
+ * @brief StorageSeedPrivate::close
+ */
+
+void StorageSeedPrivate::close()
+{
+	if (m_compactRequired || (m_log && m_logRecords > 2 * liveCount() + SEED_LOG_COMPACT_MIN))
+		saveToFile();
+
+	m_log.reset();
+}
+
+
+
+/**
+ * @brief StorageSeedPrivate::logMap
+ * @param stream
+ * @param map
+ * @return
+ *
+ * A pálya azonosítóját csak egyszer írjuk ki, utána a sorszámával hivatkozunk rá
+ */
+
+quint32 StorageSeedPrivate::logMap(QDataStream &stream, const QString &map)
+{
+	if (const auto it = m_logMaps.constFind(map); it != m_logMaps.constEnd())
+		return *it;
 
-	f.close();
+	const quint32 id = m_logMaps.size()+1;
+	m_logMaps.insert(map, id);
+
+	stream << (quint8) LogMap << id << map;
+
+	return id;
+}
+
+
+
+/**
+ * @brief StorageSeedPrivate::logRecord
+ * @param map
+ * @param storage
+ * @param main
+ * @param sub
+ */
+
+void StorageSeedPrivate::logRecord(const QString &map, const int &storage, const int &main, const int &sub)
+{
+	if (!m_log)
+		return;
+
+	QByteArray data;
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	stream.setVersion(SEED_LOG_STREAM_VERSION);
+
+	const bool newMap = !m_logMaps.contains(map);
+	const quint32 mapId = logMap(stream, map);
+
+	stream << (quint8) LogRecord << mapId << (qint32) storage << (qint32) main << (qint32) sub;
+
+	if (logWrite(data))
+		++m_logRecords;
+	else if (newMap)
+		m_logMaps.remove(map);			// a pálya bejegyzése sem került a naplóba
+}
+
+
+
+/**
+ * @brief StorageSeedPrivate::logClear
+ * @param map
+ * @param storage
+ * @param main
+ */
+
+void StorageSeedPrivate::logClear(const QString &map, const int &storage, const int &main)
+{
+	if (!m_log)
+		return;
+
+	QByteArray data;
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	stream.setVersion(SEED_LOG_STREAM_VERSION);
+
+	const bool newMap = !m_logMaps.contains(map);
+	const quint32 mapId = logMap(stream, map);
+
+	stream << (quint8) LogClear << mapId << (qint32) storage << (qint32) main;
+
+	if (logWrite(data))
+		++m_logRecords;
+	else if (newMap)
+		m_logMaps.remove(map);			// a pálya bejegyzése sem került a naplóba
+}
+
+
+
+/**
+ * @brief StorageSeedPrivate::logWrite
+ * @param data
+ * @return
+ */
+
+bool StorageSeedPrivate::logWrite(const QByteArray &data)
+{
+	if (m_log->write(data) != data.size() || !m_log->flush()) {
+		LOG_CERROR("utils") << "File write error" << m_fileName;
+		m_compactRequired = true;
+		return false;
+	}
 
 	return true;
 }
 
 
+
+/**
+ * @brief StorageSeedPrivate::liveCount
+ * @return
+ */
+
+int StorageSeedPrivate::liveCount() const
+{
+	int count = 0;
+
+	for (const auto &d : m_data) {
+		for (const auto &sd : d) {
+			for (const auto &subl : sd)
+				count += subl.size();
+		}
+	}
+
+	return count;
+}
+
+
+
 /**
  * @brief StorageSeedPrivate::setData
  * @param question
@@ -475,10 +781,12 @@ void StorageSeedPrivate::setData(const QVariantMap &question, const int &storage
 	}
 
 	record(cMap, cStorage, main, sub);
+	logRecord(cMap, cStorage, main, sub);
 	performClear(cMap, cStorage, main, true);
 
 	if (mainB > 0 && subB > 0) {
 		record(cMap, cStorage, mainB, subB);
+		logRecord(cMap, cStorage, mainB, subB);
 		performClear(cMap, cStorage, mainB, false);
 	}
 }
@@ -537,9 +845,7 @@ void StorageSeedPrivate::extract(const QVariantMap &question, int *storage, QStr
 
 void StorageSeedPrivate::record(const QString &map, const int &storage, const int &main, const int &sub)
 {
-	QList<int> &list = m_data[map][storage][main];
-	list.removeAll(sub);
-	list.append(sub);
+	m_data[map][storage][main].insert(sub);
 }
 
 
@@ -602,10 +908,11 @@ void StorageSeedPrivate::performClear(const QString &map, const int &storage, co
 
 void StorageSeedPrivate::clear(const QString &map, const int &storage, const int &main)
 {
-	m_data[(map.isEmpty() ? q->m_currentMap : map)]
-			[(storage <= 0 ? q->m_currentStorage : storage)]
-			[main]
-			.clear();
+	const QString &cMap = map.isEmpty() ? q->m_currentMap : map;
+	const int cStorage = storage <= 0 ? q->m_currentStorage : storage;
+
+	m_data[cMap][cStorage][main].clear();
+	logClear(cMap, cStorage, main);
 }
 
 
@@ -613,6 +920,22 @@ void StorageSeedPrivate::clear(const QString &map, const int &storage, const int
 
 
 
+/**
+ * @brief SeedItem::get
+ * @return
+ */
+
+QVariantMap SeedItem::get() const
+{
+	QVariantMap m = m_generator ? m_generator() : m_map;
+
+	StorageSeed::addSeedToMap(&m, m_mainA, m_subA, m_mainB, m_subB);
+
+	return m;
+}
+
+
+
 /**
  * @brief SeedHelper::SeedHelper
  * @param main
@@ -689,11 +1012,38 @@ SeedHelper::SeedHelper(StorageSeed *seed, const QString &map, const int &storage
  */
 
 SeedHelper &SeedHelper::append(const QVariantMap &map, const int &sub, const int &main)
+{
+	return append(SeedItem(map, main > -1 ? main : m_main, sub), sub);
+}
+
+
+/**
+ * @brief SeedHelper::append
+ * @param generator
+ * @param sub
+ * @param main
+ * @return
+ */
+
+SeedHelper &SeedHelper::append(const SeedItem::Generator &generator, const int &sub, const int &main)
+{
+	return append(SeedItem(generator, main > -1 ? main : m_main, sub), sub);
+}
+
+
+/**
+ * @brief SeedHelper::append
+ * @param item
+ * @param sub
+ * @return
+ */
+
+SeedHelper &SeedHelper::append(const SeedItem &item, const int &sub)
 {
 	if (m_data.contains(sub))
-		StorageSeed::addSeedToMap(&m_itemUsed.emplace_back(map), main > -1 ? main : m_main, sub);
+		m_itemUsed.push_back(item);
 	else
-		StorageSeed::addSeedToMap(&m_itemReady.emplace_back(map), main > -1 ? main : m_main, sub);
+		m_itemReady.push_back(item);
 
 	return *this;
 }
@@ -718,18 +1068,18 @@ QVariantList SeedHelper::getVariantList(const bool &autoClean)
 
 	if (m_seed) {
 		if (!m_itemReady.empty())
-			list.append(m_itemReady.front());
+			list.append(m_itemReady.front().get());
 
 		if (list.empty() && !m_itemUsed.empty())
-			list.append(m_itemUsed.front());
+			list.append(m_itemUsed.front().get());
 
 	} else {
-		for (const QVariantMap &m : m_itemReady)
-			list.append(m);
+		for (const SeedItem &m : m_itemReady)
+			list.append(m.get());
 
 
-		for (const QVariantMap &m : m_itemUsed)
-			list.append(m);
+		for (const SeedItem &m : m_itemUsed)
+			list.append(m.get());
 	}
 
 	if (autoClean && m_itemReady.empty() && !m_itemUsed.empty()) {
@@ -835,25 +1185,53 @@ SeedDuplexHelper::SeedDuplexHelper(StorageSeed *seed, const QString &map, const
 
 SeedDuplexHelper &SeedDuplexHelper::append(const QVariantMap &map, const int &subA, const int &subB, const int &mainA, const int &mainB)
 {
-	if (m_dataA.contains(subA) && m_dataB.contains(subB))
-		StorageSeed::addSeedToMap(&m_itemUsedDouble.emplace_back(map),
-								  mainA > -1 ? mainA : m_mainA, subA,
-								  mainB > -1 ? mainB : m_mainB, subB);
+	return append(SeedItem(map,
+						   mainA > -1 ? mainA : m_mainA, subA,
+						   mainB > -1 ? mainB : m_mainB, subB),
+				  subA, subB);
+}
 
-	else if (m_dataA.contains(subA))
-		StorageSeed::addSeedToMap(&m_itemUsedA.emplace_back(map),
-								  mainA > -1 ? mainA : m_mainA, subA,
-								  mainB > -1 ? mainB : m_mainB, subB);
 
-	else if (m_dataB.contains(subB))
-		StorageSeed::addSeedToMap(&m_itemUsedB.emplace_back(map),
-								  mainA > -1 ? mainA : m_mainA, subA,
-								  mainB > -1 ? mainB : m_mainB, subB);
 
+/**
+ * @brief SeedDuplexHelper::append
+ * @param generator
+ * @param subA
+ * @param subB
+ * @param mainA
+ * @param mainB
+ * @return
+ */
+
+SeedDuplexHelper &SeedDuplexHelper::append(const SeedItem::Generator &generator, const int &subA, const int &subB,
+										   const int &mainA, const int &mainB)
+{
+	return append(SeedItem(generator,
+						   mainA > -1 ? mainA : m_mainA, subA,
+						   mainB > -1 ? mainB : m_mainB, subB),
+				  subA, subB);
+}
+
+
+
+/**
+ * @brief SeedDuplexHelper::append
+ * @param item
+ * @param subA
+ * @param subB
+ * @return
+ */
+
+SeedDuplexHelper &SeedDuplexHelper::append(const SeedItem &item, const int &subA, const int &subB)
+{
+	if (m_dataA.contains(subA) && m_dataB.contains(subB))
+		m_itemUsedDouble.push_back(item);
+	else if (m_dataA.contains(subA))
+		m_itemUsedA.push_back(item);
+	else if (m_dataB.contains(subB))
+		m_itemUsedB.push_back(item);
 	else
-		StorageSeed::addSeedToMap(&m_itemReady.emplace_back(map),
-								  mainA > -1 ? mainA : m_mainA, subA,
-								  mainB > -1 ? mainB : m_mainB, subB);
+		m_itemReady.push_back(item);
 
 	return *this;
 }
@@ -963,31 +1341,31 @@ QVariantList SeedDuplexHelper::getVariantList(const bool &autoClean)
 
 	if (m_seed) {
 		if (!m_itemReady.empty())
-			list.append(m_itemReady.front());
+			list.append(m_itemReady.front().get());
 
 		if (list.empty() && !m_itemUsedB.empty())
-			list.append(m_itemUsedB.front());
+			list.append(m_itemUsedB.front().get());
 
 
 		if (list.empty() && !m_itemUsedA.empty())
-			list.append(m_itemUsedA.front());
+			list.append(m_itemUsedA.front().get());
 
 		if (list.empty() && !m_itemUsedDouble.empty())
-			list.append(m_itemUsedDouble.front());
+			list.append(m_itemUsedDouble.front().get());
 
 
 	} else {
-		for (const QVariantMap &m : m_itemReady)
-			list.append(m);
+		for (const SeedItem &m : m_itemReady)
+			list.append(m.get());
 
-		for (const QVariantMap &m : m_itemUsedB)
-			list.append(m);
+		for (const SeedItem &m : m_itemUsedB)
+			list.append(m.get());
 
-		for (const QVariantMap &m : m_itemUsedA)
-			list.append(m);
+		for (const SeedItem &m : m_itemUsedA)
+			list.append(m.get());
 
-		for (const QVariantMap &m : m_itemUsedDouble)
-			list.append(m);
+		for (const SeedItem &m : m_itemUsedDouble)
+			list.append(m.get());
 	}
 
 
@@ -1010,6 +1388,190 @@ QVariantList SeedDuplexHelper::getVariantList(const bool &autoClean)
 
 
 
+/**
+ * @brief SeedSampler::append
+ * @param item
+ * @param subA
+ * @param subB
+ * @param subBCount
+ */
+
+void SeedSampler::append(const int &item, const int &subA, const int &subB, const int &subBCount)
+{
+	m_candidates.emplace_back(item, subA, subB, subBCount);
+}
+
+
+
+/**
+ * @brief SeedSampler::pick
+ * @param seed
+ * @return
+ *
+ * Ugyanaz a sorrend, mint a SeedDuplexHelper-nél (ready > usedB > usedA > double), de először
+ * néhány véletlen elemet próbálunk ki, és csak akkor járjuk be az egész listát, ha nem találtunk
+ * még fel nem használt elemet. A bejárás nem foglal memóriát (reservoir sampling).
+ */
+
+std::optional<SeedSampler::Pick> SeedSampler::pick(StorageSeed *seed) const
+{
+	if (m_candidates.empty())
+		return std::nullopt;
+
+	QRandomGenerator *g = QRandomGenerator::global();
+
+	const int size = m_candidates.size();
+
+	if (!seed)
+		return resolve(m_candidates.at(g->bounded(size)), {});
+
+	const QSet<int> &dataA = seed->getDataFromCurrent(m_mainA);
+	const QSet<int> &dataB = m_mainB > 0 ? seed->getDataFromCurrent(m_mainB) : QSet<int>{};
+
+	for (int i=0; i<SEED_SAMPLE_ATTEMPTS; ++i) {
+		const Candidate &c = m_candidates.at(g->bounded(size));
+
+		if (state(c, dataA, dataB) == StateReady)
+			return resolve(c, dataB);
+	}
+
+	const Candidate *selected = nullptr;
+	State best = StateUsedDouble;
+	int count = 0;
+	bool hasUsedA = false;
+	bool hasUsedB = false;
+
+	for (const Candidate &c : m_candidates) {
+		const State st = state(c, dataA, dataB);
+
+		if (st == StateUsedA)
+			hasUsedA = true;
+		else if (st == StateUsedB)
+			hasUsedB = true;
+
+		if (!selected || st < best) {
+			selected = &c;
+			best = st;
+			count = 1;
+		} else if (st == best && g->bounded(++count) == 0) {
+			selected = &c;
+		}
+	}
+
+	Q_ASSERT(selected);
+
+	// Minden elemet felhasználtunk: a következő felhasználáskor töröljük a seed-et
+
+	if (best != StateReady) {
+		if (!hasUsedB)
+			seed->d->setReadyToClear(seed->m_currentMap, seed->m_currentStorage, m_mainA, true);
+
+		if (!hasUsedA && m_mainB > 0)
+			seed->d->setReadyToClear(seed->m_currentMap, seed->m_currentStorage, m_mainB, false);
+	}
+
+	return resolve(*selected, dataB);
+}
+
+
+
+/**
+ * @brief SeedSampler::all
+ * @return
+ */
+
+std::vector<SeedSampler::Pick> SeedSampler::all() const
+{
+	std::vector<Pick> list;
+	list.reserve(m_candidates.size());
+
+	for (const Candidate &c : m_candidates)
+		list.push_back(resolve(c, {}));
+
+	std::shuffle(list.begin(), list.end(), *QRandomGenerator::global());
+
+	return list;
+}
+
+
+
+/**
+ * @brief SeedSampler::setReadyToClearB
+ * @param seed
+ *
+ * Ha a sablon választja ki a subB-t (subBCount == 0), és már nincs fel nem használt elem
+ */
+
+void SeedSampler::setReadyToClearB(StorageSeed *seed) const
+{
+	if (seed && m_mainB > 0)
+		seed->d->setReadyToClear(seed->m_currentMap, seed->m_currentStorage, m_mainB, false);
+}
+
+
+
+/**
+ * @brief SeedSampler::state
+ * @param candidate
+ * @param dataA
+ * @param dataB
+ * @return
+ *
+ * Tartomány esetén (subBCount > 1) csak akkor számít felhasználtnak, ha a teljes tartományt felhasználtuk
+ */
+
+SeedSampler::State SeedSampler::state(const Candidate &candidate, const QSet<int> &dataA, const QSet<int> &dataB)
+{
+	const bool usedA = dataA.contains(candidate.subA);
+	bool usedB = false;
+
+	if (candidate.subBCount == 1) {
+		usedB = dataB.contains(candidate.subB);
+	} else if (candidate.subBCount > 1 && !dataB.isEmpty()) {
+		usedB = true;
+
+		for (int i=0; i<candidate.subBCount && usedB; ++i)
+			usedB = dataB.contains(candidate.subB+i);
+	}
+
+	if (usedA && usedB)
+		return StateUsedDouble;
+	else if (usedA)
+		return StateUsedA;
+	else if (usedB)
+		return StateUsedB;
+	else
+		return StateReady;
+}
+
+
+
+/**
+ * @brief SeedSampler::resolve
+ * @param candidate
+ * @param dataB
+ * @return
+ */
+
+SeedSampler::Pick SeedSampler::resolve(const Candidate &candidate, const QSet<int> &dataB)
+{
+	Pick p{.item = candidate.item, .subA = candidate.subA, .subB = candidate.subB};
+
+	if (candidate.subBCount == 0) {
+		p.subB = -1;
+	} else if (candidate.subBCount > 1) {
+		const std::vector<int> &list = sample(candidate.subBCount, 1, [&candidate, &dataB](const int &i) {
+			return !dataB.contains(candidate.subB+i);
+		});
+
+		p.subB += list.empty() ? QRandomGenerator::global()->bounded(candidate.subBCount) : list.front();
+	}
+
+	return p;
+}
+
+
+
 /**
  * @brief operator <<
  * @param debug
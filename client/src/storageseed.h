@@ -30,9 +30,17 @@
 #include "qdebug.h"
 #include <QString>
 #include <QList>
+#include <QSet>
+#include <QRandomGenerator>
+#include <functional>
+#include <optional>
+#include <algorithm>
 
 
-typedef QHash<int, QList<int>> StorageSeedData;
+#define SEED_SAMPLE_ATTEMPTS		8			// véletlen próbálkozások kiválasztandó elemenként
+
+
+typedef QHash<int, QSet<int>> StorageSeedData;
 typedef QHash<int, StorageSeedData> StorageSeedStorageData;
 
 
@@ -60,9 +68,9 @@ public:
 	int currentStorage() const;
 	void setCurrentStorage(int newCurrentStorage);
 
-	QList<int> getDataFromCurrent(const int &main) const;
-	QList<int> getDataFromCurrent(const int &storage, const int &main) const;
-	QList<int> getData(const QString &map, const int &storage, const int &main) const;
+	QSet<int> getDataFromCurrent(const int &main) const;
+	QSet<int> getDataFromCurrent(const int &storage, const int &main) const;
+	QSet<int> getData(const QString &map, const int &storage, const int &main) const;
 
 	void setData(const QVariantMap &question, const int &storage = -1, const QString &map = {});
 
@@ -80,6 +88,7 @@ private:
 	friend class StorageSeedPrivate;
 	friend class SeedHelper;
 	friend class SeedDuplexHelper;
+	friend class SeedSampler;
 };
 
 
@@ -87,6 +96,37 @@ QDebug operator<<(QDebug debug, const StorageSeed &c);
 
 
 
+/**
+ * @brief The SeedItem class
+ *
+ * A helperekbe tett kérdés: kész QVariantMap vagy generátor, ami csak akkor fut le,
+ * ha a kérdést ténylegesen felhasználjuk
+ */
+
+class SeedItem
+{
+public:
+	typedef std::function<QVariantMap()> Generator;
+
+	SeedItem(const QVariantMap &map, const int &mainA, const int &subA, const int &mainB = -1, const int &subB = -1)
+		: m_map(map), m_mainA(mainA), m_subA(subA), m_mainB(mainB), m_subB(subB) {}
+
+	SeedItem(const Generator &generator, const int &mainA, const int &subA, const int &mainB = -1, const int &subB = -1)
+		: m_generator(generator), m_mainA(mainA), m_subA(subA), m_mainB(mainB), m_subB(subB) {}
+
+	QVariantMap get() const;
+
+private:
+	QVariantMap m_map;
+	Generator m_generator;
+	int m_mainA = -1;
+	int m_subA = -1;
+	int m_mainB = -1;
+	int m_subB = -1;
+};
+
+
+
 /**
  * @brief The SeedHelper class
  */
@@ -99,6 +139,7 @@ public:
 	SeedHelper(StorageSeed *seed, const QString &map, const int &storage, const int &main);
 
 	SeedHelper &append(const QVariantMap &map, const int &sub = -1, const int &main = -1);
+	SeedHelper &append(const SeedItem::Generator &generator, const int &sub = -1, const int &main = -1);
 	SeedHelper &operator<< (const QVariantMap &map) { return append(map); }
 
 	QVariantList getVariantList(const bool &autoClean = false);
@@ -106,15 +147,17 @@ public:
 private:
 	SeedHelper(const int &main, StorageSeed *seed);
 
+	SeedHelper &append(const SeedItem &item, const int &sub);
+
 	StorageSeed *const m_seed;
 	const int m_main;
 
 	QString m_map;
 	int m_storage = -1;
 
-	QList<int> m_data;
-	std::vector<QVariantMap> m_itemUsed;
-	std::vector<QVariantMap> m_itemReady;
+	QSet<int> m_data;
+	std::vector<SeedItem> m_itemUsed;
+	std::vector<SeedItem> m_itemReady;
 };
 
 
@@ -132,6 +175,8 @@ public:
 	SeedDuplexHelper(StorageSeed *seed, const QString &map, const int &storage, const int &mainA, const int &mainB);
 
 	SeedDuplexHelper &append(const QVariantMap &map, const int &subA, const int &subB, const int &mainA = -1, const int &mainB = -1);
+	SeedDuplexHelper &append(const SeedItem::Generator &generator, const int &subA, const int &subB,
+							 const int &mainA = -1, const int &mainB = -1);
 
 	int getSubB(const int &from, const int &to) const;
 	int getSubB(const int &to) const { return getSubB(0, to); }
@@ -141,11 +186,15 @@ public:
 	QList<int> getAllSubB(const int &from, const int &to) const;
 	QList<int> getAllSubB(const int &to) const { return getAllSubB(0, to); }
 
+	bool isUsedB(const int &subB) const { return m_dataB.contains(subB); }
+
 	QVariantList getVariantList(const bool &autoClean = false);
 
 private:
 	SeedDuplexHelper(const int &mainA, const int &mainB, StorageSeed *seed);
 
+	SeedDuplexHelper &append(const SeedItem &item, const int &subA, const int &subB);
+
 	StorageSeed *const m_seed;
 	const int m_mainA;
 	const int m_mainB;
@@ -153,13 +202,132 @@ private:
 	QString m_map;
 	int m_storage = -1;
 
-	QList<int> m_dataA;
-	QList<int> m_dataB;
-	std::vector<QVariantMap> m_itemUsedDouble;
-	std::vector<QVariantMap> m_itemUsedA;
-	std::vector<QVariantMap> m_itemUsedB;
-	std::vector<QVariantMap> m_itemReady;
+	QSet<int> m_dataA;
+	QSet<int> m_dataB;
+	std::vector<SeedItem> m_itemUsedDouble;
+	std::vector<SeedItem> m_itemUsedA;
+	std::vector<SeedItem> m_itemUsedB;
+	std::vector<SeedItem> m_itemReady;
 };
 
 
+
+
+/**
+ * @brief The SeedSampler class
+ *
+ * Előre (a sablon fordításakor) felépített kérdéslista: a helperekkel ellentétben nem kell
+ * minden kérdésnél az összes elemet végigjárni és legyártani, véletlen próbálkozásokkal
+ * választunk a még fel nem használt elemek közül
+ */
+
+class SeedSampler
+{
+public:
+	SeedSampler(const int &mainA = -1, const int &mainB = -1)
+		: m_mainA(mainA)
+		, m_mainB(mainB)
+	{}
+
+	struct Pick {
+		int item = -1;				// a sablon saját azonosítója
+		int subA = -1;
+		int subB = -1;
+	};
+
+	// subBCount: 1 = rögzített subB, >1 = a [subB, subB+subBCount) tartományból választunk, 0 = a sablon választja ki
+	void append(const int &item, const int &subA, const int &subB = -1, const int &subBCount = 1);
+
+	bool isEmpty() const { return m_candidates.empty(); }
+	const int &mainA() const { return m_mainA; }
+	const int &mainB() const { return m_mainB; }
+
+	std::optional<Pick> pick(StorageSeed *seed) const;
+	std::vector<Pick> all() const;
+
+	void setReadyToClearB(StorageSeed *seed) const;
+
+	template <typename T>
+	static std::vector<int> sample(const int &size, const int &count, const T &accept);
+
+private:
+	struct Candidate {
+		int item = -1;
+		int subA = -1;
+		int subB = -1;
+		int subBCount = 1;
+	};
+
+	enum State {
+		StateReady = 0,
+		StateUsedB,
+		StateUsedA,
+		StateUsedDouble
+	};
+
+	static State state(const Candidate &candidate, const QSet<int> &dataA, const QSet<int> &dataB);
+	static Pick resolve(const Candidate &candidate, const QSet<int> &dataB);
+
+	const int m_mainA;
+	const int m_mainB;
+	std::vector<Candidate> m_candidates;
+};
+
+
+
+
+/**
+ * @brief SeedSampler::sample
+ * @param size
+ * @param count
+ * @param accept
+ * @return
+ *
+ * Legfeljebb count különböző azonosító a [0, size) tartományból, amire accept() igaz.
+ * Nagy listánál néhány véletlen próbálkozás elég, a teljes listát csak akkor
+ * járjuk be, ha kevés a megfelelő elem.
+ */
+
+template<typename T>
+std::vector<int> SeedSampler::sample(const int &size, const int &count, const T &accept)
+{
+	std::vector<int> list;
+
+	if (size <= 0 || count <= 0)
+		return list;
+
+	list.reserve(count);
+
+	QRandomGenerator *g = QRandomGenerator::global();
+
+	const auto picked = [&list](const int &id) {
+		return std::find(list.cbegin(), list.cend(), id) != list.cend();
+	};
+
+	for (int i=0; i<count*SEED_SAMPLE_ATTEMPTS && (int) list.size() < count; ++i) {
+		const int id = g->bounded(size);
+
+		if (!picked(id) && accept(id))
+			list.push_back(id);
+	}
+
+	if ((int) list.size() >= count)
+		return list;
+
+	std::vector<int> rest;
+
+	for (int id=0; id<size; ++id) {
+		if (!picked(id) && accept(id))
+			rest.push_back(id);
+	}
+
+	std::shuffle(rest.begin(), rest.end(), *g);
+
+	for (auto it = rest.cbegin(); it != rest.cend() && (int) list.size() < count; ++it)
+		list.push_back(*it);
+
+	return list;
+}
+
+
 #endif // STORAGESEED_H
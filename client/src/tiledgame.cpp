@@ -33,8 +33,9 @@
 #include "rpgenemyiface.h"
 #include "tiledspritehandler.h"
 #include "tileddebugdraw.h"
+#include "tiledpathfinder.h"
+#include "tiledprofiler.h"
 #include "utils_.h"
-#include "libtcod/path.hpp"
 #include <libtiled/objectgroup.h>
 #include <libtiled/mapreader.h>
 #include <libtiled/map.h>
@@ -43,6 +44,9 @@
 #include <tilelayeritem.h>
 #include <chipmunk/chipmunk.h>
 #include <chipmunk/chipmunk_structs.h>
+#include <QThreadPool>
+#include <QStandardPaths>
+#include <future>
 
 
 #ifndef Q_OS_WASM
@@ -51,6 +55,10 @@
 
 typedef std::unique_ptr<cpSpace, void (*)(cpSpace*)> unique_space_ptr;
 
+
+#define SCENE_REDUCED_STEP			4				// Inactive scenes step in every 4th tick
+#define SCENE_BENCHMARK_INTERVAL	600				// Log per-scene step cost in every 10 seconds
+
 /**
  * @brief The TiledGamePrivate class
  */
@@ -76,15 +84,16 @@ private:
 		~Scene() { destroyScene(); }
 
 		struct TcodMapData {
-			std::unique_ptr<TCODMap> map;
 			QRectF viewport;
 			qreal chunkWidth = 0.;
 			qreal chunkHeight = 0.;
+			mutable TiledPathFinder pathFinder;
 
 			QPoint getChunk(const cpVect &pos) const;
 			QPoint getChunk(const qreal &x, const qreal &y) const;
 
 			QPointF chunkMiddle(const int &x, const int &y) const;
+			QRect getChunks(const cpBB &bb) const;
 
 			std::optional<QPolygonF> findShortestPath(const cpVect &from, const cpVect &to) const;
 			std::optional<QPolygonF> findShortestPath(const qreal &x1, const qreal &y1, const qreal &x2, const qreal &y2) const;
@@ -96,13 +105,28 @@ private:
 		static void spaceDestroy(cpSpace *space);
 
 		void reloadTcodMap();
+		void updateTcodMap(const cpBB &bb);
+		void rasterizeTcodMap(const QRect &chunks);
 		void destroyScene();
+		bool isAwake() const;
+
+		enum Activity {
+			ActivityActive = 0,					// current scene, stepped in every tick
+			ActivityReduced,					// awake bodies in an off-screen scene, stepped at reduced rate
+			ActivityFrozen						// no awake bodies, space not stepped (bodies still get worldStep)
+		};
 
 		int sceneId = -1;
 		QQuickItem *container = nullptr;
 		TiledScene *scene = nullptr;
 		unique_space_ptr space;
 		TcodMapData tcodMap;
+
+		Activity activity = ActivityActive;
+		qint64 lastStepTick = -1;
+		int pendingSteps = 0;
+		qint64 stepNsec = 0;
+		int stepCount = 0;
 	};
 
 
@@ -155,7 +179,8 @@ private:
 
 	void updateObjects();
 
-	void stepWorlds();
+	void stepWorlds(const qint64 &tick);
+	void logStepStatistics();
 
 
 	/// Collision
@@ -179,16 +204,22 @@ private:
 	TiledGame *const q;
 
 	qint64 m_currentFrame = 0;
+	qreal m_stepInterpolation = 1.;
 	QRecursiveMutex m_stepMutex;
 
 	std::vector<std::unique_ptr<Scene>> m_sceneList;
 	std::vector<std::unique_ptr<TiledObjectBody> > m_bodyList;
+	QHash<const cpSpace*, int> m_bodySteps;				// worldStep count of the bodies in the current tick (by scene space)
 
 	std::vector<TiledObjectBody*> m_removeBodyList;
 
+	TiledLineOfSight m_lineOfSight;
+
 	int m_nextBodyId = 0;
 	KeyboardJoystickState m_keyboardJoystickState;
 	static std::unordered_map<QString, std::unique_ptr<QSGTexture>> m_sharedTextures;
+	static QHash<QString, std::shared_future<QImage>> m_decodedImages;
+	static QMutex m_textureMutex;						// GUI thread (preload) and render thread (upload)
 
 	bool m_messageEnabled = true;
 
@@ -197,6 +228,8 @@ private:
 
 
 std::unordered_map<QString, std::unique_ptr<QSGTexture>> TiledGamePrivate::m_sharedTextures;
+QHash<QString, std::shared_future<QImage>> TiledGamePrivate::m_decodedImages;
+QMutex TiledGamePrivate::m_textureMutex;
 
 
 
@@ -419,43 +452,113 @@ Tiled::TileLayer *TiledGame::loadSceneLayer(TiledScene *scene, Tiled::Layer *lay
 
 /**
  * @brief TiledGame::getTexture
+ * Small images are placed into the shared atlas of the scene graph, so sprites of different
+ * sheets can be batched. QSGSimpleTextureNode maps the source rect into the atlas.
  * @param path
  * @return
  */
 
 QSGTexture *TiledGame::getTexture(const QString &path, QQuickWindow *window)
 {
-	auto it = TiledGamePrivate::m_sharedTextures.find(path);
+	const QString key = QDir::cleanPath(path);
 
-	if (it != TiledGamePrivate::m_sharedTextures.end())
-		return it->second.get();
+	std::shared_future<QImage> decoded;
 
-	if (!window) {
-		LOG_CERROR("scene") << "Can't create texture:" << path;
-		return nullptr;
+	{
+		QMutexLocker locker(&TiledGamePrivate::m_textureMutex);
+
+		auto it = TiledGamePrivate::m_sharedTextures.find(key);
+
+		if (it != TiledGamePrivate::m_sharedTextures.end())
+			return it->second.get();
+
+		if (!window) {
+			LOG_CERROR("scene") << "Can't create texture:" << path;
+			return nullptr;
+		}
+
+		if (auto dIt = TiledGamePrivate::m_decodedImages.find(key); dIt != TiledGamePrivate::m_decodedImages.end()) {
+			decoded = dIt.value();
+			TiledGamePrivate::m_decodedImages.erase(dIt);
+		}
+	}
+
+	// Waiting for the decoder and uploading happen without holding the lock
+
+	QImage image;
+
+	if (decoded.valid()) {
+		image = decoded.get();
+	} else {
+		LOG_CTRACE("scene") << "Image not preloaded:" << key;
+		image = QImage(key);
 	}
 
-	QSGTexture *texture = window->createTextureFromImage(QImage(path));
+	QSGTexture *texture = window->createTextureFromImage(image, QQuickWindow::TextureCanUseAtlas);
 
-	LOG_CTRACE("scene") << "Create texture from image:" << path << texture;
+	LOG_CTRACE("scene") << "Create texture from image:" << key << texture << (texture && texture->isAtlasTexture() ? "(atlas)" : "");
 
 	std::unique_ptr<QSGTexture> s(texture);
 
-	const auto &ptr = TiledGamePrivate::m_sharedTextures.insert({path, std::move(s)});
+	QMutexLocker locker(&TiledGamePrivate::m_textureMutex);
 
-	Q_ASSERT(ptr.second);
+	// Created by an other window in the meantime: the existing one is kept
+
+	const auto &ptr = TiledGamePrivate::m_sharedTextures.insert({key, std::move(s)});
 
 	return ptr.first->second.get();
 }
 
 
+
+/**
+ * @brief TiledGame::preloadTextures
+ * Decode images on the global thread pool, getTexture() only uploads them
+ * @param paths
+ */
+
+void TiledGame::preloadTextures(const QStringList &paths)
+{
+#ifdef Q_OS_WASM
+	Q_UNUSED(paths);
+#else
+	QMutexLocker locker(&TiledGamePrivate::m_textureMutex);
+
+	for (const QString &p : paths) {
+		const QString key = QDir::cleanPath(p);
+
+		if (TiledGamePrivate::m_sharedTextures.contains(key) || TiledGamePrivate::m_decodedImages.contains(key))
+			continue;
+
+		auto promise = std::make_shared<std::promise<QImage>>();
+
+		TiledGamePrivate::m_decodedImages.insert(key, promise->get_future().share());
+
+		QThreadPool::globalInstance()->start([key, promise]() {
+			QImage image(key);
+
+			if (image.isNull())
+				LOG_CWARNING("scene") << "Image decode failed:" << key;
+			else
+				image.convertTo(QImage::Format_RGBA8888_Premultiplied);
+
+			promise->set_value(std::move(image));
+		});
+	}
+#endif
+}
+
+
 /**
  * @brief TiledGame::clearSharedTextures
  */
 
 void TiledGame::clearSharedTextures()
 {
+	QMutexLocker locker(&TiledGamePrivate::m_textureMutex);
+
 	TiledGamePrivate::m_sharedTextures.clear();
+	TiledGamePrivate::m_decodedImages.clear();
 }
 
 
@@ -853,6 +956,8 @@ void TiledGame::timerEvent(QTimerEvent */*event*/)
 
 void TiledGame::synchronize()
 {
+	TILED_PROFILE_SCOPE("synchronize");
+
 	QMutexLocker locker(&d->m_stepMutex);
 
 	for (const auto &ptr : std::as_const(d->m_bodyList)) {
@@ -862,12 +967,18 @@ void TiledGame::synchronize()
 
 	locker.unlock();
 
-	for (const auto &ptr : std::as_const(d->m_sceneList)) {
-		ptr->scene->reorderObjectsZ(d->getObjects<TiledObjectBody>(ptr->scene));
+	// Off-screen scenes are not visible, Z order is updated when they become current
+
+	if (!m_currentScene)
+		return;
 
-		if (ptr->scene->m_debugDraw)
-			ptr->scene->m_debugDraw->update();
+	{
+		TILED_PROFILE_SCOPE("reorderObjectsZ");
+		m_currentScene->reorderObjectsZ(d->getObjects<TiledObjectBody>(m_currentScene));
 	}
+
+	if (m_currentScene->m_debugDraw)
+		m_currentScene->m_debugDraw->update();
 }
 
 
@@ -894,6 +1005,18 @@ void TiledGame::overrideCurrentFrame(const qint64 &frame)
 }
 
 
+/**
+ * @brief TiledGame::stepInterpolation
+ * Render position between the last two world steps (0: previous step, 1: last step)
+ * @return
+ */
+
+const qreal &TiledGame::stepInterpolation() const
+{
+	return d->m_stepInterpolation;
+}
+
+
 /**
  * @brief TiledGame::loadTiledLayer
  * @param scene
@@ -993,6 +1116,11 @@ void TiledGame::keyPressEvent(QKeyEvent *event)
 		case Qt::Key_P:
 			setDebugView(!m_debugView);
 			break;
+
+		case Qt::Key_O:
+			if (const QString &file = exportProfilerTrace(); !file.isEmpty())
+				messageColor(tr("Trace exported: %1").arg(file), Qt::green);
+			break;
 #endif
 	}
 
@@ -1256,8 +1384,13 @@ void TiledGame::updateStepTimer()
 
 	const qint64 frames = currentTick - d->m_currentFrame;
 
-	if (frames <= 0)
+	if (frames <= 0) {
+		// No new world step, only move visual items between the last two states
+
+		updateStepInterpolation(currentTick);
+		interpolate();
 		return;
+	}
 
 	QElapsedTimer timer1;
 	timer1.start();
@@ -1267,16 +1400,21 @@ void TiledGame::updateStepTimer()
 
 	timeStepPrepareEvent();
 
+	d->m_lineOfSight.beginFrame(currentTick);
+
 	for (qint64 tick=currentTick-frames+1; tick<=currentTick; ++tick) {
 		timeBeforeWorldStepEvent(tick);
 
-		d->stepWorlds();
+		d->stepWorlds(tick);
 
 		timeAfterWorldStepEvent(tick);
 	}
 
 	d->m_currentFrame = currentTick;
 
+	if (currentTick / SCENE_BENCHMARK_INTERVAL != (currentTick-frames) / SCENE_BENCHMARK_INTERVAL)
+		d->logStepStatistics();
+
 	if (frames > 12)
 		LOG_CERROR("scene") << "Render lag:" << frames << "frames";
 	else if (frames > 8)
@@ -1295,10 +1433,39 @@ void TiledGame::updateStepTimer()
 		LOG_CDEBUG("scene") << "[Benchmark] worldstep  " << t << "ms /" << frames << "frames";
 	}
 
+	updateStepInterpolation(currentTick);
 	synchronize();
 }
 
 
+
+/**
+ * @brief TiledGame::updateStepInterpolation
+ * @param currentTick
+ */
+
+void TiledGame::updateStepInterpolation(const qint64 &currentTick)
+{
+	d->m_stepInterpolation = std::clamp(m_tickTimer->currentTickF() - currentTick, 0., 1.);
+}
+
+
+
+/**
+ * @brief TiledGame::interpolate
+ */
+
+void TiledGame::interpolate()
+{
+	QMutexLocker locker(&d->m_stepMutex);
+
+	for (const auto &ptr : std::as_const(d->m_bodyList)) {
+		if (ptr->scene() == m_currentScene)
+			ptr->interpolate();
+	}
+}
+
+
 /**
  * @brief TiledGame::addObject
  * @param bodyPtr
@@ -2247,6 +2414,7 @@ void TiledGamePrivate::updateObjects()
 	if (!m_removeBodyList.empty()) {
 		for (auto it = m_bodyList.begin(); it != m_bodyList.end(); ) {
 			if (std::find(m_removeBodyList.cbegin(), m_removeBodyList.cend(), it->get()) != m_removeBodyList.cend()) {
+				m_lineOfSight.remove(it->get());
 				it->get()->deleteBody();
 
 				if (dynamic_cast<QObject*>(it->get()))
@@ -2268,39 +2436,133 @@ void TiledGamePrivate::updateObjects()
 
 /**
  * @brief TiledGamePrivate::stepWorlds
+ * The current scene is stepped in every tick, other scenes only if they have awake bodies.
+ * Reduced scenes catch up in every SCENE_REDUCED_STEP tick with fixed 1/60 substeps.
+ * Frozen scenes skip only cpSpaceStep: their bodies still get worldStep in every tick,
+ * so an enemy can start patrolling and snapshots are applied, which wakes up the scene.
+ * @param tick
  */
 
-void TiledGamePrivate::stepWorlds()
+void TiledGamePrivate::stepWorlds(const qint64 &tick)
 {
+	TILED_PROFILE_SCOPE("stepWorlds");
+
 	QMutexLocker locker(&m_stepMutex);
 
+	int maxSteps = 1;
+
 	for (const auto &ptr : std::as_const(m_sceneList)) {
-		cpSpaceStep(ptr->space.get(), 1./60.);
+		ptr->pendingSteps = 0;
+
+		if (ptr->scene == q->m_currentScene) {
+			ptr->activity = Scene::ActivityActive;
+			ptr->pendingSteps = 1;
+			ptr->lastStepTick = tick;
+		} else if (!ptr->isAwake()) {
+			ptr->activity = Scene::ActivityFrozen;
+			ptr->lastStepTick = tick;
+		} else {
+			ptr->activity = Scene::ActivityReduced;
 
-		for (const auto &e : m_collisionBeginList) {
-			if (e.bodyA)
-				e.bodyA->onShapeContactBegin(e.shapeA, e.shapeB);
-			if (e.bodyB)
-				e.bodyB->onShapeContactBegin(e.shapeB, e.shapeA);
+			if (ptr->lastStepTick < 0 || tick - ptr->lastStepTick >= SCENE_REDUCED_STEP) {
+				ptr->pendingSteps = ptr->lastStepTick >= 0 ? std::min<qint64>(tick - ptr->lastStepTick, SCENE_REDUCED_STEP) : 1;
+				ptr->lastStepTick = tick;
+				maxSteps = std::max(maxSteps, ptr->pendingSteps);
+			}
 		}
 
-		for (const auto &e : m_collisionEndList) {
-			if (e.bodyA)
-				e.bodyA->onShapeContactEnd(e.shapeA, e.shapeB);
-			if (e.bodyB)
-				e.bodyB->onShapeContactEnd(e.shapeB, e.shapeA);
-		}
+		// Skipped ticks of reduced scenes are caught up later, frozen scenes step their bodies only
 
-		m_collisionBeginList.clear();
-		m_collisionEndList.clear();
+		m_bodySteps.insert(ptr->space.get(), ptr->activity == Scene::ActivityFrozen ? 1 : ptr->pendingSteps);
 	}
 
-	for (const auto &ptr : std::as_const(m_bodyList)) {
-		if (ptr)
+	QElapsedTimer timer;
+
+	for (int step=0; step<maxSteps; ++step) {
+		for (const auto &ptr : std::as_const(m_sceneList)) {
+			if (step >= ptr->pendingSteps)
+				continue;
+
+			timer.start();
+
+			{
+				TILED_PROFILE_SCOPE("cpSpaceStep");
+				cpSpaceStep(ptr->space.get(), 1./60.);
+			}
+
+			ptr->stepNsec += timer.nsecsElapsed();
+			++ptr->stepCount;
+
+			for (const auto &e : m_collisionBeginList) {
+				if (e.bodyA)
+					e.bodyA->onShapeContactBegin(e.shapeA, e.shapeB);
+				if (e.bodyB)
+					e.bodyB->onShapeContactBegin(e.shapeB, e.shapeA);
+			}
+
+			for (const auto &e : m_collisionEndList) {
+				if (e.bodyA)
+					e.bodyA->onShapeContactEnd(e.shapeA, e.shapeB);
+				if (e.bodyB)
+					e.bodyB->onShapeContactEnd(e.shapeB, e.shapeA);
+			}
+
+			m_collisionBeginList.clear();
+			m_collisionEndList.clear();
+		}
+
+		for (const auto &ptr : std::as_const(m_bodyList)) {
+			if (!ptr || step >= m_bodySteps.value(ptr->space(), 1))
+				continue;
+
+#ifdef TILED_PROFILER
+			const QObject *o = dynamic_cast<QObject*>(ptr.get());
+			TILED_PROFILE_SCOPE(o ? o->metaObject()->className() : "worldStep");
+#endif
+			ptr->publishTransform();
 			q->worldStep(ptr.get());
+		}
 	}
 
-	q->worldStep();
+	{
+		TILED_PROFILE_SCOPE("worldStep");
+		q->worldStep();
+	}
+}
+
+
+
+/**
+ * @brief TiledGamePrivate::logStepStatistics
+ * Log average step cost of the scenes since the last call
+ */
+
+void TiledGamePrivate::logStepStatistics()
+{
+	static const QStringList activityNames = {
+		QStringLiteral("active"),
+		QStringLiteral("reduced"),
+		QStringLiteral("frozen")
+	};
+
+	for (const auto &ptr : std::as_const(m_sceneList)) {
+		LOG_CTRACE("scene") << "[Benchmark] scene" << ptr->sceneId << qPrintable(activityNames.value(ptr->activity))
+							<< "steps:" << ptr->stepCount
+							<< "avg:" << (ptr->stepCount > 0 ? ptr->stepNsec / ptr->stepCount / 1000 : 0) << "us"
+							<< "total:" << ptr->stepNsec / 1000000 << "ms";
+
+		ptr->stepNsec = 0;
+		ptr->stepCount = 0;
+	}
+
+	const TiledLineOfSight::Statistics &los = m_lineOfSight.statistics();
+
+	LOG_CTRACE("scene") << "[Benchmark] line of sight requests:" << los.requests
+						<< "cached:" << los.cacheHits
+						<< "segment queries:" << los.segmentQueries
+						<< "max/frame:" << los.maxFrameQueries;
+
+	m_lineOfSight.resetStatistics();
 }
 
 
@@ -2336,6 +2598,36 @@ void TiledGame::reloadTcodMap(cpSpace *space)
 	}
 
 	it->get()->reloadTcodMap();
+	d->m_lineOfSight.invalidate();
+}
+
+
+
+/**
+ * @brief TiledGame::updateTcodMap
+ * @param space
+ * @param bb
+ */
+
+void TiledGame::updateTcodMap(cpSpace *space, const cpBB &bb)
+{
+	if (!space)
+		return;
+
+	QMutexLocker locker(&d->m_stepMutex);
+
+	auto it = std::find_if(d->m_sceneList.begin(),
+						   d->m_sceneList.end(), [space](const auto &ptr) {
+		return ptr->space.get() == space;
+	});
+
+	if (it == d->m_sceneList.end()) {
+		LOG_CERROR("scene") << "Invalid space" << space;
+		return;
+	}
+
+	it->get()->updateTcodMap(bb);
+	d->m_lineOfSight.invalidate();
 }
 
 
@@ -2349,6 +2641,8 @@ void TiledGame::reloadTcodMap(cpSpace *space)
 
 std::optional<QPolygonF> TiledGame::findShortestPath(TiledObjectBody *body, const cpVect &to) const
 {
+	TILED_PROFILE_SCOPE("findShortestPath");
+
 	if (!body)
 		return std::nullopt;
 
@@ -2384,7 +2678,7 @@ std::optional<QPolygonF> TiledGame::findShortestPath(TiledObjectBody *body, cons
 
 	const QPoint destChunk = it->get()->tcodMap.getChunk(to);
 
-	if (!it->get()->tcodMap.map->isWalkable(destChunk.x(), destChunk.y()))
+	if (!it->get()->tcodMap.pathFinder.isWalkable(destChunk.x(), destChunk.y()))
 		return std::nullopt;
 
 
@@ -2409,7 +2703,7 @@ std::optional<QPolygonF> TiledGame::findShortestPath(TiledObjectBody *body, cons
 					int chunkX = baseChunk.x() + n*x;
 					int chunkY = baseChunk.y() + n*y;
 
-					if (!it->get()->tcodMap.map->isInBounds(chunkX, chunkY))
+					if (!it->get()->tcodMap.pathFinder.isInBounds(chunkX, chunkY))
 						continue;
 
 					const cpVect &pos = TiledObjectBody::toVect(it->get()->tcodMap.chunkMiddle(chunkX, chunkY));
@@ -2461,6 +2755,91 @@ std::optional<QPolygonF> TiledGame::findShortestPath(TiledObjectBody *body, cons
 
 
 
+/**
+ * @brief TiledGame::lineOfSight
+ * Cached line of sight between two bodies (see TiledLineOfSight)
+ * @param from
+ * @param to
+ * @return
+ */
+
+TiledLineOfSight::Result TiledGame::lineOfSight(const TiledObjectBody *from, const TiledObjectBody *to) const
+{
+	TILED_PROFILE_SCOPE("lineOfSight");
+
+	QMutexLocker locker(&d->m_stepMutex);
+	return d->m_lineOfSight.query(from, to);
+}
+
+
+
+/**
+ * @brief TiledGame::segmentQueries
+ * Number of space segment queries in the last frame
+ * @return
+ */
+
+int TiledGame::segmentQueries() const
+{
+	return d->m_lineOfSight.segmentQueries();
+}
+
+
+
+/**
+ * @brief TiledGame::profilerReport
+ * Frame time percentiles of the instrumented scopes (empty in release builds)
+ * @return
+ */
+
+QString TiledGame::profilerReport() const
+{
+#ifdef TILED_PROFILER
+	return TiledProfiler::instance()->report();
+#else
+	return {};
+#endif
+}
+
+
+/**
+ * @brief TiledGame::exportProfilerTrace
+ * Export the profiler ring buffer as Chrome trace JSON into the temp directory
+ * @return
+ */
+
+QString TiledGame::exportProfilerTrace() const
+{
+#ifdef TILED_PROFILER
+	const QString file = QStandardPaths::writableLocation(QStandardPaths::TempLocation) +
+						 QStringLiteral("/callofsuli-trace-%1.json").arg(QDateTime::currentMSecsSinceEpoch());
+
+	if (!TiledProfiler::instance()->exportTrace(file)) {
+		LOG_CERROR("scene") << "Trace export failed:" << qPrintable(file);
+		return {};
+	}
+
+	LOG_CINFO("scene") << "Trace exported:" << qPrintable(file);
+
+	return file;
+#else
+	return {};
+#endif
+}
+
+
+
+/**
+ * @brief TiledGame::countSegmentQuery
+ */
+
+void TiledGame::countSegmentQuery()
+{
+	d->m_lineOfSight.countSegmentQuery();
+}
+
+
+
 /**
  * @brief TiledGamePrivate::Scene::TcodMapData::getChunk
  * @param pos
@@ -2510,6 +2889,22 @@ QPointF TiledGamePrivate::Scene::TcodMapData::chunkMiddle(const int &x, const in
 
 
 
+/**
+ * @brief TiledGamePrivate::Scene::TcodMapData::getChunks
+ * @param bb
+ * @return
+ */
+
+QRect TiledGamePrivate::Scene::TcodMapData::getChunks(const cpBB &bb) const
+{
+	const QPoint topLeft = getChunk(bb.l, bb.b);
+	const QPoint bottomRight = getChunk(bb.r, bb.t);
+
+	return QRect(topLeft, bottomRight).intersected(QRect(0, 0, pathFinder.width(), pathFinder.height()));
+}
+
+
+
 /**
  * @brief TiledGamePrivate::Scene::TcodMapData::findShortestPath
  * @param from
@@ -2538,52 +2933,31 @@ std::optional<QPolygonF> TiledGamePrivate::Scene::TcodMapData::findShortestPath(
 	if (qFuzzyCompare(x1, x2) && qFuzzyCompare(y1, y2))
 		return std::nullopt;
 
-	if (!map)
-		return std::nullopt;
-
-	//TCODPath path(m_tcodMap.map.get());
-	TCODDijkstra path(map.get(), 1.0);
-
 	const QPoint ch1 = getChunk(x1, y1);
 	const QPoint ch2 = getChunk(x2, y2);
 
-	const int chX1 = ch1.x();
-	const int chX2 = ch2.x();
-	const int chY1 = ch1.y();
-	const int chY2 = ch2.y();
-
-	if (!map->isInBounds(chX1, chY1) ||
-			!map->isInBounds(chX2, chY2))
-		return std::nullopt;
-
-	if (!map->isWalkable(chX1, chY1))
+	if (!pathFinder.isWalkable(ch1.x(), ch1.y()) ||
+			!pathFinder.isInBounds(ch2.x(), ch2.y()))
 		return std::nullopt;
 
 	// Ha közel vagyunk (same chunk), nem is számolunk
 
-	if (chX1 == chX2 && chY1 == chY2)
+	if (ch1 == ch2)
 		return QPolygonF() << QPointF(x1, y1) << QPointF(x2, y2);
 
-	path.compute(chX1, chY1);
+	const auto &path = pathFinder.findPath(ch1, ch2);
 
-	if (!path.setPath(chX2, chY2))
+	if (!path)
 		return std::nullopt;
 
 	QPolygonF polygon;
 
+	polygon << QPointF(x1, y1);
 
-	for (int i=0; i<path.size()-1; ++i) {
-		int x, y;
-		path.get(i, &x, &y);
-
-		// Ha az első chunk ugyanaz, mint amiben vagyunk (elvileg mindig)
-		if (i == 0 && x == chX1 && y == chY1)
-			polygon << QPointF(x1, y1);
-		else
-			polygon << chunkMiddle(x, y);
-	}
+	// Csak a fordulópontok, az első és az utolsó chunk közepe helyett a valódi pozíciók
 
-	// Az utolsó chunk közepe helyett a végleges pozíciót adjuk meg
+	for (auto it = path->cbegin()+1; it+1 < path->cend(); ++it)
+		polygon << chunkMiddle(it->x(), it->y());
 
 	polygon << QPointF(x2, y2);
 
@@ -2683,8 +3057,7 @@ void TiledGamePrivate::Scene::reloadTcodMap()
 		return;
 	}
 
-
-	tcodMap.map.reset();
+	tcodMap.pathFinder.reset(0, 0);
 
 	if (scene && !scene->viewport().isEmpty()) {
 		LOG_CTRACE("scene") << "Replace viewport" << space.get() << scene->viewport();
@@ -2707,46 +3080,108 @@ void TiledGamePrivate::Scene::reloadTcodMap()
 	tcodMap.chunkWidth = tcodMap.viewport.width() / wSize;
 	tcodMap.chunkHeight = tcodMap.viewport.height() / hSize;
 
-	tcodMap.map.reset(new TCODMap(wSize, hSize));
+	tcodMap.pathFinder.reset(wSize, hSize);
 
-	Q_ASSERT(tcodMap.map.get());
+	rasterizeTcodMap(QRect(0, 0, wSize, hSize));
 
-	tcodMap.map->clear(true, true);
+	tcodMap.pathFinder.rebuild();
+}
 
-	for (int i=0; i<wSize; ++i) {
-		for (int j=0; j<hSize; ++j) {
-			cpShape *chunk = cpBoxShapeNew(NULL,
-										   tcodMap.chunkWidth,
-										   tcodMap.chunkHeight,
-										   0);
-			cpTransform tr = cpTransformIdentity;
-			tr.tx = tcodMap.viewport.left() + tcodMap.chunkWidth*(i+0.5);
-			tr.ty = tcodMap.viewport.top() + tcodMap.chunkHeight*(j+0.5);
-			cpShapeUpdate(chunk, tr);
 
 
-			struct _d {
-				int i, j;
-				TCODMap *map;
-			};
+/**
+ * @brief TiledGamePrivate::Scene::updateTcodMap
+ * Update only the chunks touched by bb (gate opened or closed)
+ * @param bb
+ */
 
-			_d d;
-			d.i = i;
-			d.j = j;
-			d.map = tcodMap.map.get();
+void TiledGamePrivate::Scene::updateTcodMap(const cpBB &bb)
+{
+	if (!space || cpSpaceIsLocked(space.get())) {
+		LOG_CERROR("scene") << "Missing or locked space" << this;
+		return;
+	}
 
-			static const auto fn = [](cpShape *shape, cpContactPointSet *, void *data) {
-				if (cpShapeGetFilter(shape).categories & TiledObjectBody::FixtureGround) {
-					_d *d = (_d*)(data);
-					d->map->setProperties(d->i, d->j, true, false);
-				}
-			};
+	if (tcodMap.pathFinder.width() <= 0 || tcodMap.pathFinder.height() <= 0)
+		return reloadTcodMap();
 
-			cpSpaceShapeQuery(space.get(), chunk, fn, &d);
+	const QRect chunks = tcodMap.getChunks(bb);
 
-			cpShapeFree(chunk);
-		}
+	if (chunks.isEmpty())
+		return;
+
+	rasterizeTcodMap(chunks);
+
+	tcodMap.pathFinder.rebuild(chunks);
+}
+
+
+
+/**
+ * @brief TiledGamePrivate::Scene::rasterizeTcodMap
+ * Rasterize ground shapes into the walkability grid.
+ * Only the ground shapes overlapping the chunks are visited, and each of them is tested
+ * against the chunks covered by its bounding box.
+ * @param chunks
+ */
+
+void TiledGamePrivate::Scene::rasterizeTcodMap(const QRect &chunks)
+{
+	const QRect rect = chunks.intersected(QRect(0, 0, tcodMap.pathFinder.width(), tcodMap.pathFinder.height()));
+
+	if (rect.isEmpty())
+		return;
+
+	for (int i=rect.left(); i<=rect.right(); ++i) {
+		for (int j=rect.top(); j<=rect.bottom(); ++j)
+			tcodMap.pathFinder.setWalkable(i, j, true);
 	}
+
+	struct _d {
+		TcodMapData *map;
+		QRect rect;
+		cpShape *chunk;
+	};
+
+	_d d;
+	d.map = &tcodMap;
+	d.rect = rect;
+	d.chunk = cpBoxShapeNew(NULL, tcodMap.chunkWidth, tcodMap.chunkHeight, 0);
+
+	static const auto fn = [](cpShape *shape, void *data) {
+		if (!(cpShapeGetFilter(shape).categories & TiledObjectBody::FixtureGround))
+			return;
+
+		_d *d = (_d*)(data);
+
+		const QRect cells = d->map->getChunks(cpShapeGetBB(shape)).intersected(d->rect);
+
+		for (int i=cells.left(); i<=cells.right(); ++i) {
+			for (int j=cells.top(); j<=cells.bottom(); ++j) {
+				if (!d->map->pathFinder.isWalkable(i, j))
+					continue;
+
+				const QPointF &middle = d->map->chunkMiddle(i, j);
+
+				cpTransform tr = cpTransformIdentity;
+				tr.tx = middle.x();
+				tr.ty = middle.y();
+				cpShapeUpdate(d->chunk, tr);
+
+				if (cpShapesCollide(shape, d->chunk).count > 0)
+					d->map->pathFinder.setWalkable(i, j, false);
+			}
+		}
+	};
+
+	const cpBB bb = cpBBNew(tcodMap.viewport.left() + rect.left() * tcodMap.chunkWidth,
+							tcodMap.viewport.top() + rect.top() * tcodMap.chunkHeight,
+							tcodMap.viewport.left() + (rect.right()+1) * tcodMap.chunkWidth,
+							tcodMap.viewport.top() + (rect.bottom()+1) * tcodMap.chunkHeight);
+
+	cpSpaceBBQuery(space.get(), bb, CP_SHAPE_FILTER_ALL, fn, &d);
+
+	cpShapeFree(d.chunk);
 }
 
 
@@ -2764,6 +3199,34 @@ void TiledGamePrivate::Scene::destroyScene()
 
 
 
+/**
+ * @brief TiledGamePrivate::Scene::isAwake
+ * Scene is awake if any non-static body is moving (patrolling enemy, player entering, bullet,...)
+ * @return
+ */
+
+bool TiledGamePrivate::Scene::isAwake() const
+{
+	if (!space)
+		return false;
+
+	bool awake = false;
+
+	cpSpaceEachBody(space.get(), [](cpBody *body, void *data) {
+		bool *ptr = static_cast<bool*>(data);
+
+		if (*ptr || cpBodyGetType(body) == CP_BODY_TYPE_STATIC)
+			return;
+
+		if (cpvlengthsq(cpBodyGetVelocity(body)) > 0.01)
+			*ptr = true;
+	}, &awake);
+
+	return awake;
+}
+
+
+
 
 
 /**
@@ -31,6 +31,7 @@
 #include "tiledscene.h"
 #include "abstractgame.h"
 #include "tiledrotationmotor.h"
+#include "tiledlineofsight.h"
 #include <QQuickItem>
 #include <QSerializer>
 
@@ -131,6 +132,7 @@ public:
 	Tiled::TileLayer *loadSceneLayer(TiledScene *scene, Tiled::Layer *layer, Tiled::MapRenderer *renderer);
 
 	static QSGTexture *getTexture(const QString &path, QQuickWindow *window);
+	static void preloadTextures(const QStringList &paths);
 	static void clearSharedTextures();
 
 	QVector<TiledScene*> sceneList() const;
@@ -238,12 +240,24 @@ public:
 			reloadTcodMap(scene->m_space);
 	}
 
+	void updateTcodMap(cpSpace *space, const cpBB &bb);
+	void updateTcodMap(TiledScene *scene, const cpBB &bb) {
+		if (scene && scene->m_space)
+			updateTcodMap(scene->m_space, bb);
+	}
+
 
 	void iterateOverBodies(const std::function<void(TiledObjectBody*)> &func);
 
 	std::optional<QPolygonF> findShortestPath(TiledObjectBody *body, const cpVect &to) const;
 	std::optional<QPolygonF> findShortestPath(TiledObjectBody *body, const qreal &x2, const qreal &y2) const;
 
+	TiledLineOfSight::Result lineOfSight(const TiledObjectBody *from, const TiledObjectBody *to) const;
+	int segmentQueries() const;
+
+	Q_INVOKABLE QString profilerReport() const;
+	Q_INVOKABLE QString exportProfilerTrace() const;
+
 	AbstractGame::TickTimer *tickTimer() const { return m_tickTimer.get(); }
 	void setTickTimer(std::unique_ptr<AbstractGame::TickTimer> &timer) { m_tickTimer = std::move(timer); }
 
@@ -318,6 +332,8 @@ protected:
 	const qint64 &currentFrame() const;
 	void overrideCurrentFrame(const qint64 &frame);
 
+	const qreal &stepInterpolation() const;
+
 
 	virtual void loadTileLayer(TiledScene *scene, Tiled::TileLayer *layer, Tiled::MapRenderer *renderer);
 	virtual void loadObjectLayer(TiledScene *scene, Tiled::MapObject *object, const QString &groupClass, Tiled::MapRenderer *renderer);
@@ -351,6 +367,9 @@ private:
 	Q_INVOKABLE void updateJoystick();
 	void updateKeyboardJoystick();
 	void updateStepTimer();
+	void updateStepInterpolation(const qint64 &currentTick);
+	void interpolate();
+	void countSegmentQuery();
 
 
 	QPointer<QQuickItem> m_joystick = nullptr;
@@ -368,6 +387,7 @@ private:
 
 	friend class TiledGamePrivate;
 	friend class TiledScene;
+	friend class TiledObjectBody;
 };
 
 
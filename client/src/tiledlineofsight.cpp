@@ -0,0 +1,228 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * tiledlineofsight.cpp
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * TiledLineOfSight
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "tiledlineofsight.h"
+#include "tiledobject.h"
+#include <QVarLengthArray>
+
+
+#define LINE_OF_SIGHT_THRESHOLD		4.				// Cached result is valid while the bodies move less than 4 px
+#define LINE_OF_SIGHT_EXPIRE		60				// Unused results are dropped after 60 ticks
+#define LINE_OF_SIGHT_RADIUS		7.				// Same as TiledObjectBody::rayCast()
+
+
+
+/**
+ * @brief TiledLineOfSight::query
+ * @param from
+ * @param to
+ * @return
+ */
+
+TiledLineOfSight::Result TiledLineOfSight::query(const TiledObjectBody *from, const TiledObjectBody *to)
+{
+	++m_statistics.requests;
+
+	if (!from || !to || from == to || !from->body() || !to->body())
+		return {};
+
+	cpSpace *space = cpBodyGetSpace(from->body());
+
+	if (!space || space != cpBodyGetSpace(to->body()))
+		return {};
+
+	// Symmetric pairs share the same entry
+
+	const bool swapped = to < from;
+	const TiledObjectBody *a = swapped ? to : from;
+	const TiledObjectBody *b = swapped ? from : to;
+
+	const cpVect posA = a->bodyPosition();
+	const cpVect posB = b->bodyPosition();
+
+	static const cpFloat thresholdSq = LINE_OF_SIGHT_THRESHOLD * LINE_OF_SIGHT_THRESHOLD;
+
+	auto it = m_cache.find(Key(a, b));
+
+	if (it != m_cache.end() &&
+			cpvdistsq(it->positionA, posA) <= thresholdSq &&
+			cpvdistsq(it->positionB, posB) <= thresholdSq) {
+		++m_statistics.cacheHits;
+	} else {
+		Entry entry;
+		entry.positionA = posA;
+		entry.positionB = posB;
+
+		cast(a, b, &entry);
+
+		countSegmentQuery();
+		++m_statistics.segmentQueries;
+
+		it = m_cache.insert(Key(a, b), entry);
+	}
+
+	it->tick = m_tick;
+
+	Result r;
+	r.hit = it->hit;
+	r.visible = it->hit && it->visible;
+	r.walkable = it->hit && it->walkable;
+	r.point = swapped ? it->pointOnA : it->pointOnB;
+
+	return r;
+}
+
+
+
+/**
+ * @brief TiledLineOfSight::beginFrame
+ * @param tick
+ */
+
+void TiledLineOfSight::beginFrame(const qint64 &tick)
+{
+	m_tick = tick;
+	m_lastFrameQueries = m_frameQueries;
+	m_frameQueries = 0;
+
+	if (m_lastFrameQueries > m_statistics.maxFrameQueries)
+		m_statistics.maxFrameQueries = m_lastFrameQueries;
+
+	for (auto it = m_cache.begin(); it != m_cache.end(); ) {
+		if (it->tick + LINE_OF_SIGHT_EXPIRE < tick)
+			it = m_cache.erase(it);
+		else
+			++it;
+	}
+}
+
+
+
+/**
+ * @brief TiledLineOfSight::remove
+ * @param body
+ */
+
+void TiledLineOfSight::remove(const TiledObjectBody *body)
+{
+	for (auto it = m_cache.begin(); it != m_cache.end(); ) {
+		if (it.key().first == body || it.key().second == body)
+			it = m_cache.erase(it);
+		else
+			++it;
+	}
+}
+
+
+
+/**
+ * @brief TiledLineOfSight::cast
+ * Cast one segment from a to b, the result is stored for both directions
+ * @param a
+ * @param b
+ * @param entry
+ * @return
+ */
+
+bool TiledLineOfSight::cast(const TiledObjectBody *a, const TiledObjectBody *b, Entry *entry)
+{
+	Q_ASSERT(entry);
+
+	cpBitmask mask = TiledObjectBody::FixtureGround;
+
+	for (cpShape *sh : a->bodyShapes())
+		mask |= cpShapeGetFilter(sh).categories;
+
+	for (cpShape *sh : b->bodyShapes())
+		mask |= cpShapeGetFilter(sh).categories;
+
+
+	struct Hit {
+		cpShape *shape = nullptr;
+		cpVect point;
+		cpFloat alpha = 0.;
+	};
+
+	QVarLengthArray<Hit, 16> hits;
+
+	static const auto fn = [](cpShape *shape, cpVect point, cpVect, cpFloat alpha, void *data) {
+		QVarLengthArray<Hit, 16> *hits = (QVarLengthArray<Hit, 16>*) data;
+		hits->append(Hit{shape, point, alpha});
+	};
+
+	cpSpaceSegmentQuery(cpBodyGetSpace(a->body()),
+						entry->positionA, entry->positionB,
+						LINE_OF_SIGHT_RADIUS,
+						cpShapeFilter{CP_NO_GROUP, CP_ALL_CATEGORIES, mask},
+						fn,
+						&hits);
+
+	const Hit *target = nullptr;
+
+	for (const Hit &h : hits) {
+		if (cpShapeGetBody(h.shape) == b->body() && (!target || h.alpha < target->alpha))
+			target = &h;
+	}
+
+	entry->hit = target;
+	entry->visible = true;
+	entry->walkable = true;
+
+	if (!target)
+		return false;
+
+	entry->pointOnB = target->point;
+
+	for (const Hit &h : hits) {
+		if (h.alpha >= target->alpha || !(cpShapeGetFilter(h.shape).categories & TiledObjectBody::FixtureGround))
+			continue;
+
+		if (cpShapeGetBody(h.shape) == a->body() || cpShapeGetBody(h.shape) == b->body())
+			continue;
+
+		entry->walkable = false;
+
+		if (TiledObjectBody *body = TiledObjectBody::fromShapeRef(h.shape); body && body->opaque())
+			entry->visible = false;
+	}
+
+
+	// Nearest point of a seen from b (single shape queries, no space query)
+
+	entry->pointOnA = entry->positionA;
+	cpFloat alpha = INFINITY;
+
+	for (cpShape *sh : a->bodyShapes()) {
+		cpSegmentQueryInfo info;
+
+		if (cpShapeSegmentQuery(sh, entry->positionB, entry->positionA, LINE_OF_SIGHT_RADIUS, &info) && info.alpha < alpha) {
+			alpha = info.alpha;
+			entry->pointOnA = info.point;
+		}
+	}
+
+	return true;
+}
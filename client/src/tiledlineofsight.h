@@ -0,0 +1,109 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * tiledlineofsight.h
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * TiledLineOfSight
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILEDLINEOFSIGHT_H
+#define TILEDLINEOFSIGHT_H
+
+#include <QHash>
+#include <chipmunk/chipmunk.h>
+
+class TiledObjectBody;
+
+
+/**
+ * @brief The TiledLineOfSight class
+ *
+ * Line of sight between two bodies, shared by the player and the enemies.
+ *
+ *  - A pair is cast only once in both directions (player->enemy and enemy->player)
+ *  - Results are cached until one of the bodies moves more than a threshold
+ *  - The number of space segment queries are counted per frame
+ */
+
+class TiledLineOfSight
+{
+public:
+	TiledLineOfSight() = default;
+
+	/**
+	 * @brief The Result class
+	 */
+
+	struct Result {
+		bool hit = false;					// target reached by the ray
+		bool visible = false;				// no opaque ground between the bodies
+		bool walkable = false;				// no ground between the bodies
+		cpVect point = cpvzero;				// nearest point of the target seen from the querying body
+	};
+
+	Result query(const TiledObjectBody *from, const TiledObjectBody *to);
+
+	void beginFrame(const qint64 &tick);
+	void remove(const TiledObjectBody *body);
+	void invalidate() { m_cache.clear(); }
+
+	void countSegmentQuery() { ++m_frameQueries; }
+	int segmentQueries() const { return m_lastFrameQueries; }
+
+
+	/**
+	 * @brief The Statistics class
+	 */
+
+	struct Statistics {
+		int requests = 0;
+		int cacheHits = 0;
+		int segmentQueries = 0;
+		int maxFrameQueries = 0;
+	};
+
+	const Statistics &statistics() const { return m_statistics; }
+	void resetStatistics() { m_statistics = Statistics(); }
+
+private:
+	typedef std::pair<const TiledObjectBody*, const TiledObjectBody*> Key;
+
+	struct Entry {
+		cpVect positionA = cpvzero;
+		cpVect positionB = cpvzero;
+		cpVect pointOnA = cpvzero;
+		cpVect pointOnB = cpvzero;
+		bool hit = false;
+		bool visible = false;
+		bool walkable = false;
+		qint64 tick = 0;
+	};
+
+	static bool cast(const TiledObjectBody *a, const TiledObjectBody *b, Entry *entry);
+
+	QHash<Key, Entry> m_cache;
+	qint64 m_tick = 0;
+	int m_frameQueries = 0;
+	int m_lastFrameQueries = 0;
+	Statistics m_statistics;
+};
+
+#endif // TILEDLINEOFSIGHT_H
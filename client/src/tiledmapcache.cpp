@@ -0,0 +1,219 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * tiledmapcache.cpp
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * TiledMapCache
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "tiledmapcache.h"
+#include "Logger.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <libtiled/map.h>
+#include <libtiled/mapreader.h>
+#include <libtiled/maptovariantconverter.h>
+#include <libtiled/varianttomapconverter.h>
+
+
+#define MAP_CACHE_MAGIC			0x43534d43		// "CSMC"
+#define MAP_CACHE_VERSION		1
+
+
+
+/**
+ * @brief TiledMapCache::readMap
+ * @param fileName
+ * @return
+ */
+
+std::unique_ptr<Tiled::Map> TiledMapCache::readMap(const QString &fileName)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	QFile f(fileName);
+
+	if (!f.open(QIODevice::ReadOnly)) {
+		LOG_CERROR("scene") << "Read error:" << qPrintable(fileName);
+		return nullptr;
+	}
+
+	const QByteArray content = f.readAll();
+
+	f.close();
+
+	const QByteArray checksum = QCryptographicHash::hash(content, QCryptographicHash::Sha1);
+	const QString cache = cacheFile(fileName);
+
+	if (!cache.isEmpty()) {
+		if (auto map = readCache(cache, fileName, checksum)) {
+			LOG_CTRACE("scene") << "Map loaded from cache:" << qPrintable(fileName) << timer.elapsed() << "ms";
+			return map;
+		}
+	}
+
+
+	Tiled::MapReader mapReader;
+
+	std::unique_ptr<Tiled::Map> map = mapReader.readMap(fileName);
+
+	if (!map) {
+		LOG_CERROR("scene") << "Map read error:" << qPrintable(fileName) << mapReader.errorString();
+		return nullptr;
+	}
+
+	LOG_CTRACE("scene") << "Map parsed:" << qPrintable(fileName) << timer.elapsed() << "ms";
+
+	if (!cache.isEmpty())
+		writeCache(cache, fileName, checksum, *map);
+
+	return map;
+}
+
+
+
+/**
+ * @brief TiledMapCache::cacheFile
+ * @param fileName
+ * @return
+ */
+
+QString TiledMapCache::cacheFile(const QString &fileName)
+{
+	const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+
+	if (dir.isEmpty())
+		return {};
+
+	return dir + QStringLiteral("/maps/") +
+			QString::fromLatin1(QCryptographicHash::hash(fileName.toUtf8(), QCryptographicHash::Sha1).toHex()) +
+			QStringLiteral(".bin");
+}
+
+
+
+/**
+ * @brief TiledMapCache::readCache
+ * @param cacheFile
+ * @param fileName
+ * @param checksum
+ * @return
+ */
+
+std::unique_ptr<Tiled::Map> TiledMapCache::readCache(const QString &cacheFile, const QString &fileName, const QByteArray &checksum)
+{
+	QFile f(cacheFile);
+
+	if (!f.exists() || !f.open(QIODevice::ReadOnly))
+		return nullptr;
+
+	QByteArray data;
+
+	if (uchar *ptr = f.map(0, f.size()))
+		data = QByteArray::fromRawData(reinterpret_cast<const char*>(ptr), f.size());
+	else
+		data = f.readAll();
+
+	QDataStream stream(data);
+	stream.setVersion(QDataStream::Qt_6_0);
+
+	quint32 magic = 0;
+	quint32 version = 0;
+	QByteArray sum;
+
+	stream >> magic >> version >> sum;
+
+	if (magic != MAP_CACHE_MAGIC || version != MAP_CACHE_VERSION || sum != checksum) {
+		LOG_CTRACE("scene") << "Map cache outdated:" << qPrintable(fileName);
+		return nullptr;
+	}
+
+	QVariant variant;
+	stream >> variant;
+
+	if (stream.status() != QDataStream::Ok) {
+		LOG_CWARNING("scene") << "Map cache corrupted:" << qPrintable(cacheFile);
+		return nullptr;
+	}
+
+	Tiled::VariantToMapConverter converter;
+
+	std::unique_ptr<Tiled::Map> map = converter.toMap(variant, QFileInfo(fileName).dir());
+
+	if (!map) {
+		LOG_CWARNING("scene") << "Map cache error:" << qPrintable(fileName) << converter.errorString();
+		return nullptr;
+	}
+
+	map->fileName = fileName;
+
+	return map;
+}
+
+
+
+/**
+ * @brief TiledMapCache::writeCache
+ * @param cacheFile
+ * @param fileName
+ * @param checksum
+ * @param map
+ * @return
+ */
+
+bool TiledMapCache::writeCache(const QString &cacheFile, const QString &fileName, const QByteArray &checksum, const Tiled::Map &map)
+{
+	if (!QDir().mkpath(QFileInfo(cacheFile).absolutePath())) {
+		LOG_CWARNING("scene") << "Can't create cache directory:" << qPrintable(cacheFile);
+		return false;
+	}
+
+	Tiled::MapToVariantConverter converter;
+
+	const QVariant variant = converter.toVariant(map, QFileInfo(fileName).dir());
+
+	QSaveFile f(cacheFile);
+
+	if (!f.open(QIODevice::WriteOnly)) {
+		LOG_CWARNING("scene") << "Can't write map cache:" << qPrintable(cacheFile);
+		return false;
+	}
+
+	QDataStream stream(&f);
+	stream.setVersion(QDataStream::Qt_6_0);
+
+	stream << (quint32) MAP_CACHE_MAGIC << (quint32) MAP_CACHE_VERSION << checksum << variant;
+
+	if (stream.status() != QDataStream::Ok || !f.commit()) {
+		LOG_CWARNING("scene") << "Can't write map cache:" << qPrintable(cacheFile);
+		return false;
+	}
+
+	LOG_CTRACE("scene") << "Map cache created:" << qPrintable(fileName) << "->" << qPrintable(cacheFile);
+
+	return true;
+}
@@ -0,0 +1,60 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * tiledmapcache.h
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * TiledMapCache
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILEDMAPCACHE_H
+#define TILEDMAPCACHE_H
+
+#include <QString>
+#include <QByteArray>
+#include <memory>
+
+namespace Tiled {
+class Map;
+}
+
+
+/**
+ * @brief The TiledMapCache class
+ *
+ * Binary cache of the parsed .tmx maps.
+ *
+ * The resolved map is converted with MapToVariantConverter (the same data model as the JSON map format,
+ * external tilesets are kept as references) and stored as QDataStream in the cache directory.
+ * The cache file is memory-mapped on load. The checksum of the .tmx invalidates the cache.
+ */
+
+class TiledMapCache
+{
+public:
+	static std::unique_ptr<Tiled::Map> readMap(const QString &fileName);
+
+private:
+	static QString cacheFile(const QString &fileName);
+	static std::unique_ptr<Tiled::Map> readCache(const QString &cacheFile, const QString &fileName, const QByteArray &checksum);
+	static bool writeCache(const QString &cacheFile, const QString &fileName, const QByteArray &checksum, const Tiled::Map &map);
+};
+
+#endif // TILEDMAPCACHE_H
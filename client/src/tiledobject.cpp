@@ -32,9 +32,11 @@
 #include "tiledscene.h"
 #include "tiledspritehandler.h"
 #include "tileddebugdraw.h"
+#include "tiledprofiler.h"
 #include <libtiled/maprenderer.h>
 #include <libtiled/objectgroup.h>
 #include <chipmunk/chipmunk_structs.h>
+#include <QVarLengthArray>
 
 
 #ifndef QT_NO_DEBUG
@@ -356,12 +358,7 @@ void TiledObject::synchronize()
 	if (!body() || !m_visualItem)
 		return;
 
-	const QPointF &pos = bodyPositionF();
-
-	QPointF offset(m_visualItem->width()/2, m_visualItem->height()/2);
-	offset += m_bodyOffset;
-
-	m_visualItem->setPosition(pos-offset);
+	interpolate();
 
 	if (!qFuzzyCompare(bodyRotation(), m_lastAngle))
 		emit currentAngleChanged();
@@ -381,6 +378,24 @@ void TiledObject::synchronize()
 
 
 
+/**
+ * @brief TiledObject::interpolate
+ * Move visual item to the interpolated body position
+ */
+
+void TiledObject::interpolate()
+{
+	if (!body() || !m_visualItem)
+		return;
+
+	QPointF offset(m_visualItem->width()/2, m_visualItem->height()/2);
+	offset += m_bodyOffset;
+
+	m_visualItem->setPosition(bodyPositionInterpolatedF()-offset);
+}
+
+
+
 /**
  * @brief TiledObject::onSpaceChanged
  */
@@ -573,6 +588,8 @@ void TiledObjectBody::setSpace(cpSpace *space)
 	if (d->m_targetCircle)
 		fn(d->m_bodyRef, d->m_targetCircle);
 
+	d->m_transformValid = false;
+
 	onSpaceChanged();
 }
 
@@ -1152,6 +1169,49 @@ cpVect TiledObjectBody::bodyPosition() const
 
 
 
+/**
+ * @brief TiledObjectBody::bodyPositionInterpolated
+ * Body position between the last two world steps (for rendering only)
+ * @return
+ */
+
+cpVect TiledObjectBody::bodyPositionInterpolated() const
+{
+	CHECK_BODY_X(cpvzero);
+
+	if (!d->m_transformValid || !m_game)
+		return cpBodyGetPosition(d->m_bodyRef);
+
+	return cpvlerp(d->m_prevPosition, d->m_currPosition, m_game->stepInterpolation());
+}
+
+
+
+/**
+ * @brief TiledObjectBody::publishTransform
+ * Store body position after a world step. Large jumps (teleport) aren't interpolated.
+ */
+
+void TiledObjectBody::publishTransform()
+{
+	if (!d->m_bodyRef)
+		return;
+
+	static constexpr cpFloat snapDistanceSq = POW2(64.);
+
+	const cpVect pos = cpBodyGetPosition(d->m_bodyRef);
+
+	if (!d->m_transformValid || cpvdistsq(pos, d->m_currPosition) > snapDistanceSq)
+		d->m_prevPosition = pos;
+	else
+		d->m_prevPosition = d->m_currPosition;
+
+	d->m_currPosition = pos;
+	d->m_transformValid = true;
+}
+
+
+
 TiledSpriteHandler *TiledObject::spriteHandlerAuxBack() const
 {
 	return m_spriteHandlerAuxBack;
@@ -1612,6 +1672,7 @@ void TiledObjectBody::emplace(const cpVect &center)
 	d->setVelocity(cpvzero);
 
 	d->m_currentSpeedSq = 0.;
+	d->m_transformValid = false;
 }
 
 
@@ -2109,6 +2170,8 @@ void TiledObjectBody::addTargetCircle(const float &length)
 
 RayCastInfo TiledObjectBody::rayCast(const cpVect &dest, const FixtureCategories &categories, const float &radius) const
 {
+	TILED_PROFILE_SCOPE("rayCast");
+
 	RayCastInfo list;
 
 	if (!d->m_bodyRef)
@@ -2117,10 +2180,12 @@ RayCastInfo TiledObjectBody::rayCast(const cpVect &dest, const FixtureCategories
 	const cpVect origin = cpBodyGetPosition(d->m_bodyRef);
 
 
-	QMap<cpFloat, RayCastInfoItem> map;
+	typedef QVarLengthArray<std::pair<cpFloat, RayCastInfoItem>, 16> HitList;
+
+	HitList map;
 
 	static const auto fn = [](cpShape *shape, cpVect point, cpVect, cpFloat alpha, void *data) {
-		QMap<cpFloat, RayCastInfoItem> *map = (QMap<cpFloat, RayCastInfoItem>*) data;
+		HitList *map = (HitList*) data;
 
 		RayCastInfoItem info {
 			.shape = shape,
@@ -2129,7 +2194,7 @@ RayCastInfo TiledObjectBody::rayCast(const cpVect &dest, const FixtureCategories
 					.walkable = false
 		};
 
-		map->insert(alpha, std::move(info));
+		map->append(std::make_pair(alpha, std::move(info)));
 	};
 
 	cpSpaceSegmentQuery(d->m_bodyRef->space,
@@ -2139,10 +2204,18 @@ RayCastInfo TiledObjectBody::rayCast(const cpVect &dest, const FixtureCategories
 						fn,
 						&map);
 
+	if (m_game)
+		m_game->countSegmentQuery();
+
+	std::stable_sort(map.begin(), map.end(), [](const auto &l, const auto &r) { return l.first < r.first; });
+
+	list.reserve(map.size());
+
 	bool visible = true;
 	bool walkable = true;
 
-	for (const RayCastInfoItem &i : map) {
+	for (const auto &p : map) {
+		const RayCastInfoItem &i = p.second;
 		const cpShapeFilter &filter = cpShapeGetFilter(i.shape);
 		TiledObjectBody *body = TiledObjectBody::fromShapeRef(i.shape);
 
@@ -179,6 +179,9 @@ public:
 	cpBody *body() const;
 	cpVect bodyPosition() const;
 	QPointF bodyPositionF() const { return toPointF(bodyPosition()); }
+
+	cpVect bodyPositionInterpolated() const;
+	QPointF bodyPositionInterpolatedF() const { return toPointF(bodyPositionInterpolated()); }
 	QRectF bodyAABB() const;
 	float currentSpeedSq() const;
 
@@ -268,6 +271,7 @@ public:
 
 protected:
 	virtual void synchronize() {}
+	virtual void interpolate() {}
 
 	virtual void onSpaceChanged();
 	void overrideCurrentSpeed(const cpVect &speed);
@@ -309,6 +313,7 @@ private:
 								 const cpBodyType &type = CP_BODY_TYPE_DYNAMIC);
 
 	void deleteBody();
+	void publishTransform();
 
 	TiledObjectBodyPrivate *d;
 	bool m_opaque = true;
@@ -527,6 +532,7 @@ protected:
 
 	void createVisual();
 	virtual void synchronize() override;
+	virtual void interpolate() override;
 	virtual void onSpaceChanged() override;
 
 	void updateVisibleArea();
@@ -81,6 +81,12 @@ private:
 
 	float m_currentSpeedSq = 0.;
 
+	// Body positions after the last two world steps (interpolated in synchronize)
+
+	cpVect m_prevPosition = cpvzero;
+	cpVect m_currPosition = cpvzero;
+	bool m_transformValid = false;
+
 	struct RotateAnimation {
 		bool running = false;
 		float destRadian = 0;
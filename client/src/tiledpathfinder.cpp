@@ -0,0 +1,1008 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * tiledpathfinder.cpp
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * TiledPathFinder
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "tiledpathfinder.h"
+#include <queue>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+
+#define FLOW_FIELD_CACHE_SIZE		8
+#define FLOW_FIELD_REQUEST_LIMIT	3				// Build flow field for the 3rd request of the same destination
+#define PORTAL_SPLIT_LENGTH			6				// Border openings longer than this get a portal at both ends
+
+
+namespace {
+
+static constexpr float DIAGONAL_COST = M_SQRT2;
+static constexpr float INFINITE_COST = std::numeric_limits<float>::infinity();
+
+typedef std::pair<float, int> QueueItem;
+typedef std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> Queue;
+
+}
+
+
+
+/**
+ * @brief TiledPathFinder::TiledPathFinder
+ * @param clusterSize
+ */
+
+TiledPathFinder::TiledPathFinder(const int &clusterSize)
+	: m_clusterSize(std::max(2, clusterSize))
+{
+
+}
+
+
+
+/**
+ * @brief TiledPathFinder::reset
+ * @param width
+ * @param height
+ * @param walkable
+ */
+
+void TiledPathFinder::reset(const int &width, const int &height, const bool &walkable)
+{
+	m_width = std::max(0, width);
+	m_height = std::max(0, height);
+
+	const int size = m_width*m_height;
+
+	m_walkable.assign(size, walkable);
+
+	m_cost.assign(size, INFINITE_COST);
+	m_parent.assign(size, -1);
+	m_visited.assign(size, 0);
+	m_closed.assign(size, 0);
+	m_searchId = 0;
+
+	m_clusterColumns = (m_width + m_clusterSize - 1) / m_clusterSize;
+	m_clusterRows = (m_height + m_clusterSize - 1) / m_clusterSize;
+
+	m_nodes.clear();
+	m_cellNode.clear();
+	m_clusterNodes.clear();
+	m_flowFields.clear();
+	m_destinationRequests.clear();
+}
+
+
+
+/**
+ * @brief TiledPathFinder::setWalkable
+ * The portal graph has to be rebuilt after changing walkability
+ * @param x
+ * @param y
+ * @param walkable
+ */
+
+void TiledPathFinder::setWalkable(const int &x, const int &y, const bool &walkable)
+{
+	if (!isInBounds(x, y))
+		return;
+
+	m_walkable[index(x, y)] = walkable;
+}
+
+
+
+/**
+ * @brief TiledPathFinder::rebuild
+ * Build the portal graph of the clusters
+ */
+
+void TiledPathFinder::rebuild()
+{
+	m_nodes.clear();
+	m_cellNode.clear();
+	m_clusterNodes.clear();
+	m_clusterNodes.resize(m_clusterColumns*m_clusterRows);
+	m_flowFields.clear();
+	m_destinationRequests.clear();
+
+	for (int cy=0; cy<m_clusterRows; ++cy) {
+		for (int cx=0; cx<m_clusterColumns; ++cx) {
+			const QRect r = clusterRect(cy*m_clusterColumns+cx);
+
+			if (cx+1 < m_clusterColumns) {
+				const QRect side(r.right(), r.top(), 1, r.height());
+				addPortals(side, side.translated(1, 0));
+			}
+
+			if (cy+1 < m_clusterRows) {
+				const QRect side(r.left(), r.bottom(), r.width(), 1);
+				addPortals(side, side.translated(0, 1));
+			}
+		}
+	}
+
+	for (int i=0; i<(int) m_clusterNodes.size(); ++i)
+		connectCluster(i);
+}
+
+
+
+/**
+ * @brief TiledPathFinder::rebuild
+ * Rebuild only the clusters overlapping area (walkability changed there): their portals are
+ * recreated, the neighbouring clusters are reconnected with the new entrances
+ * @param area
+ */
+
+void TiledPathFinder::rebuild(const QRect &area)
+{
+	const QRect rect = area.intersected(QRect(0, 0, m_width, m_height));
+
+	if (rect.isEmpty())
+		return;
+
+	const int count = m_clusterColumns*m_clusterRows;
+
+	if ((int) m_clusterNodes.size() != count)
+		return rebuild();
+
+	m_flowFields.clear();
+	m_destinationRequests.clear();
+
+	std::vector<bool> dirty(count, false);
+	std::vector<bool> touched(count, false);
+
+	const auto fnTouch = [this, &touched](const int &cx, const int &cy) {
+		if (cx >= 0 && cy >= 0 && cx < m_clusterColumns && cy < m_clusterRows)
+			touched[cy*m_clusterColumns+cx] = true;
+	};
+
+	for (int cy=rect.top()/m_clusterSize; cy<=rect.bottom()/m_clusterSize; ++cy) {
+		for (int cx=rect.left()/m_clusterSize; cx<=rect.right()/m_clusterSize; ++cx) {
+			dirty[cy*m_clusterColumns+cx] = true;
+			fnTouch(cx, cy);
+			fnTouch(cx-1, cy);
+			fnTouch(cx+1, cy);
+			fnTouch(cx, cy-1);
+			fnTouch(cx, cy+1);
+		}
+	}
+
+
+	// Drop the nodes of the dirty clusters and the intra-cluster edges of the touched ones.
+	// A node of a neighbouring cluster survives only if it is still an entrance to a clean cluster.
+
+	std::vector<bool> removed(m_nodes.size(), false);
+
+	for (int i=0; i<(int) m_nodes.size(); ++i) {
+		if (dirty[m_nodes.at(i).cluster])
+			removed[i] = true;
+	}
+
+	for (int i=0; i<(int) m_nodes.size(); ++i) {
+		Node &node = m_nodes[i];
+
+		if (removed[i] || !touched[node.cluster])
+			continue;
+
+		std::erase_if(node.edges, [this, &node, &removed](const Edge &e) {
+			return removed[e.node] || m_nodes.at(e.node).cluster == node.cluster;
+		});
+
+		if (node.edges.empty())
+			removed[i] = true;
+	}
+
+	removeNodes(removed);
+
+
+	// Entrances of the dirty clusters (borders between two dirty clusters only once)
+
+	for (int cy=0; cy<m_clusterRows; ++cy) {
+		for (int cx=0; cx<m_clusterColumns; ++cx) {
+			const int cluster = cy*m_clusterColumns+cx;
+
+			if (!dirty[cluster])
+				continue;
+
+			const QRect r = clusterRect(cluster);
+
+			if (cx+1 < m_clusterColumns) {
+				const QRect side(r.right(), r.top(), 1, r.height());
+				addPortals(side, side.translated(1, 0));
+			}
+
+			if (cy+1 < m_clusterRows) {
+				const QRect side(r.left(), r.bottom(), r.width(), 1);
+				addPortals(side, side.translated(0, 1));
+			}
+
+			if (cx > 0 && !dirty[cluster-1]) {
+				const QRect side(r.left()-1, r.top(), 1, r.height());
+				addPortals(side, side.translated(1, 0));
+			}
+
+			if (cy > 0 && !dirty[cluster-m_clusterColumns]) {
+				const QRect side(r.left(), r.top()-1, r.width(), 1);
+				addPortals(side, side.translated(0, 1));
+			}
+		}
+	}
+
+	for (int i=0; i<count; ++i) {
+		if (touched[i])
+			connectCluster(i);
+	}
+}
+
+
+
+/**
+ * @brief TiledPathFinder::findPath
+ * @param from
+ * @param to
+ * @return
+ */
+
+std::optional<std::vector<QPoint> > TiledPathFinder::findPath(const QPoint &from, const QPoint &to)
+{
+	++m_statistics.requests;
+
+	if (!isWalkable(from.x(), from.y()) || !isWalkable(to.x(), to.y()))
+		return std::nullopt;
+
+	const int fromIdx = index(from.x(), from.y());
+	const int toIdx = index(to.x(), to.y());
+
+	if (fromIdx == toIdx)
+		return std::vector<QPoint>{from};
+
+	std::vector<int> path;
+
+	// Cached flow field (or destination requested frequently)
+
+	auto it = std::find_if(m_flowFields.begin(), m_flowFields.end(), [toIdx](const FlowField &f) {
+		return f.destination == toIdx;
+	});
+
+	const FlowField *field = nullptr;
+
+	if (it != m_flowFields.end()) {
+		m_flowFields.splice(m_flowFields.begin(), m_flowFields, it);
+		field = &m_flowFields.front();
+		++m_statistics.flowFieldHits;
+	} else {
+		if (m_destinationRequests.size() > 1024)
+			m_destinationRequests.clear();
+
+		if (++m_destinationRequests[toIdx] >= FLOW_FIELD_REQUEST_LIMIT)
+			field = flowField(toIdx);
+	}
+
+	if (field) {
+		if (followFlowField(*field, fromIdx, &path))
+			return simplify(path);
+		else
+			return std::nullopt;
+	}
+
+
+	// Same cluster
+
+	const int clusterFrom = clusterOf(fromIdx);
+	const int clusterTo = clusterOf(toIdx);
+
+	if (clusterFrom == clusterTo && search(fromIdx, toIdx, clusterRect(clusterFrom), &path))
+		return simplify(path);
+
+
+	// Short distance: plain A*
+
+	const int dx = std::abs(from.x()-to.x());
+	const int dy = std::abs(from.y()-to.y());
+
+	if (m_nodes.empty() || std::max(dx, dy) <= 2*m_clusterSize) {
+		++m_statistics.gridSearches;
+
+		if (search(fromIdx, toIdx, QRect(0, 0, m_width, m_height), &path))
+			return simplify(path);
+
+		return std::nullopt;
+	}
+
+
+	// HPA*
+
+	++m_statistics.abstractSearches;
+
+	if (searchAbstract(fromIdx, toIdx, &path))
+		return simplify(path);
+
+	++m_statistics.gridSearches;
+
+	if (search(fromIdx, toIdx, QRect(0, 0, m_width, m_height), &path))
+		return simplify(path);
+
+	return std::nullopt;
+}
+
+
+
+/**
+ * @brief TiledPathFinder::clusterOf
+ * @param cell
+ * @return
+ */
+
+int TiledPathFinder::clusterOf(const int &cell) const
+{
+	const int x = cell % m_width;
+	const int y = cell / m_width;
+
+	return (y / m_clusterSize) * m_clusterColumns + (x / m_clusterSize);
+}
+
+
+/**
+ * @brief TiledPathFinder::clusterRect
+ * @param cluster
+ * @return
+ */
+
+QRect TiledPathFinder::clusterRect(const int &cluster) const
+{
+	const int x = (cluster % m_clusterColumns) * m_clusterSize;
+	const int y = (cluster / m_clusterColumns) * m_clusterSize;
+
+	return QRect(x, y,
+				 std::min(m_clusterSize, m_width-x),
+				 std::min(m_clusterSize, m_height-y));
+}
+
+
+
+/**
+ * @brief TiledPathFinder::addNode
+ * @param cell
+ * @return
+ */
+
+int TiledPathFinder::addNode(const int &cell)
+{
+	if (const auto it = m_cellNode.find(cell); it != m_cellNode.cend())
+		return it->second;
+
+	const int id = m_nodes.size();
+
+	Node &node = m_nodes.emplace_back();
+	node.cell = cell;
+	node.cluster = clusterOf(cell);
+
+	m_clusterNodes[node.cluster].push_back(id);
+	m_cellNode[cell] = id;
+
+	return id;
+}
+
+
+
+/**
+ * @brief TiledPathFinder::removeNodes
+ * Remove the marked nodes and the edges pointing to them, node ids are compacted
+ * @param removed
+ */
+
+void TiledPathFinder::removeNodes(const std::vector<bool> &removed)
+{
+	std::vector<int> remap(m_nodes.size(), -1);
+	std::vector<Node> list;
+	list.reserve(m_nodes.size());
+
+	for (int i=0; i<(int) m_nodes.size(); ++i) {
+		if (removed.at(i))
+			continue;
+
+		remap[i] = list.size();
+		list.push_back(std::move(m_nodes[i]));
+	}
+
+	m_nodes = std::move(list);
+	m_cellNode.clear();
+
+	for (std::vector<int> &c : m_clusterNodes)
+		c.clear();
+
+	for (int i=0; i<(int) m_nodes.size(); ++i) {
+		Node &node = m_nodes[i];
+
+		std::erase_if(node.edges, [&remap](const Edge &e) { return remap.at(e.node) < 0; });
+
+		for (Edge &e : node.edges)
+			e.node = remap.at(e.node);
+
+		m_clusterNodes[node.cluster].push_back(i);
+		m_cellNode[node.cell] = i;
+	}
+}
+
+
+
+/**
+ * @brief TiledPathFinder::addPortals
+ * Create portals for every opening along the border of two clusters
+ * @param side1
+ * @param side2
+ */
+
+void TiledPathFinder::addPortals(const QRect &side1, const QRect &side2)
+{
+	const bool vertical = side1.width() == 1;
+	const int length = vertical ? side1.height() : side1.width();
+
+	const auto fnCell = [&](const QRect &side, const int &i) {
+		return vertical ? index(side.left(), side.top()+i) : index(side.left()+i, side.top());
+	};
+
+	const auto fnConnect = [this, &fnCell, &side1, &side2](const int &i) {
+		const int n1 = addNode(fnCell(side1, i));
+		const int n2 = addNode(fnCell(side2, i));
+		m_nodes[n1].edges.push_back(Edge{n2, 1.});
+		m_nodes[n2].edges.push_back(Edge{n1, 1.});
+	};
+
+	int start = -1;
+
+	for (int i=0; i<=length; ++i) {
+		const bool open = i < length && m_walkable[fnCell(side1, i)] && m_walkable[fnCell(side2, i)];
+
+		if (open && start < 0)
+			start = i;
+
+		if (open || start < 0)
+			continue;
+
+		const int end = i-1;
+
+		if (end-start+1 >= PORTAL_SPLIT_LENGTH) {
+			fnConnect(start);
+			fnConnect(end);
+		} else {
+			fnConnect((start+end)/2);
+		}
+
+		start = -1;
+	}
+}
+
+
+
+/**
+ * @brief TiledPathFinder::connectCluster
+ * Connect the portals of the cluster with their distances inside the cluster
+ * @param cluster
+ */
+
+void TiledPathFinder::connectCluster(const int &cluster)
+{
+	const std::vector<int> &list = m_clusterNodes.at(cluster);
+
+	if (list.size() < 2)
+		return;
+
+	const QRect rect = clusterRect(cluster);
+
+	std::vector<int> targets;
+	targets.reserve(list.size());
+
+	for (const int &n : list)
+		targets.push_back(m_nodes.at(n).cell);
+
+	std::vector<float> dist;
+
+	for (int i=0; i<(int) list.size(); ++i) {
+		distances(targets.at(i), rect, targets, &dist);
+
+		for (int j=0; j<(int) list.size(); ++j) {
+			if (i == j || dist.at(j) == INFINITE_COST)
+				continue;
+
+			m_nodes[list.at(i)].edges.push_back(Edge{list.at(j), dist.at(j)});
+		}
+	}
+}
+
+
+
+/**
+ * @brief TiledPathFinder::forEachNeighbour
+ * Walkable neighbours inside bounds, diagonal steps only if both sides are walkable
+ * @param cell
+ * @param bounds
+ * @param func
+ */
+
+template<typename T>
+void TiledPathFinder::forEachNeighbour(const int &cell, const QRect &bounds, T func) const
+{
+	static constexpr int dirs[8][2] = {
+		{ 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 },
+		{ 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 }
+	};
+
+	const int x = cell % m_width;
+	const int y = cell / m_width;
+
+	for (int i=0; i<8; ++i) {
+		const int nx = x + dirs[i][0];
+		const int ny = y + dirs[i][1];
+
+		if (!bounds.contains(nx, ny) || !m_walkable[index(nx, ny)])
+			continue;
+
+		if (i < 4) {
+			func(index(nx, ny), 1.f);
+		} else if (m_walkable[index(nx, y)] && m_walkable[index(x, ny)]) {
+			func(index(nx, ny), DIAGONAL_COST);
+		}
+	}
+}
+
+
+
+/**
+ * @brief TiledPathFinder::search
+ * A* search inside bounds
+ * @param from
+ * @param to
+ * @param bounds
+ * @param path
+ * @param cost
+ * @return
+ */
+
+bool TiledPathFinder::search(const int &from, const int &to, const QRect &bounds, std::vector<int> *path, float *cost)
+{
+	if (++m_searchId == 0) {
+		std::fill(m_visited.begin(), m_visited.end(), 0);
+		std::fill(m_closed.begin(), m_closed.end(), 0);
+		m_searchId = 1;
+	}
+
+	const quint32 id = m_searchId;
+
+	Queue queue;
+
+	m_cost[from] = 0.;
+	m_parent[from] = -1;
+	m_visited[from] = id;
+	queue.emplace(heuristic(from, to), from);
+
+	while (!queue.empty()) {
+		const int current = queue.top().second;
+		queue.pop();
+
+		if (m_closed[current] == id)
+			continue;
+
+		m_closed[current] = id;
+
+		if (current == to) {
+			if (path) {
+				path->clear();
+
+				for (int c = to; c != -1; c = m_parent[c])
+					path->push_back(c);
+
+				std::reverse(path->begin(), path->end());
+			}
+
+			if (cost)
+				*cost = m_cost[to];
+
+			return true;
+		}
+
+		const float g = m_cost[current];
+
+		forEachNeighbour(current, bounds, [&](const int &n, const float &w) {
+			if (m_closed[n] == id)
+				return;
+
+			const float ng = g + w;
+
+			if (m_visited[n] != id || ng < m_cost[n]) {
+				m_visited[n] = id;
+				m_cost[n] = ng;
+				m_parent[n] = current;
+				queue.emplace(ng + heuristic(n, to), n);
+			}
+		});
+	}
+
+	return false;
+}
+
+
+
+/**
+ * @brief TiledPathFinder::distances
+ * Dijkstra search inside bounds, distances of targets are stored in dest (infinite if unreachable)
+ * @param from
+ * @param bounds
+ * @param targets
+ * @param dest
+ */
+
+void TiledPathFinder::distances(const int &from, const QRect &bounds, const std::vector<int> &targets, std::vector<float> *dest)
+{
+	Q_ASSERT(dest);
+
+	if (++m_searchId == 0) {
+		std::fill(m_visited.begin(), m_visited.end(), 0);
+		std::fill(m_closed.begin(), m_closed.end(), 0);
+		m_searchId = 1;
+	}
+
+	const quint32 id = m_searchId;
+
+	Queue queue;
+
+	m_cost[from] = 0.;
+	m_visited[from] = id;
+	queue.emplace(0., from);
+
+	while (!queue.empty()) {
+		const int current = queue.top().second;
+		queue.pop();
+
+		if (m_closed[current] == id)
+			continue;
+
+		m_closed[current] = id;
+
+		const float g = m_cost[current];
+
+		forEachNeighbour(current, bounds, [&](const int &n, const float &w) {
+			if (m_closed[n] == id)
+				return;
+
+			const float ng = g + w;
+
+			if (m_visited[n] != id || ng < m_cost[n]) {
+				m_visited[n] = id;
+				m_cost[n] = ng;
+				queue.emplace(ng, n);
+			}
+		});
+	}
+
+	dest->resize(targets.size());
+
+	for (int i=0; i<(int) targets.size(); ++i)
+		(*dest)[i] = m_closed[targets.at(i)] == id ? m_cost[targets.at(i)] : INFINITE_COST;
+}
+
+
+
+/**
+ * @brief TiledPathFinder::searchAbstract
+ * HPA* search on the portal graph, then refine the path inside the clusters
+ * @param from
+ * @param to
+ * @param path
+ * @return
+ */
+
+bool TiledPathFinder::searchAbstract(const int &from, const int &to, std::vector<int> *path)
+{
+	Q_ASSERT(path);
+
+	const int clusterFrom = clusterOf(from);
+	const int clusterTo = clusterOf(to);
+
+	const std::vector<int> &startNodes = m_clusterNodes.at(clusterFrom);
+	const std::vector<int> &goalNodes = m_clusterNodes.at(clusterTo);
+
+	if (startNodes.empty() || goalNodes.empty())
+		return false;
+
+	std::vector<int> cells;
+	std::vector<float> startDist;
+	std::vector<float> goalDist;
+
+	for (const int &n : startNodes)
+		cells.push_back(m_nodes.at(n).cell);
+
+	distances(from, clusterRect(clusterFrom), cells, &startDist);
+
+	cells.clear();
+
+	for (const int &n : goalNodes)
+		cells.push_back(m_nodes.at(n).cell);
+
+	distances(to, clusterRect(clusterTo), cells, &goalDist);
+
+
+	const int nodeCount = m_nodes.size();
+	const int goal = nodeCount;						// virtual goal node
+
+	std::vector<float> g(nodeCount+1, INFINITE_COST);
+	std::vector<int> parent(nodeCount+1, -1);
+	std::vector<bool> closed(nodeCount+1, false);
+	std::vector<float> toGoal(nodeCount, INFINITE_COST);
+
+	for (int i=0; i<(int) goalNodes.size(); ++i)
+		toGoal[goalNodes.at(i)] = goalDist.at(i);
+
+	Queue queue;
+
+	for (int i=0; i<(int) startNodes.size(); ++i) {
+		if (startDist.at(i) == INFINITE_COST)
+			continue;
+
+		const int n = startNodes.at(i);
+		g[n] = startDist.at(i);
+		queue.emplace(g[n] + heuristic(m_nodes.at(n).cell, to), n);
+	}
+
+	bool found = false;
+
+	while (!queue.empty()) {
+		const int current = queue.top().second;
+		queue.pop();
+
+		if (current == goal) {
+			found = true;
+			break;
+		}
+
+		if (closed[current])
+			continue;
+
+		closed[current] = true;
+
+		if (toGoal[current] != INFINITE_COST && g[current] + toGoal[current] < g[goal]) {
+			g[goal] = g[current] + toGoal[current];
+			parent[goal] = current;
+			queue.emplace(g[goal], goal);
+		}
+
+		for (const Edge &e : m_nodes.at(current).edges) {
+			if (closed[e.node])
+				continue;
+
+			const float ng = g[current] + e.cost;
+
+			if (ng < g[e.node]) {
+				g[e.node] = ng;
+				parent[e.node] = current;
+				queue.emplace(ng + heuristic(m_nodes.at(e.node).cell, to), e.node);
+			}
+		}
+	}
+
+	if (!found)
+		return false;
+
+
+	// Refine
+
+	std::vector<int> waypoints;
+	waypoints.push_back(to);
+
+	for (int n = parent[goal]; n != -1; n = parent[n])
+		waypoints.push_back(m_nodes.at(n).cell);
+
+	waypoints.push_back(from);
+
+	std::reverse(waypoints.begin(), waypoints.end());
+
+	path->clear();
+	path->push_back(from);
+
+	std::vector<int> segment;
+
+	for (int i=1; i<(int) waypoints.size(); ++i) {
+		const int a = waypoints.at(i-1);
+		const int b = waypoints.at(i);
+
+		if (a == b)
+			continue;
+
+		const int dx = std::abs(a % m_width - b % m_width);
+		const int dy = std::abs(a / m_width - b / m_width);
+
+		if (dx + dy == 1) {
+			path->push_back(b);
+			continue;
+		}
+
+		const int cluster = clusterOf(a);
+		const QRect bounds = cluster == clusterOf(b) ? clusterRect(cluster) : QRect(0, 0, m_width, m_height);
+
+		if (!search(a, b, bounds, &segment))
+			return false;
+
+		path->insert(path->end(), segment.cbegin()+1, segment.cend());
+	}
+
+	return true;
+}
+
+
+
+/**
+ * @brief TiledPathFinder::flowField
+ * Build (or get from cache) the distance field to destination
+ * @param destination
+ * @return
+ */
+
+const TiledPathFinder::FlowField *TiledPathFinder::flowField(const int &destination)
+{
+	auto it = std::find_if(m_flowFields.begin(), m_flowFields.end(), [destination](const FlowField &f) {
+		return f.destination == destination;
+	});
+
+	if (it != m_flowFields.end()) {
+		m_flowFields.splice(m_flowFields.begin(), m_flowFields, it);
+		return &m_flowFields.front();
+	}
+
+	++m_statistics.flowFieldBuilds;
+
+	FlowField field;
+	field.destination = destination;
+	field.distance.assign(m_width*m_height, INFINITE_COST);
+
+	Queue queue;
+
+	field.distance[destination] = 0.;
+	queue.emplace(0., destination);
+
+	const QRect bounds(0, 0, m_width, m_height);
+
+	while (!queue.empty()) {
+		const auto [d, current] = queue.top();
+		queue.pop();
+
+		if (d > field.distance[current])
+			continue;
+
+		forEachNeighbour(current, bounds, [&](const int &n, const float &w) {
+			if (d + w < field.distance[n]) {
+				field.distance[n] = d + w;
+				queue.emplace(d + w, n);
+			}
+		});
+	}
+
+	m_flowFields.push_front(std::move(field));
+
+	while (m_flowFields.size() > FLOW_FIELD_CACHE_SIZE)
+		m_flowFields.pop_back();
+
+	return &m_flowFields.front();
+}
+
+
+
+/**
+ * @brief TiledPathFinder::followFlowField
+ * @param field
+ * @param from
+ * @param path
+ * @return
+ */
+
+bool TiledPathFinder::followFlowField(const FlowField &field, const int &from, std::vector<int> *path) const
+{
+	Q_ASSERT(path);
+
+	if (field.distance.at(from) == INFINITE_COST)
+		return false;
+
+	const QRect bounds(0, 0, m_width, m_height);
+
+	path->clear();
+	path->push_back(from);
+
+	for (int current = from; current != field.destination; ) {
+		int next = -1;
+		float best = field.distance.at(current);
+
+		forEachNeighbour(current, bounds, [&](const int &n, const float &) {
+			if (field.distance.at(n) < best) {
+				best = field.distance.at(n);
+				next = n;
+			}
+		});
+
+		if (next == -1 || (int) path->size() > m_width*m_height)
+			return false;
+
+		path->push_back(next);
+		current = next;
+	}
+
+	return true;
+}
+
+
+
+/**
+ * @brief TiledPathFinder::heuristic
+ * Octile distance
+ * @param from
+ * @param to
+ * @return
+ */
+
+float TiledPathFinder::heuristic(const int &from, const int &to) const
+{
+	const int dx = std::abs(from % m_width - to % m_width);
+	const int dy = std::abs(from / m_width - to / m_width);
+
+	return (dx + dy) + (DIAGONAL_COST - 2.f) * std::min(dx, dy);
+}
+
+
+
+/**
+ * @brief TiledPathFinder::simplify
+ * Keep only the turning points of the path
+ * @param path
+ * @return
+ */
+
+std::vector<QPoint> TiledPathFinder::simplify(const std::vector<int> &path) const
+{
+	std::vector<QPoint> list;
+
+	if (path.empty())
+		return list;
+
+	list.reserve(path.size());
+
+	QPoint last = point(path.front());
+	QPoint dir;
+
+	list.push_back(last);
+
+	for (auto it = path.cbegin()+1; it != path.cend(); ++it) {
+		const QPoint p = point(*it);
+		const QPoint d = p - last;
+
+		if (list.size() > 1 && d == dir)
+			list.back() = p;
+		else
+			list.push_back(p);
+
+		dir = d;
+		last = p;
+	}
+
+	return list;
+}
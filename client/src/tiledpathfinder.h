@@ -0,0 +1,152 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * tiledpathfinder.h
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * TiledPathFinder
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILEDPATHFINDER_H
+#define TILEDPATHFINDER_H
+
+#include <QPoint>
+#include <QRect>
+#include <vector>
+#include <list>
+#include <optional>
+#include <unordered_map>
+
+
+/**
+ * @brief The TiledPathFinder class
+ *
+ * Path finding over the walkability grid (chunks) of a scene
+ *
+ *  - A* with octile heuristic, 8 directions without corner cutting
+ *  - HPA*: the grid is divided into clusters, the cluster borders are connected with portals,
+ *    long paths are searched on the portal graph and refined inside the clusters
+ *  - Flow fields: destinations requested repeatedly (many enemies chasing the same player)
+ *    get a cached distance field, paths are read by walking down the field
+ */
+
+class TiledPathFinder
+{
+public:
+	TiledPathFinder(const int &clusterSize = 10);
+
+	void reset(const int &width, const int &height, const bool &walkable = true);
+
+	int width() const { return m_width; }
+	int height() const { return m_height; }
+
+	bool isInBounds(const int &x, const int &y) const { return x >= 0 && y >= 0 && x < m_width && y < m_height; }
+	bool isWalkable(const int &x, const int &y) const { return isInBounds(x, y) && m_walkable[index(x, y)]; }
+	void setWalkable(const int &x, const int &y, const bool &walkable);
+
+	void rebuild();
+	void rebuild(const QRect &area);
+
+	std::optional<std::vector<QPoint>> findPath(const QPoint &from, const QPoint &to);
+
+
+	/**
+	 * @brief The Statistics class
+	 */
+
+	struct Statistics {
+		int requests = 0;
+		int flowFieldHits = 0;
+		int flowFieldBuilds = 0;
+		int abstractSearches = 0;
+		int gridSearches = 0;
+	};
+
+	const Statistics &statistics() const { return m_statistics; }
+	void resetStatistics() { m_statistics = Statistics(); }
+
+private:
+	struct Edge {
+		int node = -1;
+		float cost = 0.;
+	};
+
+	struct Node {
+		int cell = -1;
+		int cluster = -1;
+		std::vector<Edge> edges;
+	};
+
+	struct FlowField {
+		int destination = -1;
+		std::vector<float> distance;
+	};
+
+	int index(const int &x, const int &y) const { return y*m_width+x; }
+	QPoint point(const int &idx) const { return QPoint(idx % m_width, idx / m_width); }
+
+	int clusterOf(const int &cell) const;
+	QRect clusterRect(const int &cluster) const;
+
+	int addNode(const int &cell);
+	void removeNodes(const std::vector<bool> &removed);
+	void addPortals(const QRect &side1, const QRect &side2);
+	void connectCluster(const int &cluster);
+
+	template <typename T>
+	void forEachNeighbour(const int &cell, const QRect &bounds, T func) const;
+
+	bool search(const int &from, const int &to, const QRect &bounds, std::vector<int> *path, float *cost = nullptr);
+	void distances(const int &from, const QRect &bounds, const std::vector<int> &targets, std::vector<float> *dest);
+
+	bool searchAbstract(const int &from, const int &to, std::vector<int> *path);
+	const FlowField *flowField(const int &destination);
+	bool followFlowField(const FlowField &field, const int &from, std::vector<int> *path) const;
+
+	float heuristic(const int &from, const int &to) const;
+	std::vector<QPoint> simplify(const std::vector<int> &path) const;
+
+	int m_width = 0;
+	int m_height = 0;
+	const int m_clusterSize;
+	int m_clusterColumns = 0;
+	int m_clusterRows = 0;
+
+	std::vector<bool> m_walkable;
+
+	std::vector<Node> m_nodes;
+	std::unordered_map<int, int> m_cellNode;
+	std::vector<std::vector<int>> m_clusterNodes;
+
+	// A* working buffers (reused between searches)
+
+	std::vector<float> m_cost;
+	std::vector<int> m_parent;
+	std::vector<quint32> m_visited;
+	std::vector<quint32> m_closed;
+	quint32 m_searchId = 0;
+
+	std::list<FlowField> m_flowFields;
+	std::unordered_map<int, int> m_destinationRequests;
+
+	Statistics m_statistics;
+};
+
+#endif // TILEDPATHFINDER_H
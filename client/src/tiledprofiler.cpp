@@ -0,0 +1,246 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * tiledprofiler.cpp
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * TiledProfiler
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "tiledprofiler.h"
+
+#ifdef TILED_PROFILER
+
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <algorithm>
+
+
+#define PROFILER_BUFFER_SIZE		(1 << 16)
+
+
+
+/**
+ * @brief TiledProfiler::TiledProfiler
+ */
+
+TiledProfiler::TiledProfiler()
+	: m_buffer(PROFILER_BUFFER_SIZE)
+{
+	m_timer.start();
+}
+
+
+/**
+ * @brief TiledProfiler::instance
+ * @return
+ */
+
+TiledProfiler *TiledProfiler::instance()
+{
+	static TiledProfiler profiler;
+	return &profiler;
+}
+
+
+
+/**
+ * @brief TiledProfiler::record
+ * @param name
+ * @param start
+ * @param duration
+ */
+
+void TiledProfiler::record(const char *name, const qint64 &start, const qint64 &duration)
+{
+	const quint64 thread = reinterpret_cast<quintptr>(QThread::currentThreadId());
+
+	QMutexLocker locker(&m_mutex);
+
+	Event &e = m_buffer[m_next++ % PROFILER_BUFFER_SIZE];
+	e.name = name;
+	e.start = start;
+	e.duration = duration;
+	e.thread = thread;
+}
+
+
+
+/**
+ * @brief TiledProfiler::events
+ * Snapshot of the ring buffer in recording order
+ * @return
+ */
+
+std::vector<TiledProfiler::Event> TiledProfiler::events() const
+{
+	std::vector<Event> list;
+
+	QMutexLocker locker(&m_mutex);
+
+	const quint64 next = m_next;
+	const quint64 count = std::min<quint64>(next, PROFILER_BUFFER_SIZE);
+
+	list.reserve(count);
+
+	for (quint64 i = next - count; i < next; ++i) {
+		const Event &e = m_buffer[i % PROFILER_BUFFER_SIZE];
+
+		if (e.name)
+			list.push_back(e);
+	}
+
+	return list;
+}
+
+
+
+/**
+ * @brief TiledProfiler::summary
+ * Percentiles of the events recorded in the last window nsecs
+ * @param window
+ * @return
+ */
+
+std::vector<TiledProfiler::Summary> TiledProfiler::summary(const qint64 &window) const
+{
+	const qint64 from = now() - window;
+
+	QHash<QByteArray, std::vector<qint64>> durations;
+
+	for (const Event &e : events()) {
+		if (e.start >= from)
+			durations[QByteArray(e.name)].push_back(e.duration);
+	}
+
+	std::vector<Summary> list;
+	list.reserve(durations.size());
+
+	for (auto it = durations.begin(); it != durations.end(); ++it) {
+		std::vector<qint64> &d = it.value();
+
+		std::sort(d.begin(), d.end());
+
+		const auto fnPercentile = [&d](const double &p) {
+			return d.at(std::min<size_t>(d.size()-1, p * d.size()));
+		};
+
+		Summary s;
+		s.name = it.key();
+		s.count = d.size();
+		s.p50 = fnPercentile(0.50);
+		s.p90 = fnPercentile(0.90);
+		s.p99 = fnPercentile(0.99);
+		s.max = d.back();
+
+		for (const qint64 &n : d)
+			s.total += n;
+
+		list.push_back(s);
+	}
+
+	std::sort(list.begin(), list.end(), [](const Summary &l, const Summary &r) { return l.total > r.total; });
+
+	return list;
+}
+
+
+
+/**
+ * @brief TiledProfiler::report
+ * Text table for the overlay (microseconds)
+ * @param window
+ * @return
+ */
+
+QString TiledProfiler::report(const qint64 &window) const
+{
+	QString txt = QStringLiteral("%1 %2 %3 %4 %5 %6\n")
+				  .arg(QStringLiteral("scope"), -28)
+				  .arg(QStringLiteral("n"), 6)
+				  .arg(QStringLiteral("p50"), 7)
+				  .arg(QStringLiteral("p90"), 7)
+				  .arg(QStringLiteral("p99"), 7)
+				  .arg(QStringLiteral("ms/s"), 7);
+
+	for (const Summary &s : summary(window)) {
+		txt += QStringLiteral("%1 %2 %3 %4 %5 %6\n")
+			   .arg(QString::fromLatin1(s.name.left(28)), -28)
+			   .arg(s.count, 6)
+			   .arg(s.p50 / 1000, 7)
+			   .arg(s.p90 / 1000, 7)
+			   .arg(s.p99 / 1000, 7)
+			   .arg((double) s.total / window * 1000., 7, 'f', 2);
+	}
+
+	return txt;
+}
+
+
+
+/**
+ * @brief TiledProfiler::exportTrace
+ * Export the ring buffer as Chrome trace event JSON
+ * @param fileName
+ * @return
+ */
+
+bool TiledProfiler::exportTrace(const QString &fileName) const
+{
+	QJsonArray list;
+	QHash<quint64, int> threads;
+
+	for (const Event &e : events()) {
+		auto it = threads.find(e.thread);
+
+		if (it == threads.end())
+			it = threads.insert(e.thread, threads.size()+1);
+
+		list.append(QJsonObject{
+						{ QStringLiteral("name"), QString::fromLatin1(e.name) },
+						{ QStringLiteral("cat"), QStringLiteral("game") },
+						{ QStringLiteral("ph"), QStringLiteral("X") },
+						{ QStringLiteral("ts"), e.start / 1000. },
+						{ QStringLiteral("dur"), e.duration / 1000. },
+						{ QStringLiteral("pid"), 1 },
+						{ QStringLiteral("tid"), it.value() },
+					});
+	}
+
+	QFile f(fileName);
+
+	if (!f.open(QIODevice::WriteOnly))
+		return false;
+
+	f.write(QJsonDocument(QJsonObject{
+							  { QStringLiteral("traceEvents"), list },
+							  { QStringLiteral("displayTimeUnit"), QStringLiteral("ms") }
+						  }).toJson(QJsonDocument::Compact));
+
+	f.close();
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * tiledprofiler.h
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * TiledProfiler
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILEDPROFILER_H
+#define TILEDPROFILER_H
+
+#include <QString>
+
+#ifndef QT_NO_DEBUG
+#define TILED_PROFILER
+#endif
+
+
+#ifdef TILED_PROFILER
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <vector>
+
+#define TILED_PROFILE_SCOPE(name)		TiledProfilerScope _tiledProfilerScope(name)
+
+
+/**
+ * @brief The TiledProfiler class
+ *
+ * Scoped frame time instrumentation of the game engine (debug builds only).
+ * Events are stored in a fixed size ring buffer (render and GUI thread, guarded by a mutex), summary (percentiles) is available
+ * for the overlay, and the buffer can be exported as Chrome trace JSON (chrome://tracing, Perfetto).
+ */
+
+class TiledProfiler
+{
+public:
+	struct Event {
+		const char *name = nullptr;
+		qint64 start = 0;
+		qint64 duration = 0;
+		quint64 thread = 0;
+	};
+
+	struct Summary {
+		QByteArray name;
+		int count = 0;
+		qint64 total = 0;
+		qint64 p50 = 0;
+		qint64 p90 = 0;
+		qint64 p99 = 0;
+		qint64 max = 0;
+	};
+
+	static TiledProfiler *instance();
+
+	qint64 now() const { return m_timer.nsecsElapsed(); }
+	void record(const char *name, const qint64 &start, const qint64 &duration);
+
+	std::vector<Summary> summary(const qint64 &window) const;
+	QString report(const qint64 &window = 2000000000LL) const;
+	bool exportTrace(const QString &fileName) const;
+
+private:
+	TiledProfiler();
+
+	std::vector<Event> events() const;
+
+	mutable QMutex m_mutex;
+	std::vector<Event> m_buffer;
+	quint64 m_next = 0;
+	QElapsedTimer m_timer;
+};
+
+
+
+/**
+ * @brief The TiledProfilerScope class
+ */
+
+class TiledProfilerScope
+{
+public:
+	explicit TiledProfilerScope(const char *name)
+		: m_name(name)
+		, m_start(TiledProfiler::instance()->now())
+	{}
+
+	~TiledProfilerScope() {
+		TiledProfiler *p = TiledProfiler::instance();
+		p->record(m_name, m_start, p->now() - m_start);
+	}
+
+private:
+	const char *const m_name;
+	const qint64 m_start;
+};
+
+
+#else
+
+#define TILED_PROFILE_SCOPE(name)
+
+#endif
+
+#endif // TILEDPROFILER_H
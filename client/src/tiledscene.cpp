@@ -30,6 +30,7 @@
 #include "tiledvisualitem.h"
 #include "tilelayeritem.h"
 #include "tiledgame.h"
+#include "tiledmapcache.h"
 #include "tilesetmanager.h"
 #include "application.h"
 #include "isometricobject.h"
@@ -37,7 +38,6 @@
 #include <libtiled/map.h>
 #include <libtiled/objectgroup.h>
 #include <libtiled/grouplayer.h>
-#include <libtiled/mapreader.h>
 #include <libtiled/imagelayer.h>
 #include <libtiled/maprenderer.h>
 
@@ -117,9 +117,7 @@ bool TiledScene::load(const QUrl &url)
 {
 	LOG_CTRACE("scene") << "Load scene from:" << qPrintable(url.toDisplayString());
 
-	Tiled::MapReader mapReader;
-
-	m_map = mapReader.readMap(Tiled::urlToLocalFileOrQrc(url));
+	m_map = TiledMapCache::readMap(Tiled::urlToLocalFileOrQrc(url));
 
 	if (m_map) {
 		setMap(m_map.get());
@@ -149,6 +147,19 @@ int TiledScene::getDynamicZ(const qreal &x, const qreal &y, const int &defaultVa
 		pos = renderer->screenToPixelCoords(x, y);
 	}
 
+	if (const DynamicZIndex::Cell *cell = m_dynamicZIndex.cell(pos)) {
+		z = std::max(z, cell->z);
+
+		for (const int &idx : cell->partial) {
+			const DynamicZ &p = m_dynamicZList.at(idx);
+
+			if (p.isOver(pos))
+				z = std::max(z, p.z);
+		}
+
+		return z;
+	}
+
 	for (const DynamicZ &p : std::as_const(m_dynamicZList)) {
 		if (!p.isOver(pos))
 			continue;
@@ -198,30 +209,52 @@ void TiledScene::stopMusic()
 
 /**
  * @brief TiledScene::reorderObjectsZ
+ * Objects are ordered by their y position inside their dynamic z layer. The z value is derived directly
+ * from the position, so only the moved objects have to be updated.
  */
 
-void TiledScene::reorderObjectsZ(const std::vector<TiledObjectBody*> list)
+void TiledScene::reorderObjectsZ(const std::vector<TiledObjectBody*> &list)
 {
-	QHash<qreal, QMultiMap<qreal, TiledObjectBody*>> map;
+	const qint64 prevGeneration = m_objectZGeneration++;
+	const qreal h = std::max<qreal>(1., height());
 
 	for (TiledObjectBody *obj : list) {
-		qreal z = 0;
-		const qreal y = obj->bodyPositionF().y();
+		if (!obj->useDynamicZ())
+			continue;
 
-		if (obj->useDynamicZ()) {
-			z = getDynamicZ(obj->bodyPositionF(), obj->defaultZ()) + obj->subZ();
+		const QPointF &pos = obj->bodyPositionF();
+		QQuickItem *item = obj->visualItem();
 
-			map[z].insert(y, obj);
-		}
-	}
+		auto [it, inserted] = m_objectZ.try_emplace(obj);
+		ObjectZ &oz = it->second;
 
-	for (const auto &[subZ, subMap] : map.asKeyValueRange()) {
-		qreal subsubZ = 0.0001;
+		const bool known = !inserted && oz.generation == prevGeneration;
 
-		for (const auto &[key, o] : subMap.asKeyValueRange()) {
-			if (o->visualItem())
-				o->visualItem()->setZ(subZ+subsubZ);
-			subsubZ += 0.0001;
+		oz.generation = m_objectZGeneration;
+
+		if (known && oz.position == pos && oz.defaultZ == obj->defaultZ() && oz.subZ == obj->subZ() &&
+				(!item || item->z() == oz.z))
+			continue;
+
+		oz.position = pos;
+		oz.defaultZ = obj->defaultZ();
+		oz.subZ = obj->subZ();
+
+		// Keep inside (z, z+0.5), subZ is 0 or 0.5
+
+		oz.z = getDynamicZ(pos, obj->defaultZ()) + obj->subZ()
+			   + 0.0001 + 0.4998 * std::clamp(pos.y()/h, 0., 1.);
+
+		if (item)
+			item->setZ(oz.z);
+	}
+
+	if (m_objectZ.size() > list.size()) {
+		for (auto it = m_objectZ.begin(); it != m_objectZ.end(); ) {
+			if (it->second.generation != m_objectZGeneration)
+				it = m_objectZ.erase(it);
+			else
+				++it;
 		}
 	}
 }
@@ -549,6 +582,8 @@ void TiledScene::refresh()
 	qDeleteAll(m_visualItems);
 	m_visualItems.clear();
 	m_dynamicZList.clear();
+	m_dynamicZIndex.clear();
+	m_objectZ.clear();
 
 	mRenderer = nullptr;
 
@@ -713,6 +748,99 @@ void TiledScene::setTileLayersZ()
 
 
 	m_dynamicZList.emplace_back(QStringLiteral("__default__"), QList<QRectF>{QRectF(0,0,1,1)}, minZ);
+
+	updateDynamicZIndex();
+}
+
+
+
+/**
+ * @brief TiledScene::updateDynamicZIndex
+ * Build the grid index of the DynamicZ regions
+ */
+
+void TiledScene::updateDynamicZIndex()
+{
+	m_dynamicZIndex.clear();
+
+	if (m_dynamicZList.empty() || !mMap)
+		return;
+
+	// Isometric pixel coordinates are measured in tile height on both axes
+
+	const bool isometric = mMap->orientation() == Tiled::Map::Isometric;
+
+	QRectF bounds(0, 0,
+				  mMap->width() * (isometric ? mMap->tileHeight() : mMap->tileWidth()),
+				  mMap->height() * mMap->tileHeight());
+
+	for (const DynamicZ &d : m_dynamicZList) {
+		for (const QRectF &r : d.areas)
+			bounds |= r;
+	}
+
+	if (bounds.isEmpty())
+		return;
+
+	qreal cellSize = 64.;
+
+	while ((std::ceil(bounds.width()/cellSize) * std::ceil(bounds.height()/cellSize)) > 65536.)
+		cellSize *= 2.;
+
+	m_dynamicZIndex.bounds = bounds;
+	m_dynamicZIndex.cellSize = cellSize;
+	m_dynamicZIndex.columns = std::ceil(bounds.width()/cellSize);
+	m_dynamicZIndex.rows = std::ceil(bounds.height()/cellSize);
+	m_dynamicZIndex.cells.resize(m_dynamicZIndex.columns * m_dynamicZIndex.rows);
+
+	std::vector<QPointF> topLeftList;
+	topLeftList.reserve(m_dynamicZList.size());
+
+	for (const DynamicZ &d : m_dynamicZList)
+		topLeftList.push_back(d.getMinTopLeft());
+
+	for (int row=0; row<m_dynamicZIndex.rows; ++row) {
+		for (int col=0; col<m_dynamicZIndex.columns; ++col) {
+			const qreal x0 = bounds.left() + col*cellSize;
+			const qreal y0 = bounds.top() + row*cellSize;
+			const qreal x1 = x0 + cellSize;
+			const qreal y1 = y0 + cellSize;
+
+			DynamicZIndex::Cell &cell = m_dynamicZIndex.cells[row * m_dynamicZIndex.columns + col];
+
+			for (int i=0; i<(int) m_dynamicZList.size(); ++i) {
+				const DynamicZ &d = m_dynamicZList.at(i);
+
+				if (d.areas.isEmpty()) {
+					cell.z = std::max(cell.z, d.z);
+					continue;
+				}
+
+				const QPointF &topLeft = topLeftList.at(i);
+
+				// The region is right-below topLeft, except the parts left-above the bottom right corner of the areas
+
+				bool inside = x0 >= topLeft.x() && y0 >= topLeft.y();
+				bool outside = x1 < topLeft.x() || y1 < topLeft.y();
+
+				for (const QRectF &a : d.areas) {
+					if (x0 <= a.right() && y0 <= a.bottom())
+						inside = false;
+
+					if (x1 <= a.right() && y1 <= a.bottom())
+						outside = true;
+				}
+
+				if (outside)
+					continue;
+
+				if (inside)
+					cell.z = std::max(cell.z, d.z);
+				else
+					cell.partial.push_back(i);
+			}
+		}
+	}
 }
 
 
@@ -804,12 +932,15 @@ QPointF TiledScene::DynamicZ::getMinTopLeft() const
 
 bool TiledScene::DynamicZ::isOver(const qreal &x, const qreal &y) const
 {
+	if (areas.isEmpty())
+		return true;
+
 	const QPointF &topLeft = getMinTopLeft();
 
-	for (const QRectF &a : areas) {
-		if (y < topLeft.y() || x < topLeft.x())
-			return false;
+	if (y < topLeft.y() || x < topLeft.x())
+		return false;
 
+	for (const QRectF &a : areas) {
 		if (y <= a.bottom() && x <= a.right())
 			return false;
 	}
@@ -818,6 +949,28 @@ bool TiledScene::DynamicZ::isOver(const qreal &x, const qreal &y) const
 }
 
 
+
+/**
+ * @brief TiledScene::DynamicZIndex::cell
+ * @param pos
+ * @return
+ */
+
+const TiledScene::DynamicZIndex::Cell *TiledScene::DynamicZIndex::cell(const QPointF &pos) const
+{
+	if (cells.empty() || !bounds.contains(pos))
+		return nullptr;
+
+	const int col = std::min<int>((pos.x()-bounds.left()) / cellSize, columns-1);
+	const int row = std::min<int>((pos.y()-bounds.top()) / cellSize, rows-1);
+
+	if (col < 0 || row < 0)
+		return nullptr;
+
+	return &cells.at(row*columns + col);
+}
+
+
 /**
  * @brief TiledScene::viewport
  * @return
@@ -31,6 +31,7 @@
 #include "tiledobject.h"
 #include <QQuickItem>
 #include <QElapsedTimer>
+#include <unordered_map>
 #include "chipmunk/chipmunk.h"
 
 
@@ -195,9 +196,55 @@ private:
 	};
 
 
+	/**
+	 * @brief The DynamicZIndex class
+	 *
+	 * Uniform grid over the DynamicZ areas (in pixel coordinates). Each cell stores the z of the
+	 * DynamicZ regions covering the whole cell and the indices of the regions crossing it.
+	 */
+
+	struct DynamicZIndex {
+		struct Cell {
+			int z = std::numeric_limits<int>::min();
+			std::vector<int> partial;
+		};
+
+		QRectF bounds;
+		qreal cellSize = 64.;
+		int columns = 0;
+		int rows = 0;
+		std::vector<Cell> cells;
+
+		void clear() {
+			bounds = QRectF();
+			columns = 0;
+			rows = 0;
+			cells.clear();
+		}
+
+		const Cell *cell(const QPointF &pos) const;
+	};
+
+
+	/**
+	 * @brief The ObjectZ class
+	 *
+	 * Last position and z of a body in reorderObjectsZ()
+	 */
+
+	struct ObjectZ {
+		QPointF position;
+		qreal defaultZ = 0.;
+		qreal subZ = 0.;
+		qreal z = 0.;
+		qint64 generation = 0;
+	};
+
+
 	void appendDynamicZ(const QString &name, const QRectF &area);
 	void setTileLayersZ();
-	void reorderObjectsZ(const std::vector<TiledObjectBody *> list);
+	void updateDynamicZIndex();
+	void reorderObjectsZ(const std::vector<TiledObjectBody *> &list);
 	void repaintTilesets(Tiled::Tileset *tileset);
 
 	TiledDebugDraw *m_debugDraw = nullptr;
@@ -206,6 +253,9 @@ private:
 	TiledGame *m_game = nullptr;
 
 	std::vector<DynamicZ> m_dynamicZList;
+	DynamicZIndex m_dynamicZIndex;
+	std::unordered_map<TiledObjectBody*, ObjectZ> m_objectZ;
+	qint64 m_objectZGeneration = 0;
 	QList<Tiled::MapObject*> m_lightObjects;
 
 	friend class TiledGame;
@@ -28,6 +28,7 @@
 #include "qrandom.h"
 #include "tiledscene.h"
 #include "tiledgame.h"
+#include "tiledprofiler.h"
 #include <QSGSimpleTextureNode>
 
 
@@ -58,6 +59,8 @@ TiledSpriteHandler::~TiledSpriteHandler()
 
 QSGNode *TiledSpriteHandler::updatePaintNode(QSGNode *node, UpdatePaintNodeData *)
 {
+	TILED_PROFILE_SCOPE("TiledSpriteHandler::updatePaintNode");
+
 	if (node)
 		delete node;
 
@@ -77,7 +80,7 @@ QSGNode *TiledSpriteHandler::updatePaintNode(QSGNode *node, UpdatePaintNodeData
 		m_currentFrame = m_handlerMaster->m_currentFrame;
 	}
 
-	const auto &list = find(m_currentProxySprite, m_currentDirection);
+	const auto &list = find(m_currentNameId, m_currentDirection);
 
 	if (list.isEmpty()) {
 		///LOG_CERROR("scene") << "Sprite not found:" << m_currentSprite << m_currentDirection;
@@ -232,15 +235,89 @@ bool TiledSpriteHandler::createSpriteItem(const TextureSprite &sprite,
 
 	///LOG_CTRACE("scene") << "Sprite created:" << s.data.name << s.layer << s.direction;
 
-	if (!m_layers.contains(layer))
-		m_layers.append(layer);
-
-	m_spriteList.append(s);
+	appendSprite(s);
 
 	return true;
 }
 
 
+
+/**
+ * @brief TiledSpriteHandler::appendSprite
+ * Intern the name and the layer of the sprite and add it to the lookup table
+ * @param sprite
+ */
+
+void TiledSpriteHandler::appendSprite(const Sprite &sprite)
+{
+	const int nameId = internName(sprite.data.name);
+	const int layerId = internLayer(sprite.layer);
+
+	m_spriteList.append(sprite);
+	m_spriteList.last().layerId = layerId;
+	m_spriteIndex.insert(spriteKey(nameId, sprite.direction, layerId), m_spriteList.size()-1);
+}
+
+
+
+/**
+ * @brief TiledSpriteHandler::internName
+ * @param name
+ * @return
+ */
+
+int TiledSpriteHandler::internName(const QString &name)
+{
+	if (const auto it = m_nameIds.constFind(name); it != m_nameIds.constEnd())
+		return it.value();
+
+	const int id = m_nameIds.size();
+	m_nameIds.insert(name, id);
+
+	if (name == m_currentProxySprite)
+		m_currentNameId = id;
+
+	return id;
+}
+
+
+
+/**
+ * @brief TiledSpriteHandler::internLayer
+ * @param layer
+ * @return
+ */
+
+int TiledSpriteHandler::internLayer(const QString &layer)
+{
+	if (const auto it = m_layerIds.constFind(layer); it != m_layerIds.constEnd())
+		return it.value();
+
+	const int id = m_layers.size();
+	m_layers.append(layer);
+	m_layerIds.insert(layer, id);
+
+	updateVisibleLayerIds();
+
+	return id;
+}
+
+
+
+/**
+ * @brief TiledSpriteHandler::updateVisibleLayerIds
+ */
+
+void TiledSpriteHandler::updateVisibleLayerIds()
+{
+	m_visibleLayerIds.clear();
+	m_visibleLayerIds.reserve(m_visibleLayers.size());
+
+	for (const QString &l : std::as_const(m_visibleLayers))
+		m_visibleLayerIds.append(m_layerIds.value(l, -1));
+}
+
+
 /**
  * @brief TiledSpriteHandler::find
  * @param baseName
@@ -251,12 +328,29 @@ bool TiledSpriteHandler::createSpriteItem(const TextureSprite &sprite,
 
 QList<QVector<TiledSpriteHandler::Sprite>::const_iterator> TiledSpriteHandler::find(const QString &baseName,
 																					const TiledObject::Direction &direction) const
+{
+	return find(m_nameIds.value(baseName, -1), direction);
+}
+
+
+/**
+ * @brief TiledSpriteHandler::find
+ * @param nameId
+ * @param direction
+ * @return
+ */
+
+QList<QVector<TiledSpriteHandler::Sprite>::const_iterator> TiledSpriteHandler::find(const int &nameId,
+																					const TiledObject::Direction &direction) const
 {
 	QList<QVector<Sprite>::const_iterator> list;
 
-	for (auto it = m_spriteList.constBegin(); it != m_spriteList.constEnd(); ++it) {
-		if (it->data.name == baseName && it->direction == direction)
-			list.append(it);
+	if (nameId < 0)
+		return list;
+
+	for (int layerId = 0; layerId < m_layers.size(); ++layerId) {
+		if (const int idx = m_spriteIndex.value(spriteKey(nameId, direction, layerId), -1); idx >= 0)
+			list.append(m_spriteList.constBegin()+idx);
 	}
 
 	return list;
@@ -273,13 +367,43 @@ QList<QVector<TiledSpriteHandler::Sprite>::const_iterator> TiledSpriteHandler::f
 std::optional<QVector<TiledSpriteHandler::Sprite>::const_iterator>
 TiledSpriteHandler::findFirst(const QString &baseName, const TiledObject::Direction &direction) const
 {
-	for (auto it = m_spriteList.constBegin(); it != m_spriteList.constEnd(); ++it) {
-		if (it->data.name == baseName && it->direction == direction &&
-				(m_visibleLayers.isEmpty() || it->layer == m_visibleLayers.first()))
-			return it;
+	const int idx = findFirstIndex(m_nameIds.value(baseName, -1), direction);
+
+	if (idx < 0)
+		return std::nullopt;
+
+	return m_spriteList.constBegin()+idx;
+}
+
+
+/**
+ * @brief TiledSpriteHandler::findFirstIndex
+ * Sprite of the first visible layer (or the first loaded one, if there are no visible layers)
+ * @param nameId
+ * @param direction
+ * @return
+ */
+
+int TiledSpriteHandler::findFirstIndex(const int &nameId, const TiledObject::Direction &direction) const
+{
+	if (nameId < 0)
+		return -1;
+
+	if (!m_visibleLayerIds.isEmpty())
+		return m_visibleLayerIds.first() < 0 ?
+					-1 :
+					m_spriteIndex.value(spriteKey(nameId, direction, m_visibleLayerIds.first()), -1);
+
+	int first = -1;
+
+	for (int layerId = 0; layerId < m_layers.size(); ++layerId) {
+		const int idx = m_spriteIndex.value(spriteKey(nameId, direction, layerId), -1);
+
+		if (idx >= 0 && (first < 0 || idx < first))
+			first = idx;
 	}
 
-	return std::nullopt;
+	return first;
 }
 
 
@@ -292,12 +416,7 @@ TiledSpriteHandler::findFirst(const QString &baseName, const TiledObject::Direct
 
 bool TiledSpriteHandler::exists(const QString &baseName, const TiledObject::Direction &direction) const
 {
-	for (const Sprite &s : std::as_const(m_spriteList)) {
-		if (s.data.name == baseName && s.direction == direction)
-			return true;
-	}
-
-	return false;
+	return !find(baseName, direction).isEmpty();
 }
 
 
@@ -311,12 +430,13 @@ bool TiledSpriteHandler::exists(const QString &baseName, const TiledObject::Dire
 
 bool TiledSpriteHandler::exists(const QString &baseName, const QString &layer, const TiledObject::Direction &direction) const
 {
-	for (const Sprite &s : std::as_const(m_spriteList)) {
-		if (s.data.name == baseName && s.direction == direction && s.layer == layer)
-			return true;
-	}
+	const int nameId = m_nameIds.value(baseName, -1);
+	const int layerId = m_layerIds.value(layer, -1);
+
+	if (nameId < 0 || layerId < 0)
+		return false;
 
-	return false;
+	return m_spriteIndex.contains(spriteKey(nameId, direction, layerId));
 }
 
 
@@ -330,7 +450,9 @@ bool TiledSpriteHandler::exists(const QString &baseName, const QString &layer, c
 
 void TiledSpriteHandler::changeSprite(const QString &name, const TiledObject::Direction &direction)
 {
-	if (m_currentProxySprite == name && m_currentDirection == direction)
+	const int nameId = m_nameIds.value(name, -1);
+
+	if (nameId >= 0 && m_currentNameId == nameId && m_currentDirection == direction)
 		return;
 
 	const auto &ptr = findFirst(name, direction);
@@ -370,9 +492,9 @@ void TiledSpriteHandler::createNodes(QSGNode *node, const QList<QVector<TiledSpr
 {
 	Q_ASSERT(node);
 
-	for (const QString &layer : m_visibleLayers) {
+	for (const int &layerId : std::as_const(m_visibleLayerIds)) {
 		for (const auto &it : iteratorList) {
-			if (it->layer != layer)
+			if (layerId < 0 || it->layerId != layerId)
 				continue;
 
 			if (!it->texture) {
@@ -614,10 +736,15 @@ void TiledSpriteHandler::clear()
 	m_spriteNames.clear();
 	m_currentSprite.clear();
 	m_currentProxySprite.clear();
+	m_currentNameId = -1;
 	m_currentDirection = TiledObject::Invalid;
 	m_layers.clear();
+	m_nameIds.clear();
+	m_layerIds.clear();
+	m_spriteIndex.clear();
 	setOpacityMask(MaskFull);
 	m_visibleLayers = QStringList{ QStringLiteral("default") };
+	updateVisibleLayerIds();
 	m_startFrameSeed = 0.;
 
 	if (m_handlerMaster && m_handlerMaster->syncHandlers()) {
@@ -691,6 +818,8 @@ void TiledSpriteHandler::setVisibleLayers(const QStringList &newVisibleLayers)
 		if (l != QStringLiteral("default"))
 			m_visibleLayers.append(l);
 	}
+
+	updateVisibleLayerIds();
 }
 
 
@@ -748,14 +877,16 @@ void TiledSpriteHandler::timerEvent(QTimerEvent *)
 	if (m_baseObject && m_baseObject->game() && m_baseObject->game()->paused())
 		return;
 
-	const auto &ptr = findFirst(m_currentProxySprite, m_currentDirection);
+	const int idx = findFirstIndex(m_currentNameId, m_currentDirection);
 
-	if (!ptr) {
+	if (idx < 0) {
 		LOG_CERROR("scene") << "Sprite not found:" << m_currentProxySprite << m_currentDirection;
 		m_timer.stop();
 		return;
 	}
 
+	const auto ptr = std::make_optional(m_spriteList.constBegin()+idx);
+
 
 	for (int dir = 0; dir<2; ++dir) {
 		int nextFrame = m_isReverse ? m_currentFrame-1 : m_currentFrame+1;
@@ -830,6 +961,7 @@ void TiledSpriteHandler::setCurrentSprite(const QString &newCurrentSprite)
 
 		m_currentProxySprite = newCurrentSprite;
 		m_currentSprite = newCurrentSprite;
+		m_currentNameId = m_nameIds.value(m_currentProxySprite, -1);
 
 	} else {
 		if (m_currentSprite == newProxySprite && m_currentProxySprite == newCurrentSprite)
@@ -837,6 +969,7 @@ void TiledSpriteHandler::setCurrentSprite(const QString &newCurrentSprite)
 
 		m_currentProxySprite = newCurrentSprite;
 		m_currentSprite = newProxySprite;
+		m_currentNameId = m_nameIds.value(m_currentProxySprite, -1);
 	}
 
 	emit currentSpriteChanged();
@@ -94,7 +94,6 @@ public:
 	void setBaseObject(TiledObject *newBaseObject);
 
 	const QStringList &visibleLayers() const;
-	QStringList &visibleLayers() { return m_visibleLayers; }
 	void setVisibleLayers(const QStringList &newVisibleLayers);
 
 	bool clearAtEnd() const;
@@ -132,6 +131,7 @@ protected:
 private:
 	struct Sprite {
 		QString layer;
+		int layerId = -1;
 		TiledObject::Direction direction = TiledObject::Invalid;
 		TextureSprite data;
 		QSGTexture *texture = nullptr;
@@ -143,6 +143,7 @@ private:
 
 	QList<QVector<Sprite>::const_iterator> find(const QString &baseName,
 					const TiledObject::Direction &direction = TiledObject::Invalid) const;
+	QList<QVector<Sprite>::const_iterator> find(const int &nameId, const TiledObject::Direction &direction) const;
 
 	std::optional<QVector<Sprite>::const_iterator> findFirst(const QString &baseName,
 					const TiledObject::Direction &direction = TiledObject::Invalid) const;
@@ -156,6 +157,16 @@ private:
 
 	void changeSprite(const QString &name, const TiledObject::Direction &direction);
 
+	static quint64 spriteKey(const int &nameId, const TiledObject::Direction &direction, const int &layerId) {
+		return (quint64(quint32(nameId)) << 32) | (quint64(quint16(direction)) << 16) | quint64(quint16(layerId));
+	}
+
+	void appendSprite(const Sprite &sprite);
+	int findFirstIndex(const int &nameId, const TiledObject::Direction &direction) const;
+	int internName(const QString &name);
+	int internLayer(const QString &layer);
+	void updateVisibleLayerIds();
+
 	void createNodes(QSGNode *node, const QList<QVector<TiledSpriteHandler::Sprite>::const_iterator> &iteratorList);
 
 
@@ -170,6 +181,14 @@ private:
 	QStringList m_layers;
 	QStringList m_visibleLayers = { QStringLiteral("default") };
 
+	// Sprite names and layers are interned at load, sprites are looked up by (nameId, direction, layerId)
+
+	QHash<QString, int> m_nameIds;
+	QHash<QString, int> m_layerIds;					// index in m_layers
+	QHash<quint64, int> m_spriteIndex;				// index in m_spriteList
+	QVector<int> m_visibleLayerIds = { -1 };
+	int m_currentNameId = -1;						// id of m_currentProxySprite
+
 	Sprite m_jumpToSprite;
 	QPointer<TiledObject> m_baseObject;
 	QBasicTimer m_timer;
@@ -185,6 +204,8 @@ private:
 	bool m_isDirty = false;
 
 	OpacityMask m_opacityMask = MaskFull;
+
+	friend class SpriteBenchmark;
 };
 
 
@@ -147,6 +147,7 @@ Credential Credential::fromJWT(const QByteArray &jwt)
 	const QString &r = obj.value(QStringLiteral("roles")).toString();
 
 	c.m_iat = obj.value(QStringLiteral("iat")).toInteger();
+	c.m_exp = obj.value(QStringLiteral("exp")).toInteger();
 
 	Roles roles;
 
@@ -258,6 +259,17 @@ qint64 Credential::iat() const
 	return m_iat;
 }
 
+
+/**
+ * @brief Credential::exp
+ * @return
+ */
+
+qint64 Credential::exp() const
+{
+	return m_exp;
+}
+
 QByteArray Credential::session() const
 {
 	return m_session;
@@ -139,6 +139,7 @@ public:
 	void setRole(const Role &role, const bool &on = true);
 
 	qint64 iat() const;
+	qint64 exp() const;
 
 	QByteArray session() const;
 	QByteArray devicePub() const;
@@ -153,6 +154,7 @@ private:
 	QString m_username;
 	Roles m_roles = None;
 	qint64 m_iat = 0;
+	qint64 m_exp = 0;
 	QByteArray m_session;
 	QByteArray m_devicePub;
 };
@@ -392,6 +392,10 @@ CREATE TABLE game(
 	scoreid INTEGER REFERENCES score(id) ON UPDATE CASCADE ON DELETE SET NULL
 );
 
+CREATE INDEX game_timestamp_idx ON game(timestamp, id);
+CREATE INDEX game_campaign_timestamp_idx ON game(campaignid, timestamp, id);
+CREATE INDEX game_username_timestamp_idx ON game(username, timestamp, id);
+
 CREATE TABLE runningGame(
 	gameid INTEGER NOT NULL REFERENCES game(id) ON UPDATE CASCADE ON DELETE CASCADE,
 	xp INTEGER NOT NULL DEFAULT 0,
@@ -460,6 +464,22 @@ CREATE TABLE notificationSent(
 	timestamp TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP
 );
 
+CREATE TABLE notificationQueue(
+	id INTEGER NOT NULL PRIMARY KEY,
+	username TEXT NOT NULL REFERENCES user(username) ON UPDATE CASCADE ON DELETE CASCADE,
+	familyName TEXT,
+	givenName TEXT,
+	type INTEGER NOT NULL,
+	campaignid INTEGER REFERENCES campaign(id) ON UPDATE CASCADE ON DELETE CASCADE,
+	description TEXT,
+	endTime TEXT,
+	attempts INTEGER NOT NULL DEFAULT 0,
+	nextTry INTEGER NOT NULL DEFAULT 0,
+	timestamp TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP
+);
+
+CREATE INDEX notificationQueue_nextTry_idx ON notificationQueue(nextTry, id);
+
 
 
 ----------------------------------
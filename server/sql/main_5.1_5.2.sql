@@ -15,3 +15,36 @@ CREATE TABLE permit(
 	UNIQUE (username, campaignid, device)
 );
 
+
+
+----------------------------------
+--- Game log indices (keyset pagination)
+----------------------------------
+
+CREATE INDEX IF NOT EXISTS game_timestamp_idx ON game(timestamp, id);
+
+CREATE INDEX IF NOT EXISTS game_campaign_timestamp_idx ON game(campaignid, timestamp, id);
+
+CREATE INDEX IF NOT EXISTS game_username_timestamp_idx ON game(username, timestamp, id);
+
+
+
+----------------------------------
+--- Outbound notification queue
+----------------------------------
+
+CREATE TABLE IF NOT EXISTS notificationQueue(
+	id INTEGER NOT NULL PRIMARY KEY,
+	username TEXT NOT NULL REFERENCES user(username) ON UPDATE CASCADE ON DELETE CASCADE,
+	familyName TEXT,
+	givenName TEXT,
+	type INTEGER NOT NULL,
+	campaignid INTEGER REFERENCES campaign(id) ON UPDATE CASCADE ON DELETE CASCADE,
+	description TEXT,
+	endTime TEXT,
+	attempts INTEGER NOT NULL DEFAULT 0,
+	nextTry INTEGER NOT NULL DEFAULT 0,
+	timestamp TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP
+);
+
+CREATE INDEX IF NOT EXISTS notificationQueue_nextTry_idx ON notificationQueue(nextTry, id);
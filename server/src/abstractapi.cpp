@@ -127,6 +127,36 @@ QHttpServerResponse AbstractAPI::responseErrorSql()
 
 
 
+/**
+ * @brief AbstractAPI::responseJson
+ * @param data
+ * @return
+ */
+
+QHttpServerResponse AbstractAPI::responseJson(QByteArray data)
+{
+	return QHttpServerResponse(QByteArrayLiteral("application/json"), std::move(data), QHttpServerResponse::StatusCode::Ok);
+}
+
+
+
+/**
+ * @brief AbstractAPI::pageLimit
+ * @param json
+ * @return
+ *
+ * Page size from the request (missing or non-positive: default, at most MAX_LIMIT)
+ */
+
+int AbstractAPI::pageLimit(const QJsonObject &json)
+{
+	const int limit = json.value(QStringLiteral("limit")).toInt(DEFAULT_LIMIT);
+
+	return limit > 0 ? std::min(limit, MAX_LIMIT) : DEFAULT_LIMIT;
+}
+
+
+
 /**
  * @brief AbstractAPI::path
  * @return
@@ -36,6 +36,7 @@
 
 
 #define DEFAULT_LIMIT	50
+#define MAX_LIMIT		500
 
 
 class ServerService;
@@ -61,6 +62,9 @@ public:
 	static QHttpServerResponse responseResult(const char *field, const QJsonValue &value);
 	static QHttpServerResponse responseError(const char *errorStr, const QHttpServerResponse::StatusCode &code = QHttpServerResponse::StatusCode::Ok);
 	static QHttpServerResponse responseErrorSql();
+	static QHttpServerResponse responseJson(QByteArray data);
+
+	static int pageLimit(const QJsonObject &json);
 
 	static const char *apiPath();
 
@@ -26,12 +26,10 @@
 
 #include "adminapi.h"
 #include "commonsettings.h"
-#include "mimehtml.h"
 #include "querybuilder.hpp"
 #include "serverservice.h"
 #include "sodium/crypto_pwhash.h"
 #include "teacherapi.h"
-#include "SimpleMail"
 
 
 #define _SQL_QUERY_USERS "SELECT user.username, familyName, givenName, active, user.classid, class.name as className, " \
@@ -2120,45 +2118,18 @@ bool AdminAPI::sendNotifications(const DatabaseMain *dbMain, ServerService *serv
 	Q_ASSERT(dbMain);
 	Q_ASSERT(service);
 
-	if (!service->smtpServer())
+	if (!service->notificationSender())
 		return false;
 
 	LOG_CTRACE("service") << "Send notifications";
 
 	QDefer ret;
 
-	struct CampaignData {
-		int id = 0;
-		QString description;
-		CallOfSuli::NotificationType type = CallOfSuli::NotificationInvalid;
-		QDateTime endTime;
-		QVector<UserInfo> users;
-	};
+	int count = 0;
 
-	auto contentPtr = Utils::fileContent(QStringLiteral(":/html/email-campaign.html"));
-
-	if (!contentPtr) {
-		LOG_CERROR("service") << "Invalid email content";
-		return false;
-	}
-
-	QVector<CampaignData> cDataList;
-
-	dbMain->worker()->execInThread([ret, dbMain, &cDataList]() mutable {
+	dbMain->worker()->execInThread([ret, dbMain, &count]() mutable {
 		QSqlDatabase db = QSqlDatabase::database(dbMain->dbName());
 
-		const auto fnAppend = [](QVector<CampaignData> *dst, CampaignData &d,
-				const CallOfSuli::NotificationType &t, const DatabaseMain *db) -> bool {
-			d.type = t;
-			if (const auto &ptr = _getNotificationList(db, t, d.id))
-				d.users = ptr.value();
-			else
-				return false;
-
-			dst->append(d);
-			return true;
-		};
-
 		QMutexLocker _locker(dbMain->mutex());
 
 		QueryBuilder q(db);
@@ -2170,168 +2141,85 @@ bool AdminAPI::sendNotifications(const DatabaseMain *dbMain, ServerService *serv
 			return ret.reject();
 		}
 
-		while (q.sqlQuery().next()) {
-			CampaignData cdata;
-			cdata.id = q.value("id").toInt();
-			cdata.description = q.value("description").toString();
-			cdata.endTime = q.value("endtime").toDateTime();
-
-			if (!fnAppend(&cDataList, cdata, CallOfSuli::NotificationStarted, dbMain)) return ret.reject();
-
-			if (cdata.endTime.isNull())
-				continue;
-
-			if (QDateTime::currentDateTime().secsTo(cdata.endTime) <= 60*60*24) {
-				if (!fnAppend(&cDataList, cdata, CallOfSuli::NotificationHour24, dbMain)) return ret.reject();
-			} else if (QDateTime::currentDateTime().secsTo(cdata.endTime) <= 60*60*48) {
-				if (!fnAppend(&cDataList, cdata, CallOfSuli::NotificationHour48, dbMain)) return ret.reject();
-			} else if (QDateTime::currentDateTime().daysTo(cdata.endTime) <= 7) {
-				if (!fnAppend(&cDataList, cdata, CallOfSuli::NotificationWeek1, dbMain)) return ret.reject();
-			} else
-				continue;
-		}
-
-		ret.resolve();
-	});
-
-	QDefer::await(ret);
-	if (ret.state() != RESOLVED)
-		return false;
-
-
-	QLocale locale;
-
-	for (const auto &p : cDataList) {
-		const QString description = p.description.isEmpty() ?
-										tr("Kihívás #%1").arg(p.id) :
-										p.description;
-
-		for (const auto &u : p.users) {
-			auto html = std::make_shared<SimpleMail::MimeHtml>();
+		db.transaction();
 
-			QUrl url;
-			url.setScheme(service->settings()->ssl() ? QStringLiteral("https") : QStringLiteral("http"));
-			url.setHost(service->settings()->redirectHost());
-			url.setPort(service->settings()->listenPort());
-			url.setPath(QStringLiteral("/callofsuli.html"));
+		const auto fnEnqueue = [&db, &count, dbMain](const int &campaign, const QString &description,
+				const QDateTime &endTime, const CallOfSuli::NotificationType &type) -> bool {
+			const auto &ptr = _getNotificationList(dbMain, type, campaign);
 
-			QString content = QString::fromUtf8(contentPtr.value());
+			if (!ptr)
+				return false;
 
-			content
-					.replace(QStringLiteral("${server:name}"), service->serverName())
-					.replace(QStringLiteral("${server:url}"), url.toString())
-					.replace(QStringLiteral("${user:familyName}"), u.familyname)
-					.replace(QStringLiteral("${user:givenName}"), u.givenname)
-					.replace(QStringLiteral("${campaign:name}"), p.description)
-					//.replace(QStringLiteral("${campaign:endTime}"), p.endTime.toString())
-					;
+			for (const UserInfo &u : *ptr) {
+				if (!QueryBuilder::q(db)
+						.addQuery("INSERT INTO notificationQueue(").setFieldPlaceholder()
+						.addQuery(") VALUES (").setValuePlaceholder()
+						.addQuery(")")
+						.addField("username", u.email)
+						.addField("familyName", u.familyname)
+						.addField("givenName", u.givenname)
+						.addField("type", type)
+						.addField("campaignid", campaign)
+						.addField("description", description)
+						.addField("endTime", endTime)
+						.exec())
+					return false;
 
-			if (p.endTime.isValid()) {
-				content.replace(QStringLiteral("${campaign:endTime}"),
-								locale.toString(p.endTime.toLocalTime(), QStringLiteral("yyyy. MMMM d. ddd hh:mm")));
-			} else {
-				content.replace(QStringLiteral("${campaign:endTime}"), tr("egyelőre nincs megadva"));
-			}
+				if (!QueryBuilder::q(db)
+						.addQuery("INSERT INTO notificationSent(").setFieldPlaceholder()
+						.addQuery(") VALUES (").setValuePlaceholder()
+						.addQuery(")")
+						.addField("username", u.email)
+						.addField("type", type)
+						.addField("campaignid", campaign)
+						.exec())
+					return false;
 
-			SimpleMail::MimeMessage message;
-			message.setSender(SimpleMail::EmailAddress(service->settings()->smtpUser(),
-													   "Call of Suli"));
-			message.addTo(SimpleMail::EmailAddress(u.email, u.familyname+" "+u.givenname));
-
-			switch (p.type) {
-				case CallOfSuli::NotificationStarted:
-					message.setSubject(tr("Új kihívás: ").append(description));
-					content.replace(QStringLiteral("${message:preheader}"),
-									tr("A Call of Suli | %1 szerveren új kihívás indult el: %2.")
-									.arg(service->serverName(), description))
-							.replace(QStringLiteral("${message:main}"),
-									 tr("Értesítünk, hogy a <i>Call of Suli | %1</i> szerveren új kihívás indult el: <b>%2</b>")
-									 .arg(service->serverName(), description));
-					break;
-
-				case CallOfSuli::NotificationHour24:
-					message.setSubject(tr("1 nap van hátra: ").append(description));
-					content.replace(QStringLiteral("${message:preheader}"),
-									tr("A(z) %1 kihívás már csak kevesebb, mint egy napig teljesíthető.")
-									.arg(description))
-							.replace(QStringLiteral("${message:main}"),
-									 tr("Értesítünk, hogy a <i>Call of Suli | %1</i> szerveren a(z) <b>%2</b> kihívás teljesítésére kevesebb, mint egy nap van hátra.")
-									 .arg(service->serverName(), description));
-					break;
-
-				case CallOfSuli::NotificationHour48:
-					message.setSubject(tr("2 nap van hátra: ").append(description));
-					content.replace(QStringLiteral("${message:preheader}"),
-									tr("A(z) %1 kihívás már csak kevesebb, mint két napig teljesíthető.")
-									.arg(description))
-							.replace(QStringLiteral("${message:main}"),
-									 tr("Értesítünk, hogy a <i>Call of Suli | %1</i> szerveren a(z) <b>%2</b> kihívás teljesítésére kevesebb, mint 2 nap áll rendelkezésre.")
-									 .arg(service->serverName(), description));
-					break;
-
-				case CallOfSuli::NotificationWeek1:
-					message.setSubject(tr("Még 1 hét van hátra: ").append(description));
-					content.replace(QStringLiteral("${message:preheader}"),
-									tr("A(z) %1 kihívás még egy hétig teljesíthető.")
-									.arg(description))
-							.replace(QStringLiteral("${message:main}"),
-									 tr("Értesítünk, hogy a <i>Call of Suli | %1</i> szerveren a(z) <b>%2</b> kihívást még 1 hétig lehet teljesíteni.")
-									 .arg(service->serverName(), description));
-					break;
-
-				default:
-					message.setSubject(tr("Értesítés: ").append(description));
-					break;
+				++count;
 			}
 
-			html->setHtml(content);
-
-			message.setContent(html);
-
-			SimpleMail::ServerReply *reply = service->smtpServer()->sendMail(message);
-			QObject::connect(reply, &SimpleMail::ServerReply::finished, [reply, email = u.email] {
-				if (reply->error())
-					LOG_CERROR("service") << "SMTP error:" << qPrintable(email) << qPrintable(reply->responseText());
-				else
-					LOG_CINFO("service") << "Notification sent:" << qPrintable(email) << qPrintable(reply->responseText());
-				reply->deleteLater();
-			});
+			return true;
+		};
 
+		while (q.sqlQuery().next()) {
+			const int id = q.value("id").toInt();
+			const QString description = q.value("description").toString();
+			const QDateTime endTime = q.value("endtime").toDateTime();
+
+			std::optional<CallOfSuli::NotificationType> type;
+
+			if (endTime.isNull())
+				type = std::nullopt;
+			else if (QDateTime::currentDateTime().secsTo(endTime) <= 60*60*24)
+				type = CallOfSuli::NotificationHour24;
+			else if (QDateTime::currentDateTime().secsTo(endTime) <= 60*60*48)
+				type = CallOfSuli::NotificationHour48;
+			else if (QDateTime::currentDateTime().daysTo(endTime) <= 7)
+				type = CallOfSuli::NotificationWeek1;
+
+			if (!fnEnqueue(id, description, endTime, CallOfSuli::NotificationStarted) ||
+					(type && !fnEnqueue(id, description, endTime, *type))) {
+				db.rollback();
+				return ret.reject();
+			}
 		}
-	}
-
-	QDefer ret2;
 
-	dbMain->worker()->execInThread([ret2, dbMain, &cDataList]() mutable {
-		QSqlDatabase db = QSqlDatabase::database(dbMain->dbName());
+		db.commit();
 
-		QMutexLocker _locker(dbMain->mutex());
+		ret.resolve();
+	});
 
-		bool ok = true;
+	QDefer::await(ret);
 
-		for (const auto &p : cDataList) {
-			for (const auto &u : p.users) {
-				if (!QueryBuilder::q(db)
-						.addQuery("INSERT INTO notificationSent(").setFieldPlaceholder()
-						.addQuery(") VALUES (").setValuePlaceholder()
-						.addQuery(")")
-						.addField("username", u.email)
-						.addField("type", p.type)
-						.addField("campaignid", p.id)
-						.exec()) {
-					ok = false;
-				}
-			}
-		}
+	if (ret.state() != RESOLVED)
+		return false;
 
-		if (ok)
-			ret2.resolve();
-		else
-			ret2.reject();
-	});
+	if (count > 0) {
+		LOG_CDEBUG("service") << "Notifications queued:" << count;
+		service->notificationSender()->trigger(service->serverName());
+	}
 
-	QDefer::await(ret2);
-	return ret2.state() == RESOLVED;
+	return true;
 }
 
 
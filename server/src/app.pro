@@ -53,14 +53,18 @@ SOURCES += \
 	abstractengine.cpp \
 	adminapi.cpp \
 	authapi.cpp \
+	contentserver.cpp \
+	credentialcache.cpp \
 	database.cpp \
 	databasemain.cpp \
 	enginehandler.cpp \
 	generalapi.cpp \
 	googleoauth2authenticator.cpp \
 	handler.cpp \
+	jsonstreamwriter.cpp \
 	main.cpp \
 	microsoftoauth2authenticator.cpp \
+	notificationsender.cpp \
 	oauth2authenticator.cpp \
 	oauth2codeflow.cpp \
 	offlineserverengine.cpp \
@@ -86,6 +90,8 @@ HEADERS += \
 	abstractengine.h \
 	adminapi.h \
 	authapi.h \
+	contentserver.h \
+	credentialcache.h \
 	database.h \
 	databasemain.h \
 	enginehandler.h \
@@ -93,7 +99,9 @@ HEADERS += \
 	generalapi.h \
 	googleoauth2authenticator.h \
 	handler.h \
+	jsonstreamwriter.h \
 	microsoftoauth2authenticator.h \
+	notificationsender.h \
 	oauth2authenticator.h \
 	oauth2codeflow.h \
 	offlineserverengine.h \
@@ -95,7 +95,7 @@ QHttpServerResponse AuthAPI::login(const QJsonObject &data) const
 		return responseError("invalid device identity");
 
 	if (!token.isEmpty()) {
-		if (!Credential::verify(token, m_service->settings()->jwtSecret(), m_service->config().get("tokenFirstIat").toInteger(0))) {
+		if (!Credential::verify(token, m_service->settings()->jwtSecret(), m_service->config().tokenFirstIat())) {
 			LOG_CDEBUG("client") << "Token verification failed";
 			return responseError("invalid token");
 		}
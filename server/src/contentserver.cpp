@@ -0,0 +1,556 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * contentserver.cpp
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * ContentServer
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "contentserver.h"
+#include "Logger.h"
+#include <QFileInfo>
+#include <QMimeDatabase>
+#include <QCryptographicHash>
+#include <QLocale>
+#include <QTimeZone>
+
+
+/**
+ * @brief ContentServer::ContentServer
+ */
+
+ContentServer::ContentServer()
+	: m_cache(32*1024*1024)
+{
+
+}
+
+
+/**
+ * @brief ContentServer::~ContentServer
+ */
+
+ContentServer::~ContentServer()
+{
+
+}
+
+
+
+/**
+ * @brief ContentServer::serve
+ * @param fileName
+ * @param request
+ * @param responder
+ * @return
+ */
+
+bool ContentServer::serve(const QString &fileName, const QHttpServerRequest &request, QHttpServerResponder &responder)
+{
+	const auto &info = resolve(fileName, request);
+
+	if (!info)
+		return false;
+
+	QHttpHeaders headers;
+	headers.append(QHttpHeaders::WellKnownHeader::ContentType, mimeType(fileName));
+	headers.append(QHttpHeaders::WellKnownHeader::ETag, info->etag);
+	headers.append(QHttpHeaders::WellKnownHeader::LastModified, httpDate(info->lastModified));
+	headers.append(QHttpHeaders::WellKnownHeader::AcceptRanges, QByteArrayLiteral("bytes"));
+	headers.append(QHttpHeaders::WellKnownHeader::Vary, QByteArrayLiteral("Accept-Encoding"));
+
+	if (!info->encoding.isEmpty())
+		headers.append(QHttpHeaders::WellKnownHeader::ContentEncoding, info->encoding);
+
+
+	// Conditional request
+
+	if (const QByteArray &noneMatch = request.value(QByteArrayLiteral("If-None-Match")); !noneMatch.isEmpty()) {
+		for (const QByteArray &tag : noneMatch.split(',')) {
+			const QByteArray &t = tag.trimmed();
+			if (t == info->etag || t == QByteArrayLiteral("*") || t == QByteArrayLiteral("W/")+info->etag) {
+				responder.write(headers, QHttpServerResponder::StatusCode::NotModified);
+				return true;
+			}
+		}
+	}
+
+
+	// Range request
+
+	Range range;
+
+	switch (parseRange(request, *info, &range)) {
+		case RangeUnsatisfiable:
+			headers.replaceOrAppend(QHttpHeaders::WellKnownHeader::ContentRange,
+									QByteArrayLiteral("bytes */")+QByteArray::number(info->size));
+			responder.write(headers, QHttpServerResponder::StatusCode::RequestRangeNotSatisfiable);
+			return true;
+
+		case RangeValid: {
+			headers.append(QHttpHeaders::WellKnownHeader::ContentRange,
+						   QByteArrayLiteral("bytes ")+QByteArray::number(range.first)+'-'+
+						   QByteArray::number(range.last)+'/'+QByteArray::number(info->size));
+
+			const qint64 length = range.last-range.first+1;
+
+			if (info->size <= m_cacheFileLimit) {
+				const QByteArray &content = cachedContent(*info);
+				responder.write(content.mid(range.first, length), headers, QHttpServerResponder::StatusCode::PartialContent);
+			} else {
+				responder.write(new ContentDevice(info->path, range.first, length), headers,
+								QHttpServerResponder::StatusCode::PartialContent);
+			}
+
+			return true;
+		}
+
+		case RangeNone:
+			break;
+	}
+
+
+	// Full content
+
+	if (info->size <= m_cacheFileLimit)
+		responder.write(cachedContent(*info), headers, QHttpServerResponder::StatusCode::Ok);
+	else
+		responder.write(new ContentDevice(info->path, 0, info->size), headers, QHttpServerResponder::StatusCode::Ok);
+
+	return true;
+}
+
+
+
+/**
+ * @brief ContentServer::clear
+ */
+
+void ContentServer::clear()
+{
+	QMutexLocker locker(&m_mutex);
+	m_cache.clear();
+}
+
+
+/**
+ * @brief ContentServer::mimeType
+ * @param fileName
+ * @return
+ */
+
+QByteArray ContentServer::mimeType(const QString &fileName)
+{
+	if (fileName.endsWith(QStringLiteral(".wasm")))
+		return QByteArrayLiteral("application/wasm");
+	else if (fileName.endsWith(QStringLiteral(".js")))
+		return QByteArrayLiteral("text/javascript");
+	else if (fileName.endsWith(QStringLiteral(".css")))
+		return QByteArrayLiteral("text/css");
+	else if (fileName.endsWith(QStringLiteral(".html")) || fileName.endsWith(QStringLiteral(".htm")))
+		return QByteArrayLiteral("text/html");
+
+	static const QMimeDatabase db;
+
+	return db.mimeTypeForFile(fileName, QMimeDatabase::MatchExtension).name().toUtf8();
+}
+
+
+
+
+/**
+ * @brief ContentServer::resolve
+ * @param fileName
+ * @param request
+ * @return
+ */
+
+std::optional<ContentServer::FileInfo> ContentServer::resolve(const QString &fileName, const QHttpServerRequest &request) const
+{
+	const QByteArray &accept = request.value(QByteArrayLiteral("Accept-Encoding"));
+
+	static const std::vector<std::pair<QByteArray, QString>> variants = {
+		{ QByteArrayLiteral("br"), QStringLiteral(".br") },
+		{ QByteArrayLiteral("gzip"), QStringLiteral(".gz") },
+	};
+
+	// Range requests of precompressed variants are served from the compressed representation (with own ETag)
+
+	for (const auto &[encoding, suffix] : variants) {
+		if (!acceptEncoding(accept, encoding))
+			continue;
+
+		const QFileInfo fi(fileName+suffix);
+
+		if (fi.exists() && fi.isFile()) {
+			return FileInfo{
+				.path = fi.absoluteFilePath(),
+				.encoding = encoding,
+				.size = fi.size(),
+				.lastModified = fi.lastModified(QTimeZone::UTC),
+				.etag = etag(fi, encoding)
+			};
+		}
+	}
+
+	const QFileInfo fi(fileName);
+
+	if (!fi.exists() || !fi.isFile())
+		return std::nullopt;
+
+	return FileInfo{
+		.path = fi.absoluteFilePath(),
+		.encoding = {},
+		.size = fi.size(),
+		.lastModified = fi.lastModified(QTimeZone::UTC),
+		.etag = etag(fi, {})
+	};
+}
+
+
+
+/**
+ * @brief ContentServer::parseRange
+ * @param request
+ * @param info
+ * @param range
+ * @return
+ */
+
+ContentServer::RangeResult ContentServer::parseRange(const QHttpServerRequest &request, const FileInfo &info, Range *range) const
+{
+	Q_ASSERT(range);
+
+	const QByteArray &header = request.value(QByteArrayLiteral("Range")).trimmed();
+
+	if (header.isEmpty())
+		return RangeNone;
+
+	// If-Range: only strong validators are accepted
+
+	if (const QByteArray &ifRange = request.value(QByteArrayLiteral("If-Range")).trimmed(); !ifRange.isEmpty()) {
+		if (ifRange.startsWith('"')) {
+			if (ifRange != info.etag)
+				return RangeNone;
+		} else if (ifRange != httpDate(info.lastModified)) {
+			return RangeNone;
+		}
+	}
+
+	static const QByteArray prefix = QByteArrayLiteral("bytes=");
+
+	if (!header.startsWith(prefix))
+		return RangeNone;
+
+	const QByteArray &spec = header.mid(prefix.size()).trimmed();
+
+	// Multiple ranges are not supported, full content is sent instead
+
+	if (spec.contains(','))
+		return RangeNone;
+
+	const qsizetype sep = spec.indexOf('-');
+
+	if (sep < 0)
+		return RangeNone;
+
+	const QByteArray &firstStr = spec.left(sep).trimmed();
+	const QByteArray &lastStr = spec.mid(sep+1).trimmed();
+
+	bool ok = false;
+
+	if (firstStr.isEmpty()) {
+		// Suffix range (last N bytes)
+
+		const qint64 suffix = lastStr.toLongLong(&ok);
+
+		if (!ok || suffix < 0)
+			return RangeNone;
+
+		if (suffix == 0 || info.size == 0)
+			return RangeUnsatisfiable;
+
+		range->first = std::max<qint64>(0, info.size-suffix);
+		range->last = info.size-1;
+		return RangeValid;
+	}
+
+	range->first = firstStr.toLongLong(&ok);
+
+	if (!ok || range->first < 0)
+		return RangeNone;
+
+	if (range->first >= info.size)
+		return RangeUnsatisfiable;
+
+	if (lastStr.isEmpty()) {
+		range->last = info.size-1;
+	} else {
+		range->last = lastStr.toLongLong(&ok);
+
+		if (!ok || range->last < range->first)
+			return RangeNone;
+
+		range->last = std::min(range->last, info.size-1);
+	}
+
+	return RangeValid;
+}
+
+
+
+/**
+ * @brief ContentServer::cachedContent
+ * @param info
+ * @return
+ */
+
+QByteArray ContentServer::cachedContent(const FileInfo &info)
+{
+	QMutexLocker locker(&m_mutex);
+
+	if (CacheItem *item = m_cache.object(info.path);
+			item && item->size == info.size && item->lastModified == info.lastModified)
+		return item->data;
+
+	QFile f(info.path);
+
+	if (!f.open(QIODevice::ReadOnly)) {
+		LOG_CWARNING("service") << "Can't read file:" << qPrintable(info.path);
+		return {};
+	}
+
+	CacheItem *item = new CacheItem{
+		.data = f.readAll(),
+		.size = info.size,
+		.lastModified = info.lastModified
+	};
+
+	f.close();
+
+	const QByteArray data = item->data;
+
+	LOG_CTRACE("service") << "Content cached:" << qPrintable(info.path) << data.size();
+
+	m_cache.insert(info.path, item, std::max<qsizetype>(1, data.size()));
+
+	return data;
+}
+
+
+
+/**
+ * @brief ContentServer::etag
+ * @param info
+ * @param encoding
+ * @return
+ */
+
+QByteArray ContentServer::etag(const QFileInfo &info, const QByteArray &encoding)
+{
+	QCryptographicHash hash(QCryptographicHash::Md5);
+	hash.addData(info.absoluteFilePath().toUtf8());
+	hash.addData(QByteArray::number(info.size()));
+	hash.addData(QByteArray::number(info.lastModified(QTimeZone::UTC).toMSecsSinceEpoch()));
+	hash.addData(encoding);
+
+	return QByteArrayLiteral("\"")+hash.result().toHex()+QByteArrayLiteral("\"");
+}
+
+
+
+/**
+ * @brief ContentServer::httpDate
+ * @param dateTime
+ * @return
+ */
+
+QByteArray ContentServer::httpDate(const QDateTime &dateTime)
+{
+	return QLocale::c().toString(dateTime.toUTC(), QStringLiteral("ddd, dd MMM yyyy hh:mm:ss 'GMT'")).toLatin1();
+}
+
+
+
+/**
+ * @brief ContentServer::acceptEncoding
+ * @param header
+ * @param encoding
+ * @return
+ */
+
+bool ContentServer::acceptEncoding(const QByteArray &header, const QByteArray &encoding)
+{
+	for (const QByteArray &part : header.split(',')) {
+		const QList<QByteArray> &params = part.split(';');
+
+		if (params.first().trimmed().compare(encoding, Qt::CaseInsensitive) != 0)
+			continue;
+
+		for (qsizetype i=1; i<params.size(); ++i) {
+			const QByteArray &p = params.at(i).trimmed();
+			if (p.startsWith("q=") && p.mid(2).toDouble() <= 0.)
+				return false;
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+
+
+/**
+ * @brief ContentServer::cacheFileLimit
+ * @return
+ */
+
+qint64 ContentServer::cacheFileLimit() const
+{
+	return m_cacheFileLimit;
+}
+
+void ContentServer::setCacheFileLimit(const qint64 &newCacheFileLimit)
+{
+	m_cacheFileLimit = newCacheFileLimit;
+}
+
+
+/**
+ * @brief ContentServer::cacheLimit
+ * @return
+ */
+
+qint64 ContentServer::cacheLimit() const
+{
+	return m_cache.maxCost();
+}
+
+void ContentServer::setCacheLimit(const qint64 &newCacheLimit)
+{
+	QMutexLocker locker(&m_mutex);
+	m_cache.setMaxCost(newCacheLimit);
+}
+
+
+
+
+
+/**
+ * @brief ContentDevice::ContentDevice
+ * @param fileName
+ * @param offset
+ * @param length
+ * @param parent
+ */
+
+ContentDevice::ContentDevice(const QString &fileName, const qint64 &offset, const qint64 &length, QObject *parent)
+	: QIODevice(parent)
+	, m_file(fileName)
+	, m_offset(offset)
+	, m_length(length)
+{
+	open(QIODevice::ReadOnly);
+}
+
+
+/**
+ * @brief ContentDevice::~ContentDevice
+ */
+
+ContentDevice::~ContentDevice()
+{
+	close();
+}
+
+
+/**
+ * @brief ContentDevice::open
+ * @param mode
+ * @return
+ */
+
+bool ContentDevice::open(OpenMode mode)
+{
+	if (mode & QIODevice::WriteOnly)
+		return false;
+
+	if (!m_file.open(QIODevice::ReadOnly)) {
+		LOG_CWARNING("service") << "Can't open file:" << qPrintable(m_file.fileName());
+		return false;
+	}
+
+	if (m_length > 0)
+		m_map = m_file.map(m_offset, m_length);
+
+	if (!m_map && !m_file.seek(m_offset)) {
+		LOG_CWARNING("service") << "Can't seek file:" << qPrintable(m_file.fileName()) << m_offset;
+		m_file.close();
+		return false;
+	}
+
+	return QIODevice::open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+
+/**
+ * @brief ContentDevice::close
+ */
+
+void ContentDevice::close()
+{
+	if (m_map) {
+		m_file.unmap(m_map);
+		m_map = nullptr;
+	}
+
+	m_file.close();
+
+	QIODevice::close();
+}
+
+
+/**
+ * @brief ContentDevice::readData
+ * @param data
+ * @param maxSize
+ * @return
+ */
+
+qint64 ContentDevice::readData(char *data, qint64 maxSize)
+{
+	const qint64 p = pos();
+	const qint64 len = std::min(maxSize, m_length-p);
+
+	if (len <= 0)
+		return 0;
+
+	if (m_map) {
+		std::memcpy(data, m_map+p, len);
+		return len;
+	}
+
+	if (m_file.pos() != m_offset+p && !m_file.seek(m_offset+p))
+		return -1;
+
+	return m_file.read(data, len);
+}
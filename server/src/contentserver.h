@@ -0,0 +1,150 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * contentserver.h
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * ContentServer
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONTENTSERVER_H
+#define CONTENTSERVER_H
+
+#include <QHttpServerRequest>
+#include <QHttpServerResponder>
+#include <QHttpHeaders>
+#include <QCache>
+#include <QMutex>
+#include <QDateTime>
+#include <QFile>
+
+
+/**
+ * @brief The ContentServer class
+ *
+ * Serves files (static content and resource packs) without loading them into memory.
+ * Small files are cached, large files are memory mapped and streamed through the responder.
+ * Supports Range, If-Range, If-None-Match and precompressed (.br, .gz) variants.
+ */
+
+class ContentServer
+{
+public:
+	ContentServer();
+	virtual ~ContentServer();
+
+	bool serve(const QString &fileName, const QHttpServerRequest &request, QHttpServerResponder &responder);
+	void clear();
+
+	qint64 cacheFileLimit() const;
+	void setCacheFileLimit(const qint64 &newCacheFileLimit);
+
+	qint64 cacheLimit() const;
+	void setCacheLimit(const qint64 &newCacheLimit);
+
+	static QByteArray mimeType(const QString &fileName);
+	static bool acceptEncoding(const QByteArray &header, const QByteArray &encoding);
+
+private:
+
+	/**
+	 * @brief The FileInfo class
+	 */
+
+	struct FileInfo {
+		QString path;
+		QByteArray encoding;
+		qint64 size = 0;
+		QDateTime lastModified;
+		QByteArray etag;
+	};
+
+
+	/**
+	 * @brief The CacheItem class
+	 */
+
+	struct CacheItem {
+		QByteArray data;
+		qint64 size = 0;
+		QDateTime lastModified;
+	};
+
+
+	/**
+	 * @brief The Range class
+	 */
+
+	struct Range {
+		qint64 first = 0;
+		qint64 last = -1;
+	};
+
+	enum RangeResult {
+		RangeNone = 0,
+		RangeValid,
+		RangeUnsatisfiable
+	};
+
+	std::optional<FileInfo> resolve(const QString &fileName, const QHttpServerRequest &request) const;
+	RangeResult parseRange(const QHttpServerRequest &request, const FileInfo &info, Range *range) const;
+	QByteArray cachedContent(const FileInfo &info);
+
+	static QByteArray etag(const QFileInfo &info, const QByteArray &encoding);
+	static QByteArray httpDate(const QDateTime &dateTime);
+
+	QMutex m_mutex;
+	QCache<QString, CacheItem> m_cache;
+	qint64 m_cacheFileLimit = 256*1024;
+};
+
+
+
+/**
+ * @brief The ContentDevice class
+ *
+ * Read-only window over a memory mapped file (falls back to seek/read if mapping isn't supported)
+ */
+
+class ContentDevice : public QIODevice
+{
+	Q_OBJECT
+
+public:
+	ContentDevice(const QString &fileName, const qint64 &offset, const qint64 &length, QObject *parent = nullptr);
+	virtual ~ContentDevice();
+
+	bool open(OpenMode mode) override;
+	void close() override;
+	bool isSequential() const override { return false; }
+	qint64 size() const override { return m_length; }
+
+protected:
+	qint64 readData(char *data, qint64 maxSize) override;
+	qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+	QFile m_file;
+	const qint64 m_offset;
+	const qint64 m_length;
+	uchar *m_map = nullptr;
+};
+
+#endif // CONTENTSERVER_H
@@ -0,0 +1,113 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * credentialcache.cpp
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * CredentialCache
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "credentialcache.h"
+#include "Logger.h"
+
+
+/**
+ * @brief CredentialCache::CredentialCache
+ * @param capacity
+ */
+
+CredentialCache::CredentialCache(const int &capacity)
+{
+	for (Shard &s : m_shards)
+		s.cache.setMaxCost(std::max(1, capacity / m_shardCount));
+}
+
+
+/**
+ * @brief CredentialCache::~CredentialCache
+ */
+
+CredentialCache::~CredentialCache()
+{
+
+}
+
+
+
+/**
+ * @brief CredentialCache::verify
+ * @param token
+ * @param secret
+ * @param firstIat
+ * @return
+ */
+
+std::optional<Credential> CredentialCache::verify(const QByteArray &token, const QByteArray &secret, const qint64 &firstIat)
+{
+	if (token.isEmpty())
+		return std::nullopt;
+
+	if (m_firstIat.fetchAndStoreRelaxed(firstIat) != firstIat)
+		invalidate();
+
+	Shard &s = shard(token);
+
+	{
+		QMutexLocker locker(&s.mutex);
+
+		if (const Credential *c = s.cache.object(token)) {
+			if (c->exp() > QDateTime::currentSecsSinceEpoch() && (firstIat <= 0 || c->iat() >= firstIat)) {
+				return *c;
+			}
+
+			s.cache.remove(token);
+			return std::nullopt;
+		}
+	}
+
+	if (!Credential::verify(token, secret, firstIat))
+		return std::nullopt;
+
+	Credential c = Credential::fromJWT(token);
+
+	if (!c.isValid())
+		return std::nullopt;
+
+	QMutexLocker locker(&s.mutex);
+	s.cache.insert(token, new Credential(c));
+
+	return c;
+}
+
+
+
+/**
+ * @brief CredentialCache::invalidate
+ */
+
+void CredentialCache::invalidate()
+{
+	LOG_CTRACE("service") << "Invalidate credential cache";
+
+	for (Shard &s : m_shards) {
+		QMutexLocker locker(&s.mutex);
+		s.cache.clear();
+	}
+}
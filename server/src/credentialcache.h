@@ -0,0 +1,68 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * credentialcache.h
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * CredentialCache
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CREDENTIALCACHE_H
+#define CREDENTIALCACHE_H
+
+#include "credential.h"
+#include <QCache>
+#include <QMutex>
+
+
+/**
+ * @brief The CredentialCache class
+ *
+ * Sharded LRU cache of verified JWT tokens. Entries are valid until the token expires
+ * or tokenFirstIat changes (all entries are dropped).
+ */
+
+class CredentialCache
+{
+public:
+	CredentialCache(const int &capacity = 8192);
+	virtual ~CredentialCache();
+
+	std::optional<Credential> verify(const QByteArray &token, const QByteArray &secret, const qint64 &firstIat);
+
+	void invalidate();
+
+private:
+	static constexpr int m_shardCount = 16;
+
+	struct Shard {
+		QMutex mutex;
+		QCache<QByteArray, Credential> cache;
+	};
+
+	Shard &shard(const QByteArray &token) {
+		return m_shards[qHash(token) % m_shardCount];
+	}
+
+	std::array<Shard, m_shardCount> m_shards;
+	QAtomicInteger<qint64> m_firstIat = 0;
+};
+
+#endif // CREDENTIALCACHE_H
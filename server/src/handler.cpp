@@ -43,6 +43,7 @@
 Handler::Handler(ServerService *service, QObject *parent)
 	: QObject{parent}
 	, m_service(service)
+	, m_contentServer(new ContentServer)
 {
 	Q_ASSERT(m_service);
 
@@ -98,8 +99,8 @@ bool Handler::loadRoutes()
 	});
 
 	server->route("/content/", QHttpServerRequest::Method::Get,
-				  [this](const QString &fname, const QHttpServerRequest &request){
-		return getDynamicContent(fname, request);
+				  [this](const QString &fname, const QHttpServerRequest &request, QHttpServerResponder &responder){
+		getDynamicContent(fname, request, responder);
 	});
 
 
@@ -113,7 +114,14 @@ bool Handler::loadRoutes()
 			authorizeRequestLog(request);
 			responder.sendResponse(std::move(AbstractAPI::responseError("invalid api request", QHttpServerResponse::StatusCode::NotFound)));
 		} else
-			responder.sendResponse(std::move(getStaticContent(request)));
+			getStaticContent(request, responder);
+	});
+
+
+	// Compress API responses
+
+	server->addAfterRequestHandler(server, [this](const QHttpServerRequest &request, QHttpServerResponse &response){
+		compressResponse(request, response);
 	});
 
 
@@ -147,15 +155,11 @@ std::optional<Credential> Handler::authorizeRequest(const QHttpServerRequest &re
 	if (token.startsWith(bearer))
 		token.remove(0, strlen(bearer));
 
-	if (!Credential::verify(token, m_service->settings()->jwtSecret(), m_service->config().get("tokenFirstIat").toInteger(0))) {
-		LOG_CDEBUG("client") << "Token verification failed" << token;
-		return std::nullopt;
-	}
-
-	Credential c = Credential::fromJWT(token);
+	const auto &c = m_service->credentialCache()->verify(token, m_service->settings()->jwtSecret(),
+														 m_service->config().tokenFirstIat());
 
-	if (!c.isValid()) {
-		LOG_CDEBUG("client") << "Invalid token";
+	if (!c) {
+		LOG_CDEBUG("client") << "Token verification failed" << token;
 		return std::nullopt;
 	}
 
@@ -225,10 +229,10 @@ QHttpServerResponse Handler::getFavicon(const QHttpServerRequest &request)
 /**
  * @brief Handler::getStaticContent
  * @param request
- * @return
+ * @param responder
  */
 
-QHttpServerResponse Handler::getStaticContent(const QHttpServerRequest &request)
+void Handler::getStaticContent(const QHttpServerRequest &request, QHttpServerResponder &responder)
 {
 	authorizeRequestLog(request);
 
@@ -243,72 +247,52 @@ QHttpServerResponse Handler::getStaticContent(const QHttpServerRequest &request)
 	if (path.isEmpty())
 		path = QStringLiteral("index.html");
 
-	QString fname;
-	bool isHtml = false;
+	if (path.contains(QStringLiteral(".."))) {
+		LOG_CWARNING("service") << "Invalid static content request:" << path;
+		responder.sendResponse(getErrorPage(tr("Érvénytelen útvonal")));
+		return;
+	}
 
 	if (htmlDir.exists(path)) {
-		fname = htmlDir.absoluteFilePath(path);
-		isHtml = true;
-	} else if (dir.exists(path))
-		fname = dir.absoluteFilePath(path);
+		const QString &fname = htmlDir.absoluteFilePath(path);
 
-	if (!fname.isEmpty() && QFile::exists(fname)) {
 		LOG_CTRACE("service") << "HTTP response file content:" << fname;
 
-		if (isHtml) {
-			QByteArray b;
-			QFile f(fname);
-			if (f.open(QIODevice::ReadOnly)) {
-				b = f.readAll();
-				f.close();
-			}
+		QByteArray b;
+		QFile f(fname);
+		if (f.open(QIODevice::ReadOnly)) {
+			b = f.readAll();
+			f.close();
+		}
 
-			QByteArray contentType;
-			const auto &server= m_service->webServer().lock();
+		const auto &server= m_service->webServer().lock();
 
-			QByteArray hostname = QStringLiteral("callofsuli://%1:%2").arg(server ? server->redirectHost() : QStringLiteral("invalid"))
-								  .arg(m_service->settings()->listenPort()).toUtf8();
+		QByteArray hostname = QStringLiteral("callofsuli://%1:%2").arg(server ? server->redirectHost() : QStringLiteral("invalid"))
+							  .arg(m_service->settings()->listenPort()).toUtf8();
 
-			if (m_service->settings()->ssl())
-				hostname.append(QByteArrayLiteral("/?ssl=1"));
+		if (m_service->settings()->ssl())
+			hostname.append(QByteArrayLiteral("/?ssl=1"));
 
-			b.replace(QByteArrayLiteral("${server:name}"), m_service->serverName().toUtf8())
-					.replace(QByteArrayLiteral("${server:connect}"), hostname);
+		b.replace(QByteArrayLiteral("${server:name}"), m_service->serverName().toUtf8())
+				.replace(QByteArrayLiteral("${server:connect}"), hostname);
 
-			if (fname.endsWith(QStringLiteral("css")))
-				contentType = QByteArrayLiteral("text/css");
-			else if (fname.endsWith(QStringLiteral("js")))
-				contentType = QByteArrayLiteral("text/javascript");
-			else if (fname.endsWith(QStringLiteral("html")) || fname.endsWith(QStringLiteral("htm")))
-				contentType = QByteArrayLiteral("text/html");
-			else if (fname.endsWith(QStringLiteral("wasm")))
-				contentType = QByteArrayLiteral("application/wasm");
+		responder.sendResponse(QHttpServerResponse(ContentServer::mimeType(fname), b, QHttpServerResponder::StatusCode::Ok));
+		return;
+	}
 
-			return QHttpServerResponse(contentType, b, QHttpServerResponder::StatusCode::Ok);
-		}
+	if (dir.exists(path)) {
+		const QString &fname = dir.absoluteFilePath(path);
 
-		if (QFile::exists(fname)) {
-			if (fname.endsWith(QStringLiteral("html")) || fname.endsWith(QStringLiteral("htm"))
-					|| fname.endsWith(QStringLiteral("wasm"))) {
-				QByteArray b;
-				QFile f(fname);
-				if (f.open(QIODevice::ReadOnly)) {
-					b = f.readAll();
-					f.close();
-				}
-
-				return QHttpServerResponse(fname.endsWith(QStringLiteral("wasm")) ?
-															  QByteArrayLiteral("application/wasm") :
-															  QByteArrayLiteral("text/html"),
-														  b, QHttpServerResponder::StatusCode::Ok);
-			} else
-				return QHttpServerResponse::fromFile(fname);
-		} else
-			return getErrorPage(tr("A fájl nem található"));
+		LOG_CTRACE("service") << "HTTP response file content:" << fname;
+
+		if (!m_contentServer->serve(fname, request, responder))
+			responder.sendResponse(getErrorPage(tr("A fájl nem található")));
+
+		return;
 	}
 
 	LOG_CWARNING("service") << "Invalid static content request:" << path;
-	return getErrorPage(tr("Érvénytelen útvonal"));
+	responder.sendResponse(getErrorPage(tr("Érvénytelen útvonal")));
 }
 
 
@@ -386,20 +370,25 @@ QHttpServerResponse Handler::getCallback(const QHttpServerRequest &request)
 
 /**
  * @brief Handler::getDynamicContent
+ * @param fname
  * @param request
- * @return
+ * @param responder
  */
 
-QHttpServerResponse Handler::getDynamicContent(const QString &fname, const QHttpServerRequest &request)
+void Handler::getDynamicContent(const QString &fname, const QHttpServerRequest &request, QHttpServerResponder &responder)
 {
 	authorizeRequestLog(request);
 
+	if (fname.contains(QStringLiteral(".."))) {
+		LOG_CWARNING("service") << "Invalid dynamic content request:" << fname;
+		responder.sendResponse(getErrorPage(tr("Érvénytelen útvonal")));
+		return;
+	}
+
 	const QString &file = m_service->settings()->dataDir().absoluteFilePath(QStringLiteral("content/")+fname);
 
-	if (QFile::exists(file))
-		return QHttpServerResponse::fromFile(file);
-	else
-		return getErrorPage(tr("Hiányzó fájl"));
+	if (!m_contentServer->serve(file, request, responder))
+		responder.sendResponse(getErrorPage(tr("Hiányzó fájl")));
 }
 
 
@@ -417,6 +406,135 @@ void Handler::addApi(std::unique_ptr<AbstractAPI> api)
 
 
 
+/**
+ * @brief Handler::compressResponse
+ * @param request
+ * @param response
+ */
+
+void Handler::compressResponse(const QHttpServerRequest &request, QHttpServerResponse &response) const
+{
+	if (!request.url().path().startsWith(AbstractAPI::apiPath()))
+		return;
+
+	const QByteArray &data = response.data();
+
+	if (data.size() < m_compressThreshold)
+		return;
+
+	QHttpHeaders headers = response.headers();
+
+	if (headers.contains(QHttpHeaders::WellKnownHeader::ContentEncoding))
+		return;
+
+	const QByteArray &accept = request.value(QByteArrayLiteral("Accept-Encoding"));
+
+	QByteArray encoding;
+	QByteArray content;
+
+	// Brotli is not available, gzip is preferred (deflate is often misinterpreted by clients)
+
+	if (ContentServer::acceptEncoding(accept, QByteArrayLiteral("gzip"))) {
+		encoding = QByteArrayLiteral("gzip");
+		content = compressGzip(data);
+	} else if (ContentServer::acceptEncoding(accept, QByteArrayLiteral("deflate"))) {
+		encoding = QByteArrayLiteral("deflate");
+		content = compressDeflate(data);
+	} else {
+		return;
+	}
+
+	if (content.isEmpty() || content.size() >= data.size())
+		return;
+
+	LOG_CTRACE("service") << "Response compressed" << encoding << data.size() << "->" << content.size();
+
+	headers.replaceOrAppend(QHttpHeaders::WellKnownHeader::ContentEncoding, encoding);
+	headers.replaceOrAppend(QHttpHeaders::WellKnownHeader::Vary, QByteArrayLiteral("Accept-Encoding"));
+
+	QHttpServerResponse r(std::move(content), response.statusCode());
+	r.setHeaders(std::move(headers));
+
+	response = std::move(r);
+}
+
+
+
+/**
+ * @brief Handler::compressDeflate
+ * @param data
+ * @return
+ */
+
+QByteArray Handler::compressDeflate(const QByteArray &data)
+{
+	// qCompress: 4 bytes (expected size) + zlib stream (RFC 1950)
+
+	QByteArray b = qCompress(data, 6);
+
+	if (b.size() <= 4)
+		return {};
+
+	b.remove(0, 4);
+	return b;
+}
+
+
+
+/**
+ * @brief Handler::compressGzip
+ * @param data
+ * @return
+ */
+
+QByteArray Handler::compressGzip(const QByteArray &data)
+{
+	// zlib stream: 2 bytes header + raw deflate + 4 bytes adler32
+
+	const QByteArray &zlib = compressDeflate(data);
+
+	if (zlib.size() <= 6)
+		return {};
+
+	static const auto table = []{
+		std::array<quint32, 256> t;
+		for (quint32 i=0; i<256; ++i) {
+			quint32 c = i;
+			for (int k=0; k<8; ++k)
+				c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : (c >> 1);
+			t[i] = c;
+		}
+		return t;
+	}();
+
+	quint32 crc = 0xFFFFFFFFu;
+
+	for (const char c : data)
+		crc = table[(crc ^ static_cast<quint8>(c)) & 0xFF] ^ (crc >> 8);
+
+	crc ^= 0xFFFFFFFFu;
+
+	const quint32 size = static_cast<quint32>(data.size());
+
+	QByteArray b;
+	b.reserve(zlib.size()+12);
+
+	static const char header[] = { '\x1f', '\x8b', '\x08', 0, 0, 0, 0, 0, 0, '\xff' };
+
+	b.append(header, sizeof(header));
+	b.append(zlib.constData()+2, zlib.size()-6);
+
+	for (int i=0; i<4; ++i)
+		b.append(static_cast<char>((crc >> (8*i)) & 0xFF));
+
+	for (int i=0; i<4; ++i)
+		b.append(static_cast<char>((size >> (8*i)) & 0xFF));
+
+	return b;
+}
+
+
+
 /**
  * @brief Handler::getErrorPage
  * @param errorString
@@ -30,6 +30,7 @@
 #include "qhttpserver.h"
 #include <QObject>
 #include "abstractapi.h"
+#include "contentserver.h"
 
 class ServerService;
 
@@ -64,15 +65,22 @@ public:
 
 private:
 	QHttpServerResponse getFavicon(const QHttpServerRequest &request);
-	QHttpServerResponse getStaticContent(const QHttpServerRequest &request);
+	void getStaticContent(const QHttpServerRequest &request, QHttpServerResponder &responder);
 	QHttpServerResponse getCallback(const QHttpServerRequest &request);
-	QHttpServerResponse getDynamicContent(const QString &fname, const QHttpServerRequest &request);
+	void getDynamicContent(const QString &fname, const QHttpServerRequest &request, QHttpServerResponder &responder);
 
 	void addApi(std::unique_ptr<AbstractAPI> api);
+	void compressResponse(const QHttpServerRequest &request, QHttpServerResponse &response) const;
+
+	static QByteArray compressDeflate(const QByteArray &data);
+	static QByteArray compressGzip(const QByteArray &data);
+
+	static constexpr qsizetype m_compressThreshold = 2048;
 
 	ServerService *m_service = nullptr;
 
 	std::map<const char*, std::unique_ptr<AbstractAPI>> m_apis;
+	std::unique_ptr<ContentServer> m_contentServer;
 };
 
 #endif // HANDLER_H
@@ -0,0 +1,382 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * jsonstreamwriter.cpp
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * JsonStreamWriter
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "jsonstreamwriter.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QLocale>
+#include <cmath>
+
+
+/**
+ * @brief JsonStreamWriter::JsonStreamWriter
+ * @param reserve
+ */
+
+JsonStreamWriter::JsonStreamWriter(const qsizetype &reserve)
+{
+	m_data.reserve(reserve);
+}
+
+
+/**
+ * @brief JsonStreamWriter::beginObject
+ * @return
+ */
+
+JsonStreamWriter &JsonStreamWriter::beginObject()
+{
+	separator();
+	m_data.append('{');
+	m_first.append(true);
+	return *this;
+}
+
+
+/**
+ * @brief JsonStreamWriter::endObject
+ * @return
+ */
+
+JsonStreamWriter &JsonStreamWriter::endObject()
+{
+	Q_ASSERT(!m_first.isEmpty());
+	m_first.removeLast();
+	m_data.append('}');
+	return *this;
+}
+
+
+/**
+ * @brief JsonStreamWriter::beginArray
+ * @return
+ */
+
+JsonStreamWriter &JsonStreamWriter::beginArray()
+{
+	separator();
+	m_data.append('[');
+	m_first.append(true);
+	return *this;
+}
+
+
+/**
+ * @brief JsonStreamWriter::endArray
+ * @return
+ */
+
+JsonStreamWriter &JsonStreamWriter::endArray()
+{
+	Q_ASSERT(!m_first.isEmpty());
+	m_first.removeLast();
+	m_data.append(']');
+	return *this;
+}
+
+
+/**
+ * @brief JsonStreamWriter::key
+ * @param key
+ * @return
+ */
+
+JsonStreamWriter &JsonStreamWriter::key(QLatin1StringView key)
+{
+	separator();
+	m_data.append('"').append(key.data(), key.size()).append("\":");
+	m_afterKey = true;
+	return *this;
+}
+
+
+/**
+ * @brief JsonStreamWriter::key
+ * @param key
+ * @return
+ */
+
+JsonStreamWriter &JsonStreamWriter::key(const QString &key)
+{
+	separator();
+	writeString(key);
+	m_data.append(':');
+	m_afterKey = true;
+	return *this;
+}
+
+
+/**
+ * @brief JsonStreamWriter::null
+ * @return
+ */
+
+JsonStreamWriter &JsonStreamWriter::null()
+{
+	separator();
+	m_data.append("null");
+	return *this;
+}
+
+
+/**
+ * @brief JsonStreamWriter::value
+ * @param value
+ * @return
+ */
+
+JsonStreamWriter &JsonStreamWriter::value(const bool &value)
+{
+	separator();
+	m_data.append(value ? "true" : "false");
+	return *this;
+}
+
+
+/**
+ * @brief JsonStreamWriter::value
+ * @param value
+ * @return
+ */
+
+JsonStreamWriter &JsonStreamWriter::value(const qint64 &value)
+{
+	separator();
+	m_data.append(QByteArray::number(value));
+	return *this;
+}
+
+
+/**
+ * @brief JsonStreamWriter::value
+ * @param value
+ * @return
+ */
+
+JsonStreamWriter &JsonStreamWriter::value(const double &value)
+{
+	if (!std::isfinite(value))
+		return null();
+
+	separator();
+	m_data.append(QByteArray::number(value, 'g', QLocale::FloatingPointShortest));
+	return *this;
+}
+
+
+/**
+ * @brief JsonStreamWriter::value
+ * @param value
+ * @return
+ */
+
+JsonStreamWriter &JsonStreamWriter::value(QStringView value)
+{
+	separator();
+	writeString(value);
+	return *this;
+}
+
+
+/**
+ * @brief JsonStreamWriter::value
+ * @param value
+ * @return
+ */
+
+JsonStreamWriter &JsonStreamWriter::value(const QJsonValue &value)
+{
+	switch (value.type()) {
+		case QJsonValue::Null:
+		case QJsonValue::Undefined:
+			return null();
+		case QJsonValue::Bool:
+			return this->value(value.toBool());
+		case QJsonValue::Double: {
+			const double d = value.toDouble();
+			if (d == std::floor(d) && std::fabs(d) < 9007199254740992.)
+				return this->value(static_cast<qint64>(d));
+			return this->value(d);
+		}
+		case QJsonValue::String:
+			return this->value(QStringView(value.toString()));
+		case QJsonValue::Array:
+			separator();
+			m_data.append(QJsonDocument(value.toArray()).toJson(QJsonDocument::Compact));
+			return *this;
+		case QJsonValue::Object:
+			separator();
+			m_data.append(QJsonDocument(value.toObject()).toJson(QJsonDocument::Compact));
+			return *this;
+	}
+
+	return null();
+}
+
+
+/**
+ * @brief JsonStreamWriter::value
+ * @param value
+ * @return
+ */
+
+JsonStreamWriter &JsonStreamWriter::value(const QVariant &value)
+{
+	if (value.isNull())
+		return null();
+
+	switch (value.typeId()) {
+		case QMetaType::Bool:
+			return this->value(value.toBool());
+		case QMetaType::Int:
+		case QMetaType::UInt:
+		case QMetaType::Long:
+		case QMetaType::LongLong:
+		case QMetaType::Short:
+		case QMetaType::UShort:
+			return this->value(value.toLongLong());
+		case QMetaType::Double:
+		case QMetaType::Float:
+			return this->value(value.toDouble());
+		case QMetaType::QString:
+			return this->value(QStringView(value.toString()));
+		default:
+			return this->value(value.toJsonValue());
+	}
+}
+
+
+/**
+ * @brief JsonStreamWriter::record
+ * @param record
+ * @return
+ */
+
+JsonStreamWriter &JsonStreamWriter::record(const QSqlRecord &record)
+{
+	beginObject();
+
+	for (int i=0; i<record.count(); ++i)
+		key(record.fieldName(i)).value(record.value(i));
+
+	return endObject();
+}
+
+
+/**
+ * @brief JsonStreamWriter::records
+ * @param query
+ * @param onRow
+ * @return
+ */
+
+JsonStreamWriter &JsonStreamWriter::records(QSqlQuery &query, const std::function<void (const QSqlQuery &)> &onRow)
+{
+	beginArray();
+
+	if (query.next()) {
+		const QSqlRecord &rec = query.record();
+		QVarLengthArray<QString, 16> names;
+
+		for (int i=0; i<rec.count(); ++i)
+			names.append(rec.fieldName(i));
+
+		do {
+			beginObject();
+
+			for (int i=0; i<names.size(); ++i)
+				key(names.at(i)).value(query.value(i));
+
+			endObject();
+
+			if (onRow)
+				onRow(query);
+		} while (query.next());
+	}
+
+	return endArray();
+}
+
+
+
+
+/**
+ * @brief JsonStreamWriter::separator
+ */
+
+void JsonStreamWriter::separator()
+{
+	if (m_afterKey) {
+		m_afterKey = false;
+		return;
+	}
+
+	if (m_first.isEmpty())
+		return;
+
+	if (m_first.last())
+		m_first.last() = false;
+	else
+		m_data.append(',');
+}
+
+
+
+/**
+ * @brief JsonStreamWriter::writeString
+ * @param str
+ */
+
+void JsonStreamWriter::writeString(QStringView str)
+{
+	static const char hex[] = "0123456789abcdef";
+
+	const QByteArray &utf8 = str.toUtf8();
+
+	m_data.append('"');
+
+	for (const char c : utf8) {
+		switch (c) {
+			case '"': m_data.append("\\\""); break;
+			case '\\': m_data.append("\\\\"); break;
+			case '\b': m_data.append("\\b"); break;
+			case '\f': m_data.append("\\f"); break;
+			case '\n': m_data.append("\\n"); break;
+			case '\r': m_data.append("\\r"); break;
+			case '\t': m_data.append("\\t"); break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					m_data.append("\\u00").append(hex[(c >> 4) & 0xF]).append(hex[c & 0xF]);
+				} else {
+					m_data.append(c);
+				}
+				break;
+		}
+	}
+
+	m_data.append('"');
+}
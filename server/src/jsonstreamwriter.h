@@ -0,0 +1,89 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * jsonstreamwriter.h
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * JsonStreamWriter
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSONSTREAMWRITER_H
+#define JSONSTREAMWRITER_H
+
+#include <QByteArray>
+#include <QJsonValue>
+#include <QSqlRecord>
+#include <QSqlQuery>
+#include <QVarLengthArray>
+#include <functional>
+
+
+/**
+ * @brief The JsonStreamWriter class
+ *
+ * Writes compact JSON directly into a byte buffer (without building QJsonObject/QJsonArray).
+ * SQL rows are emitted field by field from QSqlQuery.
+ */
+
+class JsonStreamWriter
+{
+public:
+	JsonStreamWriter(const qsizetype &reserve = 4096);
+
+	JsonStreamWriter &beginObject();
+	JsonStreamWriter &endObject();
+	JsonStreamWriter &beginArray();
+	JsonStreamWriter &endArray();
+
+	JsonStreamWriter &key(QLatin1StringView key);
+	JsonStreamWriter &key(const QString &key);
+
+	JsonStreamWriter &null();
+	JsonStreamWriter &value(const bool &value);
+	JsonStreamWriter &value(const int &v) { return value(static_cast<qint64>(v)); }
+	JsonStreamWriter &value(const qint64 &value);
+	JsonStreamWriter &value(const double &value);
+	JsonStreamWriter &value(QStringView value);
+	JsonStreamWriter &value(const QString &v) { return value(QStringView(v)); }
+	JsonStreamWriter &value(const char *) = delete;
+	JsonStreamWriter &value(const QJsonValue &value);
+	JsonStreamWriter &value(const QVariant &value);
+
+	JsonStreamWriter &record(const QSqlRecord &record);
+	JsonStreamWriter &records(QSqlQuery &query, const std::function<void(const QSqlQuery &)> &onRow = nullptr);
+
+	template <typename T>
+	JsonStreamWriter &field(QLatin1StringView name, const T &v) { return key(name).value(v); }
+
+	const QByteArray &data() const { return m_data; }
+	QByteArray take() { return std::move(m_data); }
+
+	bool isComplete() const { return m_first.isEmpty() && !m_data.isEmpty(); }
+
+private:
+	void separator();
+	void writeString(QStringView str);
+
+	QByteArray m_data;
+	QVarLengthArray<bool, 16> m_first;
+	bool m_afterKey = false;
+};
+
+#endif // JSONSTREAMWRITER_H
@@ -0,0 +1,596 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * notificationsender.cpp
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * NotificationSender
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "notificationsender.h"
+#include "Logger.h"
+#include "commonsettings.h"
+#include "mimehtml.h"
+#include "querybuilder.hpp"
+#include "serverservice.h"
+#include "utils_.h"
+#include <QDir>
+#include <QLocale>
+
+
+#define NOTIFICATION_BATCH_SIZE			50
+#define NOTIFICATION_TIMER_INTERVAL		60*1000
+#define NOTIFICATION_RETRY_BASE			60
+#define NOTIFICATION_RETRY_MAX			6*60*60
+#define NOTIFICATION_MAX_ATTEMPTS		10
+#define NOTIFICATION_BATCH_TIMEOUT		5*60*1000
+
+
+
+/**
+ * @brief NotificationSender::NotificationSender
+ * @param service
+ */
+
+NotificationSender::NotificationSender(ServerService *service)
+{
+	Q_ASSERT(service);
+
+	d = new NotificationSenderPrivate(service);
+	d->moveToThread(&m_dThread);
+	QObject::connect(&m_dThread, &QThread::started, d, &NotificationSenderPrivate::start);
+	QObject::connect(&m_dThread, &QThread::finished, d, &QObject::deleteLater);
+	m_dThread.start();
+
+	LOG_CTRACE("service") << "NotificationSender created";
+}
+
+
+/**
+ * @brief NotificationSender::~NotificationSender
+ */
+
+NotificationSender::~NotificationSender()
+{
+	d = nullptr;
+	m_dThread.quit();
+	m_dThread.wait();
+
+	LOG_CTRACE("service") << "NotificationSender destroyed";
+}
+
+
+/**
+ * @brief NotificationSender::trigger
+ * Process queue (called after enqueue)
+ * @param serverName
+ */
+
+void NotificationSender::trigger(const QString &serverName)
+{
+	if (!d)
+		return;
+
+	QMetaObject::invokeMethod(d, [p = d, serverName]() {
+		p->m_serverName = serverName;
+		p->process();
+	}, Qt::QueuedConnection);
+}
+
+
+
+
+
+/**
+ * @brief NotificationSenderPrivate::NotificationSenderPrivate
+ * @param service
+ */
+
+NotificationSenderPrivate::NotificationSenderPrivate(ServerService *service)
+	: QObject()
+	, m_dbMain(service->databaseMain())
+	, m_serverName(service->serverName())
+	, m_sinkDir(service->settings()->smtpSink())
+{
+	Q_ASSERT(m_dbMain);
+
+	QUrl url;
+	url.setScheme(service->settings()->ssl() ? QStringLiteral("https") : QStringLiteral("http"));
+	url.setHost(service->settings()->redirectHost());
+	url.setPort(service->settings()->listenPort());
+	url.setPath(QStringLiteral("/callofsuli.html"));
+
+	m_serverUrl = url.toString();
+
+	if (const auto &ptr = Utils::fileContent(QStringLiteral(":/html/email-campaign.html")))
+		m_content = ptr.value();
+	else
+		LOG_CERROR("service") << "Invalid email content";
+
+	m_smtp.host = service->settings()->smtpHost();
+	m_smtp.port = service->settings()->smtpPort();
+	m_smtp.ssl = service->settings()->smtpSsl();
+	m_smtp.user = service->settings()->smtpUser();
+	m_smtp.password = service->settings()->smtpPassword();
+}
+
+
+/**
+ * @brief NotificationSenderPrivate::~NotificationSenderPrivate
+ */
+
+NotificationSenderPrivate::~NotificationSenderPrivate()
+{
+	m_timer.stop();
+	m_smtpServer.reset();
+}
+
+
+
+/**
+ * @brief NotificationSenderPrivate::start
+ */
+
+void NotificationSenderPrivate::start()
+{
+	// The SMTP connection is created (and reused) in the sender thread
+
+	if (m_sinkDir.isEmpty()) {
+		createSmtpServer();
+		LOG_CDEBUG("service") << "SMTP client started";
+	} else {
+		LOG_CINFO("service") << "SMTP sink:" << qPrintable(m_sinkDir);
+	}
+
+	m_timer.start(NOTIFICATION_TIMER_INTERVAL, Qt::VeryCoarseTimer, this);
+	process();
+}
+
+
+
+/**
+ * @brief NotificationSenderPrivate::createSmtpServer
+ */
+
+void NotificationSenderPrivate::createSmtpServer()
+{
+	m_smtpServer.reset(new SimpleMail::Server);
+	m_smtpServer->setHost(m_smtp.host);
+	m_smtpServer->setPort(m_smtp.port);
+	m_smtpServer->setConnectionType(m_smtp.ssl ? SimpleMail::Server::SslConnection : SimpleMail::Server::TcpConnection);
+	m_smtpServer->setUsername(m_smtp.user);
+	m_smtpServer->setPassword(m_smtp.password);
+}
+
+
+
+/**
+ * @brief NotificationSenderPrivate::timerEvent
+ * @param event
+ */
+
+void NotificationSenderPrivate::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_timer.timerId())
+		process();
+	else if (event->timerId() == m_batchTimer.timerId())
+		batchTimeout();
+	else
+		QObject::timerEvent(event);
+}
+
+
+
+/**
+ * @brief NotificationSenderPrivate::process
+ * Fetch the next batch of due notifications and deliver them
+ */
+
+void NotificationSenderPrivate::process()
+{
+	// Egy futó köteg közben érkező kérést a köteg végén pótolunk
+
+	if (m_busy) {
+		m_triggered = true;
+		return;
+	}
+
+	m_triggered = false;
+
+	if (m_content.isEmpty())
+		return;
+
+	const auto &list = fetch();
+
+	if (!list) {
+		LOG_CERROR("service") << "Notification queue fetch failed";
+		return;
+	}
+
+	if (list->isEmpty())
+		return;
+
+	m_busy = true;
+	m_batchFull = list->size() >= NOTIFICATION_BATCH_SIZE;
+	m_sent.clear();
+	m_failed.clear();
+	m_inFlight.clear();
+
+	for (const Item &item : *list)
+		m_inFlight.insert(item.id, item);
+
+	if (!m_elapsed.isValid()) {
+		m_elapsed.start();
+		m_sentTotal = 0;
+	}
+
+	for (const Item &item : *list) {
+		const SimpleMail::MimeMessage msg = message(item);
+
+		if (!m_smtpServer) {
+			itemFinished(item, writeSink(item, msg));
+			continue;
+		}
+
+		SimpleMail::ServerReply *reply = m_smtpServer->sendMail(msg);
+
+		if (!reply) {
+			LOG_CERROR("service") << "SMTP send failed:" << qPrintable(item.email);
+			itemFinished(item, false);
+			continue;
+		}
+
+		QObject::connect(reply, &SimpleMail::ServerReply::finished, this, [this, reply, item] {
+			if (reply->error())
+				LOG_CERROR("service") << "SMTP error:" << qPrintable(item.email) << qPrintable(reply->responseText());
+			else
+				LOG_CINFO("service") << "Notification sent:" << qPrintable(item.email) << qPrintable(reply->responseText());
+
+			itemFinished(item, !reply->error());
+			reply->deleteLater();
+		});
+	}
+
+	// Ha az SMTP kapcsolat elakad (timeout, bontás), a köteg nem maradhat nyitva
+
+	if (m_busy)
+		m_batchTimer.start(NOTIFICATION_BATCH_TIMEOUT, this);
+}
+
+
+
+
+/**
+ * @brief NotificationSenderPrivate::fetch
+ * @return
+ */
+
+std::optional<QVector<NotificationSenderPrivate::Item> > NotificationSenderPrivate::fetch() const
+{
+	QDefer ret;
+	QVector<Item> list;
+
+	m_dbMain->worker()->execInThread([ret, this, &list]() mutable {
+		QSqlDatabase db = QSqlDatabase::database(m_dbMain->dbName());
+
+		QMutexLocker _locker(m_dbMain->mutex());
+
+		QueryBuilder q(db);
+
+		q.addQuery("SELECT id, username, familyName, givenName, type, campaignid, description, endTime, attempts "
+				   "FROM notificationQueue WHERE nextTry<=").addValue(QDateTime::currentSecsSinceEpoch())
+				.addQuery(" ORDER BY id LIMIT ").addValue(NOTIFICATION_BATCH_SIZE);
+
+		if (!q.exec())
+			return ret.reject();
+
+		while (q.sqlQuery().next()) {
+			Item item;
+			item.id = q.value("id").toInt();
+			item.email = q.value("username").toString();
+			item.familyName = q.value("familyName").toString();
+			item.givenName = q.value("givenName").toString();
+			item.type = q.value("type").toInt();
+			item.campaign = q.value("campaignid").toInt();
+			item.description = q.value("description").toString();
+			item.endTime = q.value("endTime").toDateTime();
+			item.attempts = q.value("attempts").toInt();
+			list.append(item);
+		}
+
+		ret.resolve();
+	});
+
+	QDefer::await(ret);
+
+	if (ret.state() != RESOLVED)
+		return std::nullopt;
+
+	return list;
+}
+
+
+
+/**
+ * @brief NotificationSenderPrivate::itemFinished
+ * @param item
+ * @param success
+ */
+
+void NotificationSenderPrivate::itemFinished(const Item &item, const bool &success)
+{
+	// Reply after the batch has been closed (timeout)
+
+	if (!m_inFlight.remove(item.id))
+		return;
+
+	if (success)
+		m_sent.append(item.id);
+	else
+		m_failed.append(item);
+
+	if (!m_inFlight.isEmpty())
+		return;
+
+	finish();
+}
+
+
+
+/**
+ * @brief NotificationSenderPrivate::batchTimeout
+ * Close the batch: undelivered items are rescheduled, the SMTP connection is recreated
+ */
+
+void NotificationSenderPrivate::batchTimeout()
+{
+	m_batchTimer.stop();
+
+	if (!m_busy || m_inFlight.isEmpty())
+		return;
+
+	LOG_CERROR("service") << "SMTP timeout, undelivered notifications:" << m_inFlight.size();
+
+	for (const Item &item : std::as_const(m_inFlight))
+		m_failed.append(item);
+
+	m_inFlight.clear();
+
+	if (m_smtpServer)
+		createSmtpServer();
+
+	finish();
+}
+
+
+
+/**
+ * @brief NotificationSenderPrivate::finish
+ * Remove delivered notifications, reschedule failed ones with exponential backoff
+ */
+
+void NotificationSenderPrivate::finish()
+{
+	m_batchTimer.stop();
+
+	QDefer ret;
+
+	m_dbMain->worker()->execInThread([ret, this]() mutable {
+		QSqlDatabase db = QSqlDatabase::database(m_dbMain->dbName());
+
+		QMutexLocker _locker(m_dbMain->mutex());
+
+		db.transaction();
+
+		for (const int &id : std::as_const(m_sent)) {
+			if (!QueryBuilder::q(db).addQuery("DELETE FROM notificationQueue WHERE id=").addValue(id).exec()) {
+				db.rollback();
+				return ret.reject();
+			}
+		}
+
+		const qint64 now = QDateTime::currentSecsSinceEpoch();
+
+		for (const Item &item : std::as_const(m_failed)) {
+			const int attempts = item.attempts+1;
+
+			if (attempts >= NOTIFICATION_MAX_ATTEMPTS) {
+				LOG_CERROR("service") << "Notification dropped after" << attempts << "attempts:" << qPrintable(item.email);
+
+				if (!QueryBuilder::q(db).addQuery("DELETE FROM notificationQueue WHERE id=").addValue(item.id).exec()) {
+					db.rollback();
+					return ret.reject();
+				}
+
+				continue;
+			}
+
+			const qint64 delay = std::min<qint64>((qint64) NOTIFICATION_RETRY_BASE << item.attempts, NOTIFICATION_RETRY_MAX);
+
+			if (!QueryBuilder::q(db)
+					.addQuery("UPDATE notificationQueue SET ").setCombinedPlaceholder()
+					.addField("attempts", attempts)
+					.addField("nextTry", now+delay)
+					.addQuery(" WHERE id=").addValue(item.id)
+					.exec()) {
+				db.rollback();
+				return ret.reject();
+			}
+		}
+
+		db.commit();
+
+		ret.resolve();
+	});
+
+	QDefer::await(ret);
+
+	if (ret.state() != RESOLVED)
+		LOG_CERROR("service") << "Notification queue update failed";
+
+	m_sentTotal += m_sent.size();
+
+	if (!m_sent.isEmpty() || !m_failed.isEmpty()) {
+		const qint64 msec = std::max<qint64>(1, m_elapsed.elapsed());
+		LOG_CDEBUG("service") << "Notifications delivered:" << m_sent.size() << "failed:" << m_failed.size()
+							  << "total:" << m_sentTotal << "in" << msec << "ms"
+							  << qPrintable(QString::number(m_sentTotal*1000./msec, 'f', 1)+QStringLiteral("/s"));
+	}
+
+	m_busy = false;
+
+	// Continue with the next batch if this one was full and nothing failed,
+	// or if a trigger arrived while the batch was running
+
+	if (m_batchFull && m_failed.isEmpty() && ret.state() == RESOLVED) {
+		QMetaObject::invokeMethod(this, &NotificationSenderPrivate::process, Qt::QueuedConnection);
+	} else {
+		m_elapsed.invalidate();
+
+		if (m_triggered)
+			QMetaObject::invokeMethod(this, &NotificationSenderPrivate::process, Qt::QueuedConnection);
+	}
+}
+
+
+
+/**
+ * @brief NotificationSenderPrivate::message
+ * @param item
+ * @return
+ */
+
+SimpleMail::MimeMessage NotificationSenderPrivate::message(const Item &item) const
+{
+	static const QLocale locale;
+
+	const QString description = item.description.isEmpty() ?
+									tr("Kihívás #%1").arg(item.campaign) :
+									item.description;
+
+	auto html = std::make_shared<SimpleMail::MimeHtml>();
+
+	QString content = QString::fromUtf8(m_content);
+
+	content
+			.replace(QStringLiteral("${server:name}"), m_serverName)
+			.replace(QStringLiteral("${server:url}"), m_serverUrl)
+			.replace(QStringLiteral("${user:familyName}"), item.familyName)
+			.replace(QStringLiteral("${user:givenName}"), item.givenName)
+			.replace(QStringLiteral("${campaign:name}"), item.description)
+			;
+
+	if (item.endTime.isValid()) {
+		content.replace(QStringLiteral("${campaign:endTime}"),
+						locale.toString(item.endTime.toLocalTime(), QStringLiteral("yyyy. MMMM d. ddd hh:mm")));
+	} else {
+		content.replace(QStringLiteral("${campaign:endTime}"), tr("egyelőre nincs megadva"));
+	}
+
+	SimpleMail::MimeMessage message;
+	message.setSender(SimpleMail::EmailAddress(m_smtp.user, "Call of Suli"));
+	message.addTo(SimpleMail::EmailAddress(item.email, item.familyName+" "+item.givenName));
+
+	switch (item.type) {
+		case CallOfSuli::NotificationStarted:
+			message.setSubject(tr("Új kihívás: ").append(description));
+			content.replace(QStringLiteral("${message:preheader}"),
+							tr("A Call of Suli | %1 szerveren új kihívás indult el: %2.")
+							.arg(m_serverName, description))
+					.replace(QStringLiteral("${message:main}"),
+							 tr("Értesítünk, hogy a <i>Call of Suli | %1</i> szerveren új kihívás indult el: <b>%2</b>")
+							 .arg(m_serverName, description));
+			break;
+
+		case CallOfSuli::NotificationHour24:
+			message.setSubject(tr("1 nap van hátra: ").append(description));
+			content.replace(QStringLiteral("${message:preheader}"),
+							tr("A(z) %1 kihívás már csak kevesebb, mint egy napig teljesíthető.")
+							.arg(description))
+					.replace(QStringLiteral("${message:main}"),
+							 tr("Értesítünk, hogy a <i>Call of Suli | %1</i> szerveren a(z) <b>%2</b> kihívás teljesítésére kevesebb, mint egy nap van hátra.")
+							 .arg(m_serverName, description));
+			break;
+
+		case CallOfSuli::NotificationHour48:
+			message.setSubject(tr("2 nap van hátra: ").append(description));
+			content.replace(QStringLiteral("${message:preheader}"),
+							tr("A(z) %1 kihívás már csak kevesebb, mint két napig teljesíthető.")
+							.arg(description))
+					.replace(QStringLiteral("${message:main}"),
+							 tr("Értesítünk, hogy a <i>Call of Suli | %1</i> szerveren a(z) <b>%2</b> kihívás teljesítésére kevesebb, mint 2 nap áll rendelkezésre.")
+							 .arg(m_serverName, description));
+			break;
+
+		case CallOfSuli::NotificationWeek1:
+			message.setSubject(tr("Még 1 hét van hátra: ").append(description));
+			content.replace(QStringLiteral("${message:preheader}"),
+							tr("A(z) %1 kihívás még egy hétig teljesíthető.")
+							.arg(description))
+					.replace(QStringLiteral("${message:main}"),
+							 tr("Értesítünk, hogy a <i>Call of Suli | %1</i> szerveren a(z) <b>%2</b> kihívást még 1 hétig lehet teljesíteni.")
+							 .arg(m_serverName, description));
+			break;
+
+		default:
+			message.setSubject(tr("Értesítés: ").append(description));
+			break;
+	}
+
+	html->setHtml(content);
+
+	message.setContent(html);
+
+	return message;
+}
+
+
+
+/**
+ * @brief NotificationSenderPrivate::writeSink
+ * @param item
+ * @param message
+ * @return
+ */
+
+bool NotificationSenderPrivate::writeSink(const Item &item, const SimpleMail::MimeMessage &message) const
+{
+	QDir dir(m_sinkDir);
+
+	if (!dir.exists() && !dir.mkpath(QStringLiteral("."))) {
+		LOG_CERROR("service") << "Can't create SMTP sink directory:" << qPrintable(m_sinkDir);
+		return false;
+	}
+
+	QFile f(dir.absoluteFilePath(QStringLiteral("notification-%1.eml").arg(item.id)));
+
+	if (!f.open(QIODevice::WriteOnly)) {
+		LOG_CERROR("service") << "Can't write file:" << qPrintable(f.fileName());
+		return false;
+	}
+
+	const bool r = message.write(&f);
+
+	f.close();
+
+	LOG_CTRACE("service") << "Notification written:" << qPrintable(item.email) << qPrintable(f.fileName());
+
+	return r;
+}
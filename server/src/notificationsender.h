@@ -0,0 +1,148 @@
+/*
+ * ---- Call of Suli ----
+ *
+ * notificationsender.h
+ *
+ * Created on: 2026. 10. 19.
+ *     Author: Valaczka János Pál <valaczka.janos@piarista.hu>
+ *
+ * NotificationSender
+ *
+ *  This file is part of Call of Suli.
+ *
+ *  Call of Suli is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef NOTIFICATIONSENDER_H
+#define NOTIFICATIONSENDER_H
+
+#include <QObject>
+#include <QThread>
+#include <QBasicTimer>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include "SimpleMail"
+
+class ServerService;
+class DatabaseMain;
+class NotificationSenderPrivate;
+
+
+/**
+ * @brief The NotificationSender class
+ *
+ * Delivers the rows of the notificationQueue table from a dedicated thread.
+ * The DB thread only enqueues, the sender reuses a single SMTP connection and
+ * reschedules failed deliveries with exponential backoff.
+ * If a sink directory is set, messages are written there as .eml files instead of being sent.
+ */
+
+class NotificationSender
+{
+public:
+	NotificationSender(ServerService *service);
+	virtual ~NotificationSender();
+
+	void trigger(const QString &serverName);
+
+private:
+	NotificationSenderPrivate *d = nullptr;
+	QThread m_dThread;
+
+	friend class NotificationSenderPrivate;
+};
+
+
+
+
+/**
+ * @brief The NotificationSenderPrivate class
+ */
+
+class NotificationSenderPrivate : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit NotificationSenderPrivate(ServerService *service);
+	virtual ~NotificationSenderPrivate();
+
+	void process();
+
+protected:
+	void timerEvent(QTimerEvent *event) override;
+
+private:
+
+	/**
+	 * @brief The Item class
+	 */
+
+	struct Item {
+		int id = 0;
+		QString email;
+		QString familyName;
+		QString givenName;
+		int type = 0;
+		int campaign = 0;
+		QString description;
+		QDateTime endTime;
+		int attempts = 0;
+	};
+
+	void start();
+	void createSmtpServer();
+	std::optional<QVector<Item>> fetch() const;
+	void finish();
+	SimpleMail::MimeMessage message(const Item &item) const;
+	bool writeSink(const Item &item, const SimpleMail::MimeMessage &message) const;
+	void itemFinished(const Item &item, const bool &success);
+	void batchTimeout();
+
+	/**
+	 * @brief The SmtpConfig class
+	 */
+
+	struct SmtpConfig {
+		QString host;
+		int port = 0;
+		bool ssl = true;
+		QString user;
+		QString password;
+	};
+
+	DatabaseMain *const m_dbMain;
+	QString m_serverName;
+	QString m_serverUrl;
+	SmtpConfig m_smtp;
+	QString m_sinkDir;
+	QByteArray m_content;
+
+	std::unique_ptr<SimpleMail::Server> m_smtpServer;
+	QBasicTimer m_timer;
+	QBasicTimer m_batchTimer;
+	QElapsedTimer m_elapsed;
+
+	QVector<int> m_sent;
+	QVector<Item> m_failed;
+	QHash<int, Item> m_inFlight;
+	int m_sentTotal = 0;
+	bool m_batchFull = false;
+	bool m_busy = false;
+	bool m_triggered = false;
+
+	friend class NotificationSender;
+};
+
+#endif // NOTIFICATIONSENDER_H
@@ -35,6 +35,7 @@
 #include <QSqlError>
 #include <QObject>
 #include <QSqlQuery>
+#include "jsonstreamwriter.h"
 
 
 
@@ -186,6 +187,7 @@ public:
 	bool exec();
 	std::optional<QJsonArray> execToJsonArray();
 	std::optional<QJsonObject> execToJsonObject();
+	bool execToJsonStream(JsonStreamWriter *writer, const std::function<void(const QSqlQuery &)> &onRow = nullptr);
 	bool execCheckExists();
 	std::optional<QVariant> execInsert();
 	std::optional<int> execInsertAsInt();
@@ -389,6 +391,23 @@ inline std::optional<QJsonObject> QueryBuilder::execToJsonObject()
 
 
 
+inline bool QueryBuilder::execToJsonStream(JsonStreamWriter *writer, const std::function<void (const QSqlQuery &)> &onRow)
+{
+	Q_ASSERT(writer);
+
+	m_sqlQuery.setForwardOnly(true);
+
+	if (!exec())
+		return false;
+
+	writer->records(m_sqlQuery, onRow);
+
+	return true;
+}
+
+
+
+
 inline bool QueryBuilder::execCheckExists()
 {
 	if (!exec()) return false;
@@ -1488,6 +1488,7 @@ void RpgEnginePrivate::dataReceivedPlay(RpgEnginePlayer *player, const QByteArra
 		if (m.value(QStringLiteral("full")).toBool(false)) {
 			player->setIsFullyPrepared(true);
 			player->udpPeer()->setIsReconnecting(false);
+			player->resetUpstreamSequence();
 			return;
 		}
 	}
@@ -1496,7 +1497,20 @@ void RpgEnginePrivate::dataReceivedPlay(RpgEnginePlayer *player, const QByteArra
 	if (player->udpPeer()->isReconnecting())
 		return;
 
-	q->m_snapshots.registerSnapshot(player, m, diff);
+	if (const QCborValue &upstream = m.value(QStringLiteral("u")); upstream.isArray()) {
+		const quint32 epoch = m.value(QStringLiteral("ue")).toInteger(0);
+
+		for (const QCborValue &v : upstream.toArray()) {
+			const QCborArray item = v.toArray();
+
+			if (item.size() < 2 || !player->acceptUpstreamSequence(epoch, item.at(0).toInteger()))
+				continue;
+
+			q->m_snapshots.registerSnapshot(player, item.at(1).toMap(), diff);
+		}
+	} else {
+		q->m_snapshots.registerSnapshot(player, m, diff);
+	}
 
 	renderTimerMeausure(Received, timer2.elapsed());
 }
@@ -3009,3 +3023,63 @@ void RpgEnginePlayer::setIsLost(bool newIsLost)
 {
 	m_isLost = newIsLost;
 }
+
+
+
+/**
+ * @brief RpgEnginePlayer::acceptUpstreamSequence
+ * @param sequence
+ * @return
+ *
+ * A kliens snapshotjai redundánsan (több csomagban is) érkeznek, mindegyiket csak egyszer dolgozzuk fel.
+ * Ha a kliens újrakezdte a számozást (új epoch), mi is újrakezdjük, a régi epoch késve érkező csomagjait eldobjuk.
+ */
+
+bool RpgEnginePlayer::acceptUpstreamSequence(const quint32 &epoch, const quint32 &sequence)
+{
+	if (epoch != m_upstreamEpoch) {
+		if (epoch < m_upstreamEpoch)
+			return false;
+
+		m_upstreamEpoch = epoch;
+		m_upstreamSequence = 0;
+		m_upstreamMask = 0;
+	}
+
+	if (sequence > m_upstreamSequence) {
+		const quint32 shift = sequence - m_upstreamSequence;
+
+		if (shift >= 64)
+			m_upstreamMask = 0;
+		else
+			m_upstreamMask = (m_upstreamMask << shift) | (m_upstreamSequence > 0 ? (quint64(1) << (shift-1)) : 0);
+
+		m_upstreamSequence = sequence;
+		return true;
+	}
+
+	const quint32 diff = m_upstreamSequence - sequence;
+
+	if (diff == 0 || diff > 64)
+		return false;
+
+	const quint64 bit = quint64(1) << (diff-1);
+
+	if (m_upstreamMask & bit)
+		return false;
+
+	m_upstreamMask |= bit;
+
+	return true;
+}
+
+
+/**
+ * @brief RpgEnginePlayer::resetUpstreamSequence
+ */
+
+void RpgEnginePlayer::resetUpstreamSequence()
+{
+	m_upstreamSequence = 0;
+	m_upstreamMask = 0;
+}
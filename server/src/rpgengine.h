@@ -98,6 +98,9 @@ public:
 	bool isLost() const;
 	void setIsLost(bool newIsLost);
 
+	bool acceptUpstreamSequence(const quint32 &epoch, const quint32 &sequence);
+	void resetUpstreamSequence();
+
 private:
 	UdpServerPeer *m_udpPeer = nullptr;
 	bool m_isHost = false;
@@ -113,6 +116,10 @@ private:
 
 	quint32 m_peerID = 0;
 
+	quint32 m_upstreamEpoch = 0;				// a kliens sorszámozásának korszaka (újrakezdéskor nő)
+	quint32 m_upstreamSequence = 0;				// utolsó fogadott snapshot sorszáma
+	quint64 m_upstreamMask = 0;					// az előtte lévő 64 sorszám közül melyek érkeztek már meg
+
 	QJsonObject m_final;
 
 	friend class RpgEngine;
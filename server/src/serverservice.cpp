@@ -67,6 +67,7 @@ ServerService::ServerService(int &argc, char **argv)
 	, m_application(new QCoreApplication(argc, argv))
 	, m_settings(new ServerSettings)
 	, m_networkManager(new QNetworkAccessManager(this))
+	, m_credentialCache(new CredentialCache)
 	//, m_engineHandler(new EngineHandler(this))
 {
 	Q_ASSERT(!m_instance);
@@ -95,6 +96,7 @@ ServerService::ServerService(int &argc, char **argv)
 
 	connect(m_application.get(), &QCoreApplication::aboutToQuit, this, [this](){
 		m_mainTimer.stop();
+		m_notificationSender.reset();
 		m_engineHandler.reset();
 		m_webServer.reset();
 		m_networkManager.reset();
@@ -546,18 +548,10 @@ void ServerService::processSignal(int sig)
 
 void ServerService::loadSmtpServer()
 {
-	if (m_settings->smtpHost().isEmpty() || m_settings->smtpUser().isEmpty())
+	if (m_settings->smtpSink().isEmpty() && (m_settings->smtpHost().isEmpty() || m_settings->smtpUser().isEmpty()))
 		return;
 
-	m_smtpServer.reset(new SimpleMail::Server);
-
-	m_smtpServer->setHost(m_settings->smtpHost());
-	m_smtpServer->setPort(m_settings->smtpPort());
-	m_smtpServer->setConnectionType(m_settings->smtpSsl() ? SimpleMail::Server::SslConnection : SimpleMail::Server::TcpConnection);
-	m_smtpServer->setUsername(m_settings->smtpUser());
-	m_smtpServer->setPassword(m_settings->smtpPassword());
-
-	LOG_CDEBUG("service") << "SMTP client started";
+	m_notificationSender.reset(new NotificationSender(this));
 }
 
 
@@ -838,8 +832,6 @@ std::optional<int> ServerService::preStart()
 		cuteLogger->registerAppender(appender);
 	}
 
-	loadSmtpServer();
-
 	return std::nullopt;
 }
 
@@ -1110,6 +1102,7 @@ int ServerService::versionMajor()
 void ServerConfig::set(const char *key, const QJsonValue &value)
 {
 	m_data.insert(key, value);
+	updateCachedValues();
 	if (m_db) m_db->saveConfig(m_data);
 	if (m_service) emit m_service->configChanged();
 }
@@ -1125,12 +1118,24 @@ void ServerConfig::set(const QJsonObject &object)
 {
 	for (auto it=object.constBegin(); it != object.constEnd(); ++it)
 		m_data.insert(it.key(), it.value());
+	updateCachedValues();
 	if (m_db) m_db->saveConfig(m_data);
 	if (m_service) emit m_service->configChanged();
 }
 
 
 
+/**
+ * @brief ServerConfig::updateCachedValues
+ */
+
+void ServerConfig::updateCachedValues()
+{
+	m_tokenFirstIat = get("tokenFirstIat").toInteger(0);
+}
+
+
+
 /**
  * @brief ServerConfig::loadFromDb
  * @param db
@@ -1166,6 +1171,7 @@ void ServerConfig::loadFromDb(DatabaseMain *db)
 		else
 			m_data = Utils::byteArrayToJsonObject(s.toUtf8()).value_or(QJsonObject());
 
+		updateCachedValues();
 
 		if (m_service) emit m_service->configChanged();
 
@@ -1240,6 +1246,9 @@ bool ServerService::start()
 		return false;
 	}
 
+	if (!m_notificationSender)
+		loadSmtpServer();
+
 	LOG_CINFO("service") << "Server service started";
 
 	if (!m_webServer->start()) {
@@ -38,6 +38,8 @@
 #include "webserver.h"
 #include "oauth2authenticator.h"
 #include "enginehandler.h"
+#include "credentialcache.h"
+#include "notificationsender.h"
 #include "rpgconfig.h"
 
 #ifdef WITH_FTXUI
@@ -75,6 +77,10 @@ public:
 	{ set("oauth2RegistrationForced", on); }
 
 
+	qint64 tokenFirstIat() const
+	{ return m_tokenFirstIat; }
+
+
 	bool nameUpdateEnabled() const
 	{ return get("nameUpdateEnabled").toBool(false); }
 
@@ -83,8 +89,10 @@ public:
 
 private:
 	void loadFromDb(DatabaseMain *db);
+	void updateCachedValues();
 	QPointer<DatabaseMain> m_db = nullptr;
 	QJsonObject m_data;
+	qint64 m_tokenFirstIat = 0;
 	ServerService *m_service = nullptr;
 	friend class ServerService;
 };
@@ -126,7 +134,8 @@ public:
 	QLambdaThreadWorker *databaseMainWorker() const;
 	std::weak_ptr<WebServer> webServer() const;
 	EngineHandler *engineHandler() const { return m_engineHandler.get(); }
-	SimpleMail::Server *smtpServer() const { return m_smtpServer.get(); }
+	NotificationSender *notificationSender() const { return m_notificationSender.get(); }
+	CredentialCache *credentialCache() const { return m_credentialCache.get(); }
 
 	ServerConfig &config();
 
@@ -217,7 +226,8 @@ private:
 	std::shared_ptr<WebServer> m_webServer;
 	std::unique_ptr<UdpServer> m_udpServer;
 	std::unique_ptr<EngineHandler> m_engineHandler;
-	std::unique_ptr<SimpleMail::Server> m_smtpServer;
+	std::unique_ptr<NotificationSender> m_notificationSender;
+	std::unique_ptr<CredentialCache> m_credentialCache;
 
 	QString m_loadedWasmResource;
 	QString m_importDb;
@@ -75,6 +75,9 @@ void ServerSettings::printConfig() const
 	if (!m_smtpUser.isEmpty() && !m_smtpHost.isEmpty())
 		LOG_CINFO("service") << "Smtp email:" << qPrintable(m_smtpUser);
 
+	if (!m_smtpSink.isEmpty())
+		LOG_CINFO("service") << "Smtp sink:" << qPrintable(m_smtpSink);
+
 	LOG_CINFO("service") << "-----------------------------------------------------";
 }
 
@@ -147,6 +150,9 @@ void ServerSettings::loadFromFile(const QString &filename)
 	if (s.contains(QStringLiteral("smtp/ssl")))
 		setSmtpSsl(s.value(QStringLiteral("smtp/ssl")).toBool());
 
+	if (s.contains(QStringLiteral("smtp/sink")))
+		setSmtpSink(s.value(QStringLiteral("smtp/sink")).toString());
+
 
 	if (s.contains(QStringLiteral("udp/engines")))
 		setUdpMaxEngines(s.value(QStringLiteral("udp/engines")).toInt());
@@ -205,6 +211,7 @@ void ServerSettings::saveToFile(const bool &forced, const QString &filename) con
 	s.setValue(QStringLiteral("smtp/user"), m_smtpUser);
 	s.setValue(QStringLiteral("smtp/password"), m_smtpPassword);
 	s.setValue(QStringLiteral("smtp/ssl"), m_smtpSsl);
+	s.setValue(QStringLiteral("smtp/sink"), m_smtpSink);
 
 	s.setValue(QStringLiteral("udp/engines"), m_udpMaxEngines);
 	s.setValue(QStringLiteral("udp/seats"), m_udpMaxSeats);
@@ -401,6 +408,16 @@ void ServerSettings::setSmtpSsl(bool newSmtpSsl)
 	m_smtpSsl = newSmtpSsl;
 }
 
+QString ServerSettings::smtpSink() const
+{
+	return m_smtpSink;
+}
+
+void ServerSettings::setSmtpSink(const QString &newSmtpSink)
+{
+	m_smtpSink = newSmtpSink;
+}
+
 bool ServerSettings::verifyPeer() const
 {
 	return m_verifyPeer;
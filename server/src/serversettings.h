@@ -106,6 +106,9 @@ public:
 	bool smtpSsl() const;
 	void setSmtpSsl(bool newSmtpSsl);
 
+	QString smtpSink() const;
+	void setSmtpSink(const QString &newSmtpSink);
+
 	bool verifyPeer() const;
 	void setVerifyPeer(bool newVerifyPeer);
 
@@ -137,6 +140,7 @@ private:
 	QString m_smtpUser;
 	QString m_smtpPassword;
 	bool m_smtpSsl = true;
+	QString m_smtpSink;
 
 	bool m_verifyPeer = false;
 
@@ -1493,32 +1493,33 @@ QHttpServerResponse TeacherAPI::groupResult(const Credential &credential, const
 
 	LAMBDA_SQL_ASSERT(q.exec());
 
-	QJsonArray list;
+	JsonStreamWriter writer;
+	writer.beginObject().key(QLatin1StringView("list")).beginArray();
 
 	while (q.sqlQuery().next()) {
 		const int &id = q.value("id").toInt();
 
-		const auto &resultList = QueryBuilder::q(db)
-								 .addQuery("SELECT studentGroupInfo.username AS username, score.xp AS resultXP, "
-										   "campaignResult.gradeid AS resultGrade, maxPts, progress "
-										   "FROM studentGroupInfo "
-										   "LEFT JOIN campaignResult ON (campaignResult.campaignid=").addValue(id)
-								 .addQuery(" AND campaignResult.username=studentGroupInfo.username) "
-										   "LEFT JOIN score ON (campaignResult.scoreid=score.id) "
-										   "WHERE active=true AND studentGroupInfo.id=(SELECT groupid FROM campaign WHERE campaign.id=").addValue(id)
-								 .addQuery(")")
-								 .execToJsonArray();
-
-		LAMBDA_SQL_ASSERT(resultList);
-
-		QJsonObject obj;
-		obj[QStringLiteral("campaignid")] = id;
-		obj[QStringLiteral("resultList")] = *resultList;
-
-		list.append(obj);
+		writer.beginObject()
+				.field(QLatin1StringView("campaignid"), id)
+				.key(QLatin1StringView("resultList"));
+
+		LAMBDA_SQL_ASSERT(QueryBuilder::q(db)
+						  .addQuery("SELECT studentGroupInfo.username AS username, score.xp AS resultXP, "
+									"campaignResult.gradeid AS resultGrade, maxPts, progress "
+									"FROM studentGroupInfo "
+									"LEFT JOIN campaignResult ON (campaignResult.campaignid=").addValue(id)
+						  .addQuery(" AND campaignResult.username=studentGroupInfo.username) "
+									"LEFT JOIN score ON (campaignResult.scoreid=score.id) "
+									"WHERE active=true AND studentGroupInfo.id=(SELECT groupid FROM campaign WHERE campaign.id=").addValue(id)
+						  .addQuery(")")
+						  .execToJsonStream(&writer));
+
+		writer.endObject();
 	}
 
-	response = responseResult("list", list);
+	writer.endArray().endObject();
+
+	response = responseJson(writer.take());
 
 	LAMBDA_THREAD_END;
 }
@@ -1547,17 +1548,14 @@ QHttpServerResponse TeacherAPI::groupUserResult(const Credential &credential, co
 	CHECK_GROUP(credential.username(), id);
 
 	int offset = json.value(QStringLiteral("offset")).toInt(0);
-	int limit = json.value(QStringLiteral("limit")).toInt(DEFAULT_LIMIT);
+	const int limit = pageLimit(json);
 
-	const auto &list = TeacherAPI::_groupUserGameResult(this, id, username, limit, offset);
+	const auto &list = TeacherAPI::_groupUserGameResult(this, id, username, limit, offset,
+														GameCursor::fromJson(json.value(QStringLiteral("cursor"))));
 
 	LAMBDA_SQL_ASSERT(list);
 
-	response = QHttpServerResponse(QJsonObject{
-									   { QStringLiteral("list"), *list },
-									   { QStringLiteral("limit"), limit },
-									   { QStringLiteral("offset"), offset },
-								   });
+	response = QHttpServerResponse(_gameResultResponse(*list, limit, offset));
 
 	LAMBDA_THREAD_END;
 }
@@ -1585,17 +1583,25 @@ QHttpServerResponse TeacherAPI::groupGameLog(const Credential &credential, const
 	CHECK_GROUP(credential.username(), id);
 
 	int offset = json.value(QStringLiteral("offset")).toInt(0);
-	int limit = json.value(QStringLiteral("limit")).toInt(DEFAULT_LIMIT);
+	const int limit = pageLimit(json);
 
-	const auto &list = TeacherAPI::_groupGameResult(this, id, limit, offset);
+	std::optional<GameCursor> next;
 
-	LAMBDA_SQL_ASSERT(list);
+	JsonStreamWriter writer;
+	writer.beginObject().key(QLatin1StringView("list"));
+
+	LAMBDA_SQL_ASSERT(TeacherAPI::_groupGameResult(this, &writer, id, limit, offset,
+												   GameCursor::fromJson(json.value(QStringLiteral("cursor"))), &next));
+
+	writer.field(QLatin1StringView("limit"), limit)
+			.field(QLatin1StringView("offset"), offset);
 
-	response = QHttpServerResponse(QJsonObject{
-									   { QStringLiteral("list"), *list },
-									   { QStringLiteral("limit"), limit },
-									   { QStringLiteral("offset"), offset },
-								   });
+	if (next)
+		writer.field(QLatin1StringView("cursor"), QJsonValue(next->toJson()));
+
+	writer.endObject();
+
+	response = responseJson(writer.take());
 
 	LAMBDA_THREAD_END;
 }
@@ -2499,8 +2505,6 @@ QHttpServerResponse TeacherAPI::campaignResult(const Credential &credential, con
 
 	const bool &finished = obj->value(QStringLiteral("finished")).toVariant().toBool();
 
-	QJsonArray resultList;
-
 	QueryBuilder q(db);
 	q.addQuery("WITH studentList(username, campaignid) AS (SELECT username, campaignid FROM campaignStudent) "
 			   "SELECT studentGroupInfo.username AS username, score.xp AS resultXP, campaignResult.gradeid AS resultGrade, "
@@ -2518,6 +2522,8 @@ QHttpServerResponse TeacherAPI::campaignResult(const Credential &credential, con
 
 	LAMBDA_SQL_ASSERT(q.exec());
 
+	JsonStreamWriter writer;
+	writer.beginObject().key(QLatin1StringView("list")).beginArray();
 
 	while (q.sqlQuery().next()) {
 		const QString &username = q.value("username").toString();
@@ -2543,23 +2549,20 @@ QHttpServerResponse TeacherAPI::campaignResult(const Credential &credential, con
 			progress = result->progress;
 		}
 
-		QJsonObject obj;
-
-		obj[QStringLiteral("username")] = username;
-		obj[QStringLiteral("included")] = q.value("included").toString();
-		obj[QStringLiteral("resultXP")] = xp > 0 ? xp : QJsonValue::Null;
-		obj[QStringLiteral("resultGrade")] = grade > 0 ? grade : QJsonValue::Null;
-		obj[QStringLiteral("maxPts")] = maxPts > 0 ? maxPts : QJsonValue::Null;
-		if (maxPts > 0)
-			obj[QStringLiteral("progress")] = progress;
-		else
-			obj[QStringLiteral("progress")] = QJsonValue::Null;
-		obj[QStringLiteral("taskList")] = result->tasks;
-
-		resultList.append(obj);
+		writer.beginObject()
+				.field(QLatin1StringView("username"), username)
+				.field(QLatin1StringView("included"), q.value("included").toString())
+				.field(QLatin1StringView("resultXP"), xp > 0 ? QJsonValue(xp) : QJsonValue::Null)
+				.field(QLatin1StringView("resultGrade"), grade > 0 ? QJsonValue(grade) : QJsonValue::Null)
+				.field(QLatin1StringView("maxPts"), maxPts > 0 ? QJsonValue(maxPts) : QJsonValue::Null)
+				.field(QLatin1StringView("progress"), maxPts > 0 ? QJsonValue(progress) : QJsonValue::Null)
+				.field(QLatin1StringView("taskList"), QJsonValue(result->tasks))
+				.endObject();
 	}
 
-	response = responseResult("list", resultList);
+	writer.endArray().endObject();
+
+	response = responseJson(writer.take());
 
 	LAMBDA_THREAD_END;
 }
@@ -2587,17 +2590,14 @@ QHttpServerResponse TeacherAPI::campaignResultUser(const Credential &credential,
 	CHECK_CAMPAIGN(credential.username(), id);
 
 	int offset = json.value(QStringLiteral("offset")).toInt(0);
-	int limit = json.value(QStringLiteral("limit")).toInt(DEFAULT_LIMIT);
+	const int limit = pageLimit(json);
 
-	const auto &list = TeacherAPI::_campaignUserGameResult(this, id, username, limit, offset);
+	const auto &list = TeacherAPI::_campaignUserGameResult(this, id, username, limit, offset,
+														   GameCursor::fromJson(json.value(QStringLiteral("cursor"))));
 
 	LAMBDA_SQL_ASSERT(list);
 
-	response = QHttpServerResponse(QJsonObject{
-									   { QStringLiteral("list"), *list },
-									   { QStringLiteral("limit"), limit },
-									   { QStringLiteral("offset"), offset },
-								   });
+	response = QHttpServerResponse(_gameResultResponse(*list, limit, offset));
 
 	LAMBDA_THREAD_END;
 }
@@ -5919,11 +5919,12 @@ bool TeacherAPI::_updatePassResultByCampaign(const DatabaseMain *dbMain, const i
  * @param username
  * @param limit
  * @param offset
+ * @param cursor
  * @return
  */
 
 std::optional<QJsonArray> TeacherAPI::_campaignUserGameResult(const AbstractAPI *api, const int &campaign, const QString &username,
-															  const int &limit, const int &offset)
+															  const int &limit, const int &offset, const std::optional<GameCursor> &cursor)
 {
 	Q_ASSERT(api);
 
@@ -5931,15 +5932,16 @@ std::optional<QJsonArray> TeacherAPI::_campaignUserGameResult(const AbstractAPI
 
 	QMutexLocker _locker(api->databaseMain()->mutex());
 
-	return QueryBuilder::q(db)
-			.addQuery("WITH t AS (SELECT game.id as id, CAST(strftime('%s', game.timestamp) AS INTEGER) AS timestamp, mapid, missionid, "
-					  "level, mode, deathmatch, success, duration, xp "
-					  "FROM game LEFT JOIN score ON (score.id=game.scoreid) "
-					  "WHERE campaignid=").addValue(campaign)
-			.addQuery(" AND game.username=").addValue(username)
-			.addQuery(") SELECT * FROM t WHERE id NOT IN (SELECT id FROM t ORDER BY timestamp DESC, id DESC LIMIT ").addValue(offset)
-			.addQuery(") ORDER BY timestamp DESC, id DESC LIMIT ").addValue(limit)
-			.execToJsonArray();
+	QueryBuilder q(db);
+	q.addQuery("SELECT game.id as id, CAST(strftime('%s', game.timestamp) AS INTEGER) AS timestamp, mapid, missionid, "
+			   "level, mode, deathmatch, success, duration, xp "
+			   "FROM game LEFT JOIN score ON (score.id=game.scoreid) "
+			   "WHERE campaignid=").addValue(campaign)
+			.addQuery(" AND game.username=").addValue(username);
+
+	_gameResultPage(&q, limit, offset, cursor);
+
+	return q.execToJsonArray();
 }
 
 
@@ -5952,11 +5954,12 @@ std::optional<QJsonArray> TeacherAPI::_campaignUserGameResult(const AbstractAPI
  * @param username
  * @param limit
  * @param offset
+ * @param cursor
  * @return
  */
 
 std::optional<QJsonArray> TeacherAPI::_groupUserGameResult(const AbstractAPI *api, const int &group, const QString &username,
-														   const int &limit, const int &offset)
+														   const int &limit, const int &offset, const std::optional<GameCursor> &cursor)
 {
 	Q_ASSERT(api);
 
@@ -5964,15 +5967,17 @@ std::optional<QJsonArray> TeacherAPI::_groupUserGameResult(const AbstractAPI *ap
 
 	QMutexLocker _locker(api->databaseMain()->mutex());
 
-	return QueryBuilder::q(db)
-			.addQuery("WITH t AS (SELECT game.id as id, CAST(strftime('%s', game.timestamp) AS INTEGER) AS timestamp, mapid, missionid, "
-					  "level, mode, deathmatch, success, duration, xp "
-					  "FROM game LEFT JOIN score ON (score.id=game.scoreid) "
-					  "WHERE (campaignid IS NULL OR campaignid IN (SELECT id FROM campaign WHERE groupid=").addValue(group)
-			.addQuery(")) AND game.username=").addValue(username)
-			.addQuery(") SELECT * FROM t WHERE id NOT IN (SELECT id FROM t ORDER BY timestamp DESC, id DESC LIMIT ").addValue(offset)
-			.addQuery(") ORDER BY timestamp DESC, id DESC LIMIT ").addValue(limit)
-			.execToJsonArray();
+	QueryBuilder q(db);
+	q.addQuery("SELECT game.id as id, CAST(strftime('%s', game.timestamp) AS INTEGER) AS timestamp, mapid, missionid, "
+			   "level, mode, deathmatch, success, duration, xp "
+			   "FROM game LEFT JOIN score ON (score.id=game.scoreid) "
+			   "WHERE game.username=").addValue(username)
+			.addQuery(" AND (campaignid IS NULL OR campaignid IN (SELECT id FROM campaign WHERE groupid=").addValue(group)
+			.addQuery("))");
+
+	_gameResultPage(&q, limit, offset, cursor);
+
+	return q.execToJsonArray();
 }
 
 
@@ -5982,29 +5987,146 @@ std::optional<QJsonArray> TeacherAPI::_groupUserGameResult(const AbstractAPI *ap
 /**
  * @brief TeacherAPI::_groupGameResult
  * @param api
+ * @param writer
  * @param group
  * @param limit
  * @param offset
+ * @param cursor
+ * @param nextCursor
  * @return
  */
 
-std::optional<QJsonArray> TeacherAPI::_groupGameResult(const AbstractAPI *api, const int &group, const int &limit, const int &offset)
+bool TeacherAPI::_groupGameResult(const AbstractAPI *api, JsonStreamWriter *writer, const int &group, const int &limit, const int &offset,
+								  const std::optional<GameCursor> &cursor, std::optional<GameCursor> *nextCursor)
 {
 	Q_ASSERT(api);
+	Q_ASSERT(writer);
 
 	QSqlDatabase db = QSqlDatabase::database(api->databaseMain()->dbName());
 
 	QMutexLocker _locker(api->databaseMain()->mutex());
 
-	return QueryBuilder::q(db)
-			.addQuery("WITH t AS (SELECT game.id as id, CAST(strftime('%s', game.timestamp) AS INTEGER) AS timestamp, mapid, missionid, "
-					  "level, mode, deathmatch, success, duration, xp, game.username as username, familyName, givenName "
-					  "FROM game LEFT JOIN score ON (score.id=game.scoreid) "
-					  "LEFT JOIN user ON (user.username=game.username) "
-					  "WHERE (campaignid IS NULL OR campaignid IN (SELECT id FROM campaign WHERE groupid=").addValue(group)
-			.addQuery("))) SELECT * FROM t WHERE id NOT IN (SELECT id FROM t ORDER BY timestamp DESC, id DESC LIMIT ").addValue(offset)
-			.addQuery(") ORDER BY timestamp DESC, id DESC LIMIT ").addValue(limit)
-			.execToJsonArray();
+	QueryBuilder q(db);
+	q.addQuery("SELECT game.id as id, CAST(strftime('%s', game.timestamp) AS INTEGER) AS timestamp, mapid, missionid, "
+			   "level, mode, deathmatch, success, duration, xp, game.username as username, familyName, givenName "
+			   "FROM game LEFT JOIN score ON (score.id=game.scoreid) "
+			   "LEFT JOIN user ON (user.username=game.username) "
+			   "WHERE (campaignid IS NULL OR campaignid IN (SELECT id FROM campaign WHERE groupid=").addValue(group)
+			.addQuery("))");
+
+	_gameResultPage(&q, limit, offset, cursor);
+
+	if (!nextCursor)
+		return q.execToJsonStream(writer);
+
+	int count = 0;
+
+	const bool r = q.execToJsonStream(writer, [nextCursor, &count](const QSqlQuery &query){
+		*nextCursor = GameCursor{
+			.timestamp = query.value(QStringLiteral("timestamp")).toLongLong(),
+			.id = query.value(QStringLiteral("id")).toInt()
+		};
+		++count;
+	});
+
+	if (limit <= 0 || count < limit)
+		nextCursor->reset();
+
+	return r;
+}
+
+
+
+
+/**
+ * @brief TeacherAPI::_gameResultPage
+ * @param q
+ * @param limit
+ * @param offset
+ * @param cursor
+ */
+
+void TeacherAPI::_gameResultPage(QueryBuilder *q, const int &limit, const int &offset, const std::optional<GameCursor> &cursor)
+{
+	Q_ASSERT(q);
+
+	// Keyset pagination if cursor is provided (offset is ignored)
+
+	if (cursor) {
+		q->addQuery(" AND (game.timestamp, game.id) < (datetime(").addValue(cursor->timestamp)
+				.addQuery(", 'unixepoch'), ").addValue(cursor->id)
+				.addQuery(")");
+	}
+
+	q->addQuery(" ORDER BY game.timestamp DESC, game.id DESC LIMIT ").addValue(limit);
+
+	if (!cursor && offset > 0)
+		q->addQuery(" OFFSET ").addValue(offset);
+}
+
+
+
+/**
+ * @brief TeacherAPI::_gameResultResponse
+ * @param list
+ * @param limit
+ * @param offset
+ * @return
+ */
+
+QJsonObject TeacherAPI::_gameResultResponse(const QJsonArray &list, const int &limit, const int &offset)
+{
+	QJsonObject r{
+		{ QStringLiteral("list"), list },
+		{ QStringLiteral("limit"), limit },
+		{ QStringLiteral("offset"), offset },
+	};
+
+	if (limit > 0 && list.size() >= limit) {
+		if (const auto &c = GameCursor::fromJson(list.last()))
+			r.insert(QStringLiteral("cursor"), c->toJson());
+	}
+
+	return r;
+}
+
+
+
+
+/**
+ * @brief TeacherAPI::GameCursor::fromJson
+ * @param value
+ * @return
+ */
+
+std::optional<TeacherAPI::GameCursor> TeacherAPI::GameCursor::fromJson(const QJsonValue &value)
+{
+	if (!value.isObject())
+		return std::nullopt;
+
+	const QJsonObject &obj = value.toObject();
+
+	if (!obj.contains(QStringLiteral("timestamp")) || !obj.contains(QStringLiteral("id")))
+		return std::nullopt;
+
+	return GameCursor{
+		.timestamp = obj.value(QStringLiteral("timestamp")).toInteger(),
+		.id = obj.value(QStringLiteral("id")).toInt()
+	};
+}
+
+
+/**
+ * @brief TeacherAPI::GameCursor::toJson
+ * @return
+ */
+
+QJsonObject TeacherAPI::GameCursor::toJson() const
+{
+	return QJsonObject{
+		{ QStringLiteral("timestamp"), timestamp },
+		{ QStringLiteral("id"), id },
+	};
 }
 
 
@@ -31,6 +31,9 @@
 #include "gamemap.h"
 #include "qjsonarray.h"
 #include "rpgconfig.h"
+#include "jsonstreamwriter.h"
+
+class QueryBuilder;
 
 class TeacherAPI : public AbstractAPI
 {
@@ -54,6 +57,20 @@ public:
 	};
 
 
+	/**
+	 * @brief The GameCursor class
+	 *
+	 * Keyset pagination cursor of the game log (ordered by timestamp DESC, id DESC)
+	 */
+
+	struct GameCursor {
+		qint64 timestamp = 0;
+		int id = 0;
+
+		static std::optional<GameCursor> fromJson(const QJsonValue &value);
+		QJsonObject toJson() const;
+	};
+
 
 
 	QHttpServerResponse groups(const Credential &credential);
@@ -163,11 +180,18 @@ public:
 												  const QString &username);
 
 	static std::optional<QJsonArray> _campaignUserGameResult(const AbstractAPI *api, const int &campaign, const QString &username,
-											  const int &limit = DEFAULT_LIMIT, const int &offset = 0);
+															 const int &limit = DEFAULT_LIMIT, const int &offset = 0,
+															 const std::optional<GameCursor> &cursor = std::nullopt);
 	static std::optional<QJsonArray> _groupUserGameResult(const AbstractAPI *api, const int &group, const QString &username,
-										   const int &limit = DEFAULT_LIMIT, const int &offset = 0);
-	static std::optional<QJsonArray> _groupGameResult(const AbstractAPI *api, const int &group,
-									   const int &limit = DEFAULT_LIMIT, const int &offset = 0);
+														  const int &limit = DEFAULT_LIMIT, const int &offset = 0,
+														  const std::optional<GameCursor> &cursor = std::nullopt);
+	static bool _groupGameResult(const AbstractAPI *api, JsonStreamWriter *writer, const int &group,
+								 const int &limit = DEFAULT_LIMIT, const int &offset = 0,
+								 const std::optional<GameCursor> &cursor = std::nullopt,
+								 std::optional<GameCursor> *nextCursor = nullptr);
+
+	static void _gameResultPage(QueryBuilder *q, const int &limit, const int &offset, const std::optional<GameCursor> &cursor);
+	static QJsonObject _gameResultResponse(const QJsonArray &list, const int &limit, const int &offset);
 
         static bool _evaluateCampaign(const AbstractAPI *api, const int &campaign, const QString &username);
 	static std::optional<float> _evaluateCriterionXP(const AbstractAPI *api, const int &campaign, const QJsonObject &criterion, const QString &username);
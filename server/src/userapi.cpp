@@ -499,17 +499,14 @@ QHttpServerResponse UserAPI::campaignResult(const Credential &credential, const
 	LAMBDA_THREAD_BEGIN(credential, id, json);
 
 	int offset = json.value(QStringLiteral("offset")).toInt(0);
-	int limit = json.value(QStringLiteral("limit")).toInt(DEFAULT_LIMIT);
+	const int limit = pageLimit(json);
 
-	const auto &list = TeacherAPI::_campaignUserGameResult(this, id, credential.username(), limit, offset);
+	const auto &list = TeacherAPI::_campaignUserGameResult(this, id, credential.username(), limit, offset,
+														   TeacherAPI::GameCursor::fromJson(json.value(QStringLiteral("cursor"))));
 
 	LAMBDA_SQL_ASSERT(list);
 
-	response = QHttpServerResponse(QJsonObject{
-									   { QStringLiteral("list"), *list },
-									   { QStringLiteral("limit"), limit },
-									   { QStringLiteral("offset"), offset },
-								   });
+	response = QHttpServerResponse(TeacherAPI::_gameResultResponse(*list, limit, offset));
 	LAMBDA_THREAD_END;
 }
 
@@ -224,7 +224,7 @@ void WebSocketStream::onJsonReceived(const QJsonObject &data)
 	if (m_state == StateHelloSent) {
 		const QByteArray &token = data.value(QStringLiteral("token")).toString().toUtf8();
 
-		if (!Credential::verify(token, m_service->settings()->jwtSecret(), m_service->config().get("tokenFirstIat").toInteger(0))) {
+		if (!Credential::verify(token, m_service->settings()->jwtSecret(), m_service->config().tokenFirstIat())) {
 			LOG_CDEBUG("service") << "Token verification failed" << this;
 			sendJson("error", QStringLiteral("unauthorized"));
 			m_state = StateError;